@@ -21,6 +21,14 @@ struct location_t action_result(struct location_t location, enum action_t action
     }
 }
 
+// Define reverse_action (action.h).
+enum action_t reverse_action(enum action_t action)
+{
+    // The cardinal directions are ordered clockwise, so the opposite direction
+    // is always two places away.
+    return (enum action_t) ((action + 2) % 4);
+}
+
 // Define action_taken (action.h).
 int action_taken(enum action_t* action, struct location_t a, struct location_t b)
 {
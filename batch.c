@@ -0,0 +1,480 @@
+#include "batch.h"
+
+#include "location.h"
+#include "node.h"
+#include "node_list.h"
+#include "maze.h"
+#include "compact_search.h"
+#include "io.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <dirent.h>
+
+
+struct batch_run_t;
+
+/**
+ * \internal
+ *
+ * Represents one of the threads solving a batch.
+ *
+ * This struct contains the range of jobs still to be taken from the share of
+ * the thread, which is protected by the mutex as other threads may steal from
+ * it, along with the node list and compact search buffers reused for each job.
+ */
+struct batch_worker_t
+{
+    struct batch_run_t* run;
+    pthread_t thread;
+    size_t id;
+    pthread_mutex_t mutex;
+    size_t next;
+    size_t end;
+    struct node_list_t list;
+    struct compact_search_t search;
+    bool prepared;
+};
+
+/**
+ * \internal
+ *
+ * Represents the state shared by every thread solving a batch.
+ */
+struct batch_run_t
+{
+    struct batch_t* batch;
+    struct batch_worker_t* workers;
+    size_t threads;
+    enum path_encoding_t encoding;
+    FILE* status;
+};
+
+/**
+ * \internal
+ *
+ * Takes the next job for a thread solving a batch.
+ *
+ * This helper function takes the job at the front of the share of the given
+ * thread. If the share is empty, it moves the back half of the share of the
+ * next thread with any jobs left into the share of the given thread, and tries
+ * again.
+ *
+ * \param [in,out] worker
+ *     A pointer to the batch worker taking a job.
+ * \param [out]    job
+ *     A pointer to the variable which will contain the index of the job.
+ *
+ * \returns
+ *     Whether a job was taken, which is only false once every share is empty.
+ */
+static bool take_job(struct batch_worker_t* worker, size_t* job);
+
+/**
+ * \internal
+ *
+ * Solves the jobs of a batch on a single thread, until none are left.
+ *
+ * \param [in,out] arg
+ *     A pointer to the batch worker variable for the thread.
+ *
+ * \returns
+ *     NULL.
+ */
+static void* run_batch_worker(void* arg);
+
+/**
+ * \internal
+ *
+ * Solves a single job of a batch with the buffers of a given thread, and
+ * reports the result.
+ *
+ * \param [in,out] worker
+ *     A pointer to the batch worker solving the job.
+ * \param [in,out] job
+ *     A pointer to the job.
+ */
+static void solve_job(struct batch_worker_t* worker, struct batch_job_t* job);
+
+/**
+ * \internal
+ *
+ * Compares two jobs by the name of their input file for sorting with qsort().
+ *
+ * \param [in] a
+ *     A pointer to the first of the jobs.
+ * \param [in] b
+ *     A pointer to the second of the jobs.
+ *
+ * \returns
+ *     A negative number, zero or a positive number if the first name is less
+ *     than, equal to or greater than the second.
+ */
+static int compare_jobs(const void* a, const void* b);
+
+// Define make_batch (batch.h).
+void make_batch(struct batch_t* batch)
+{
+    // Assert that the pointer to the batch variable is valid.
+    assert(batch != NULL);
+
+    // Initialize batch properties.
+    batch->jobs = NULL;
+    batch->length = 0;
+    batch->capacity = 0;
+}
+
+// Define free_batch (batch.h).
+void free_batch(struct batch_t* batch)
+{
+    // Assert that the pointer to the batch variable is valid.
+    assert(batch != NULL);
+
+    for (size_t index = 0; index < batch->length; index++)
+    {
+        free(batch->jobs[index].output);
+        free(batch->jobs[index].input);
+    }
+
+    free(batch->jobs);
+    make_batch(batch);
+}
+
+// Define add_batch_job (batch.h).
+int add_batch_job(struct batch_t* batch, const char* input, const char* output)
+{
+    // Assert that the pointer to the batch variable is valid.
+    assert(batch != NULL);
+    // Assert that the file names are valid.
+    assert(input != NULL && output != NULL);
+
+    // If the capacity has been reached, resize the array of jobs.
+    if (batch->length >= batch->capacity)
+    {
+        // Resize according to 2 * previous capacity.
+        size_t new_capacity = (batch->capacity == 0) ? 16 : batch->capacity * 2;
+        void* ptr = realloc((void*) batch->jobs, new_capacity * sizeof(struct batch_job_t));
+
+        // Indicate failure if resize failed.
+        if (ptr == NULL) return -1;
+
+        batch->jobs = (struct batch_job_t*) ptr;
+        batch->capacity = new_capacity;
+    }
+
+    struct batch_job_t job = { strdup(input), strdup(output), -1 };
+
+    if (job.input == NULL || job.output == NULL)
+    {
+        free(job.output);
+        free(job.input);
+        return -1;
+    }
+
+    batch->jobs[batch->length++] = job;
+
+    return 0;
+}
+
+// Define read_batch_list (batch.h).
+int read_batch_list(struct batch_t* batch, const char* filename)
+{
+    // Assert that the pointer to the batch variable is valid.
+    assert(batch != NULL);
+    // Assert that the file name is valid.
+    assert(filename != NULL);
+
+    FILE* fp = fopen(filename, "r");
+    if (fp == NULL) return -1;
+
+    char* line = NULL;
+    size_t line_capacity = 0;
+    int result = 0;
+
+    while (result == 0 && getline(&line, &line_capacity, fp) != -1)
+    {
+        // Split the line into names, skipping any empty lines.
+        char* saved = NULL;
+        char* input = strtok_r(line, " \t\r\n", &saved);
+        if (input == NULL) continue;
+
+        char* output = strtok_r(NULL, " \t\r\n", &saved);
+
+        if (output == NULL || strtok_r(NULL, " \t\r\n", &saved) != NULL)
+        {
+            result = -1;
+            break;
+        }
+
+        result = add_batch_job(batch, input, output);
+    }
+
+    if (ferror(fp)) result = -1;
+
+    free(line);
+    fclose(fp);
+
+    return result;
+}
+
+// Define read_batch_directory (batch.h).
+int read_batch_directory(struct batch_t* batch, const char* input_directory, const char* output_directory)
+{
+    // Assert that the pointer to the batch variable is valid.
+    assert(batch != NULL);
+    // Assert that the directory names are valid.
+    assert(input_directory != NULL && output_directory != NULL);
+
+    DIR* directory = opendir(input_directory);
+    if (directory == NULL) return -1;
+
+    size_t first = batch->length;
+    int result = 0;
+
+    for (struct dirent* entry = readdir(directory); entry != NULL && result == 0; entry = readdir(directory))
+    {
+        if (entry->d_name[0] == '.') continue;
+
+        // Join the name of the entry to the name of each directory.
+        size_t name_length = strlen(entry->d_name);
+        size_t input_length = strlen(input_directory) + name_length + 2;
+        size_t output_length = strlen(output_directory) + name_length + 2;
+
+        char* input = (char*) malloc(input_length * sizeof(char));
+        char* output = (char*) malloc(output_length * sizeof(char));
+
+        if (input == NULL || output == NULL)
+        {
+            result = -1;
+        }
+        else
+        {
+            snprintf(input, input_length, "%s/%s", input_directory, entry->d_name);
+            snprintf(output, output_length, "%s/%s", output_directory, entry->d_name);
+
+            result = add_batch_job(batch, input, output);
+        }
+
+        free(output);
+        free(input);
+    }
+
+    closedir(directory);
+
+    // Sort the new jobs, as the entries of a directory are in no given order.
+    if (result == 0)
+    {
+        qsort(batch->jobs + first, batch->length - first, sizeof(struct batch_job_t), compare_jobs);
+    }
+
+    return result;
+}
+
+// Define solve_batch (batch.h).
+int solve_batch(struct batch_t* batch, size_t threads, enum path_encoding_t encoding, FILE* status)
+{
+    // Assert that the pointer to the batch variable is valid.
+    assert(batch != NULL);
+    // Assert that there is at least one thread.
+    assert(threads > 0);
+
+    struct batch_run_t run = { batch, NULL, threads, encoding, status };
+
+    run.workers = (struct batch_worker_t*) calloc(threads, sizeof(struct batch_worker_t));
+    if (run.workers == NULL) return -1;
+
+    // Divide the jobs evenly between the threads.
+    size_t initialized = 0;
+    for (; initialized < threads; initialized++)
+    {
+        struct batch_worker_t* worker = &run.workers[initialized];
+
+        worker->run = &run;
+        worker->id = initialized;
+        worker->next = batch->length * initialized / threads;
+        worker->end = batch->length * (initialized + 1) / threads;
+
+        if (pthread_mutex_init(&worker->mutex, NULL) != 0) break;
+    }
+
+    int result = -1;
+
+    if (initialized == threads)
+    {
+        // Start every thread but the first, which is the calling thread. The
+        // share of any thread which could not be started is stolen by the
+        // others.
+        size_t started = 1;
+        for (; started < threads; started++)
+        {
+            struct batch_worker_t* worker = &run.workers[started];
+            if (pthread_create(&worker->thread, NULL, run_batch_worker, (void*) worker) != 0) break;
+        }
+
+        run_batch_worker((void*) &run.workers[0]);
+
+        for (size_t id = 1; id < started; id++)
+        {
+            pthread_join(run.workers[id].thread, NULL);
+        }
+
+        // Indicate failure if any job failed.
+        result = 0;
+        for (size_t index = 0; index < batch->length; index++)
+        {
+            if (batch->jobs[index].result != 0) result = -1;
+        }
+    }
+
+    for (size_t id = 0; id < initialized; id++)
+    {
+        pthread_mutex_destroy(&run.workers[id].mutex);
+    }
+
+    free(run.workers);
+
+    return result;
+}
+
+// Define take_job (batch.c).
+static bool take_job(struct batch_worker_t* worker, size_t* job)
+{
+    struct batch_run_t* run = worker->run;
+
+    for (;;)
+    {
+        // Take the job at the front of this thread's share.
+        pthread_mutex_lock(&worker->mutex);
+        bool taken = worker->next < worker->end;
+        if (taken) *job = worker->next++;
+        pthread_mutex_unlock(&worker->mutex);
+
+        if (taken) return true;
+
+        // Steal the back half of the share of the next thread with any jobs
+        // left, taking at least one job.
+        bool stolen = false;
+        for (size_t offset = 1; offset < run->threads && !stolen; offset++)
+        {
+            struct batch_worker_t* victim = &run->workers[(worker->id + offset) % run->threads];
+
+            pthread_mutex_lock(&victim->mutex);
+
+            size_t next = victim->next;
+            size_t end = victim->end;
+            size_t middle = next + (end - next) / 2;
+            stolen = next < end;
+
+            if (stolen) victim->end = middle;
+
+            pthread_mutex_unlock(&victim->mutex);
+
+            if (stolen)
+            {
+                pthread_mutex_lock(&worker->mutex);
+                worker->next = middle;
+                worker->end = end;
+                pthread_mutex_unlock(&worker->mutex);
+            }
+        }
+
+        // Jobs are never added, so once every share is empty there is nothing
+        // left to do.
+        if (!stolen) return false;
+    }
+}
+
+// Define run_batch_worker (batch.c).
+static void* run_batch_worker(void* arg)
+{
+    struct batch_worker_t* worker = (struct batch_worker_t*) arg;
+    struct batch_run_t* run = worker->run;
+
+    // Create the buffers reused for every job, which grow as bigger mazes are
+    // solved.
+    worker->prepared = make_list(&worker->list, 0) == 0;
+    if (worker->prepared && make_compact_search(&worker->search, (struct maze_size_t) { 1, 1 }) != 0)
+    {
+        resize_list(&worker->list, 0);
+        worker->prepared = false;
+    }
+
+    size_t job = 0;
+    while (take_job(worker, &job))
+    {
+        solve_job(worker, &run->batch->jobs[job]);
+    }
+
+    if (worker->prepared)
+    {
+        free_compact_search(&worker->search);
+        resize_list(&worker->list, 0);
+    }
+
+    return NULL;
+}
+
+// Define solve_job (batch.c).
+static void solve_job(struct batch_worker_t* worker, struct batch_job_t* job)
+{
+    struct batch_run_t* run = worker->run;
+
+    if (!worker->prepared)
+    {
+        if (run->status != NULL) fprintf(run->status, "%s: failed to allocate buffers\n", job->input);
+        return;
+    }
+
+    struct maze_t maze;
+    if (read_maze_file(&maze, job->input) != 0)
+    {
+        if (run->status != NULL) fprintf(run->status, "%s: failed to read maze\n", job->input);
+        return;
+    }
+
+    // Reuse the nodes of the list from the previous job.
+    worker->list.length = 0;
+
+    struct path_t path;
+    int result = solve_maze_compact_buffered(&worker->list, maze, &worker->search);
+    if (result == 0) result = make_path(&path, get_node(&worker->list, worker->list.length - 1));
+
+    free_maze(&maze);
+
+    if (result != 0)
+    {
+        if (run->status != NULL) fprintf(run->status, "%s: failed to solve maze\n", job->input);
+        return;
+    }
+
+    FILE* fp = fopen(job->output, "wb");
+    if (fp != NULL)
+    {
+        result = write_encoded_path(path, run->encoding, fp);
+        if (fclose(fp) != 0) result = -1;
+    }
+    else
+    {
+        result = -1;
+    }
+
+    if (run->status != NULL)
+    {
+        if (result == 0) fprintf(run->status, "%s: solved in %zu actions\n", job->input, path.length);
+        else fprintf(run->status, "%s: failed to write %s\n", job->input, job->output);
+    }
+
+    free_path(&path);
+
+    job->result = result;
+}
+
+// Define compare_jobs (batch.c).
+static int compare_jobs(const void* a, const void* b)
+{
+    return strcmp(((const struct batch_job_t*) a)->input, ((const struct batch_job_t*) b)->input);
+}
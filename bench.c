@@ -0,0 +1,667 @@
+#include "location.h"
+#include "action.h"
+#include "action_set.h"
+#include "maze_size.h"
+#include "node.h"
+#include "node_list.h"
+#include "maze.h"
+#include "path.h"
+#include "incremental_search.h"
+#include "search_engine.h"
+#include "generator.h"
+#include "io.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef BENCH
+
+/**
+ * \internal
+ *
+ * Represents a path encoding measured by the benchmark.
+ */
+struct encoding_t
+{
+    const char* name;
+    enum path_encoding_t encoding;
+};
+
+/**
+ * \internal
+ *
+ * Represents a maze generation algorithm that can be selected to generate the
+ * mazes measured by the benchmark.
+ */
+struct generator_name_t
+{
+    const char* name;
+    enum generator_t algorithm;
+};
+
+/**
+ * \internal
+ *
+ * The maze generation algorithms that can be selected with the -g option, the
+ * first of which is used by default.
+ */
+static const struct generator_name_t generators[] =
+{
+    { "eller",       GENERATOR_ELLER },
+    { "backtracker", GENERATOR_BACKTRACKER },
+    { "kruskal",     GENERATOR_KRUSKAL },
+    { "wilson",      GENERATOR_WILSON }
+};
+
+/**
+ * \internal
+ *
+ * The greatest number of threads used by the parallel searches, set by the -t
+ * option. The searches which share their work between threads are measured
+ * with each power of two threads below it and with it.
+ */
+static size_t thread_count = 1;
+
+/**
+ * \internal
+ *
+ * The time in seconds that solving a maze with a search may take before its
+ * remaining runs are abandoned and it is skipped for every bigger maze, set by
+ * the -l option.
+ */
+static double time_limit = 10;
+
+/**
+ * \internal
+ *
+ * The path encodings measured by the benchmark, in the order they are run.
+ */
+static const struct encoding_t encodings[] =
+{
+    { "text",   PATH_TEXT },
+    { "rle",    PATH_RUN_LENGTH },
+    { "binary", PATH_BINARY }
+};
+
+/**
+ * \internal
+ *
+ * Gets the current time of the monotonic clock in seconds.
+ *
+ * \returns
+ *     The current time in seconds.
+ */
+static double now(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (double) time.tv_sec + (double) time.tv_nsec / 1e9;
+}
+
+/**
+ * \internal
+ *
+ * Compares two times for sorting in ascending order with qsort().
+ *
+ * \param [in] a
+ *     A pointer to the first of the times.
+ * \param [in] b
+ *     A pointer to the second of the times.
+ *
+ * \returns
+ *     A negative number, zero or a positive number if the first time is less
+ *     than, equal to or greater than the second.
+ */
+static int compare_times(const void* a, const void* b)
+{
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * \internal
+ *
+ * Writes a line of the CSV report summarising the times of repeated runs.
+ *
+ * This function sorts the given times, then reports their median and their
+ * 99th percentile, taken as the nearest rank, in milliseconds.
+ *
+ * \param [in]     csv
+ *     The file handle to write the line to.
+ * \param [in]     size
+ *     The size of the maze measured.
+ * \param [in]     phase
+ *     The name of the phase measured.
+ * \param [in]     variant
+ *     The name of the variant of the phase measured.
+ * \param [in]     threads
+ *     The number of threads the phase was measured with.
+ * \param [in,out] times
+ *     The array of times in seconds, which is sorted.
+ * \param [in]     runs
+ *     The number of times.
+ */
+static void report_times(FILE* csv, struct maze_size_t size, const char* phase, const char* variant, size_t threads, double* times, size_t runs)
+{
+    qsort(times, runs, sizeof(double), compare_times);
+
+    size_t rank = (runs * 99 + 99) / 100;
+
+    fprintf(csv, "%zu,%zu,%s,%s,%zu,%zu,%.3f,%.3f\n", size.rows, size.columns, phase, variant, threads, runs,
+            times[runs / 2] * 1e3, times[rank - 1] * 1e3);
+    fflush(csv);
+}
+
+/**
+ * \internal
+ *
+ * Measures reading a maze file repeatedly.
+ *
+ * \param [in]  filename
+ *     The name of the maze file.
+ * \param [out] times
+ *     The array which will contain the time of each run in seconds.
+ * \param [in]  runs
+ *     The number of times to read the maze.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int time_parse(const char* filename, double* times, size_t runs)
+{
+    for (size_t run = 0; run < runs; run++)
+    {
+        struct maze_t maze;
+
+        double begin = now();
+        int read_result = read_maze_file(&maze, filename);
+        times[run] = now() - begin;
+
+        if (read_result != 0) return -1;
+        free_maze(&maze);
+    }
+
+    return 0;
+}
+
+/**
+ * \internal
+ *
+ * Measures solving a maze repeatedly with a given search algorithm.
+ *
+ * Once the runs have taken longer than the time limit in total, the remaining
+ * runs are abandoned, and leave no time behind.
+ *
+ * \param [in]     engine
+ *     A pointer to the search algorithm.
+ * \param [in]     maze
+ *     The maze to solve.
+ * \param [in,out] list
+ *     A pointer to the node list reused by every run, which holds the nodes of
+ *     the last run once finished.
+ * \param [out]    times
+ *     The array which will contain the time of each run in seconds.
+ * \param [in]     runs
+ *     The number of times to solve the maze.
+ * \param [out]    measured
+ *     A pointer to the variable which will contain the number of runs measured.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int time_solve(const struct search_engine_t* engine, struct maze_t maze, struct node_list_t* list, double* times, size_t runs, size_t* measured)
+{
+    double total = 0;
+    *measured = 0;
+
+    while (*measured < runs && total <= time_limit)
+    {
+        list->length = 0;
+
+        double begin = now();
+        engine->solve(list, maze);
+        times[*measured] = now() - begin;
+
+        total += times[(*measured)++];
+
+        // The final node is the start of the maze if a path was found.
+        if (list->length == 0 || !location_equal(get_node(list, list->length - 1)->location, maze.start)) return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * \internal
+ *
+ * Measures solving a maze again with an incremental search after opening a
+ * single wall, repeatedly.
+ *
+ * This function solves the maze once, then for each run opens the next closed
+ * wall found from a location chosen by the run, and measures updating the
+ * search and solving the maze again. The wall is closed again and the maze
+ * solved once more without being measured, so that every run repairs a single
+ * change from the original maze, which is left unchanged once finished. Runs
+ * which find no closed wall, or which would begin once the measured runs have
+ * taken longer than the time limit in total, are not measured, and leave no
+ * time behind.
+ *
+ * \param [in,out] maze
+ *     The maze to solve, whose action sets are changed while measuring.
+ * \param [in,out] list
+ *     A pointer to the node list reused by every run, which holds the nodes of
+ *     the last run once finished.
+ * \param [out]    times
+ *     The array which will contain the time of each measured run in seconds.
+ * \param [in]     runs
+ *     The number of times to repair the search.
+ * \param [out]    measured
+ *     A pointer to the variable which will contain the number of runs measured.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int time_repair(struct maze_t maze, struct node_list_t* list, double* times, size_t runs, size_t* measured)
+{
+    struct incremental_search_t search;
+    if (make_incremental_search(&search, maze) != 0) return -1;
+
+    list->length = 0;
+    int result = solve_incremental_search(list, &search, NULL);
+
+    size_t length = maze.size.rows * maze.size.columns;
+    double total = 0;
+    *measured = 0;
+
+    for (size_t run = 0; result == 0 && run < runs && total <= time_limit; run++)
+    {
+        // Find the next closed wall to the east of or below a location spread
+        // across the maze, which opening cannot disconnect the maze.
+        struct location_t changed[2];
+        enum action_t action = EAST;
+        bool found = false;
+
+        for (size_t step = 0; !found && step < length; step++)
+        {
+            size_t index = (run * (length / runs + 1) + step) % length;
+            changed[0] = (struct location_t) { index / maze.size.columns, index % maze.size.columns };
+
+            for (enum action_t candidate = EAST; !found && candidate <= SOUTH; candidate++)
+            {
+                action = candidate;
+                changed[1] = action_result(changed[0], action);
+                found = check_location(maze.size, changed[1]) && !(get_action_set(maze, changed[0]) & (1 << action));
+            }
+        }
+
+        // Leave the run unmeasured if every wall is open.
+        if (!found) continue;
+
+        enum action_set_t first = get_action_set(maze, changed[0]);
+        enum action_set_t second = get_action_set(maze, changed[1]);
+
+        double begin = now();
+
+        set_action_set(maze, (enum action_set_t) ((unsigned int) first | (1u << action)), changed[0]);
+        set_action_set(maze, (enum action_set_t) ((unsigned int) second | (1u << reverse_action(action))), changed[1]);
+
+        list->length = 0;
+        result = update_incremental_search(&search, changed, 2);
+        if (result == 0) result = solve_incremental_search(list, &search, NULL);
+
+        times[*measured] = now() - begin;
+        total += times[(*measured)++];
+
+        // Close the wall again.
+        set_action_set(maze, first, changed[0]);
+        set_action_set(maze, second, changed[1]);
+
+        list->length = 0;
+        if (result == 0) result = update_incremental_search(&search, changed, 2);
+        if (result == 0) result = solve_incremental_search(list, &search, NULL);
+    }
+
+    free_incremental_search(&search);
+
+    return result;
+}
+
+/**
+ * \internal
+ *
+ * Measures writing a path repeatedly in a given encoding.
+ *
+ * \param [in]  start
+ *     A pointer to the node at the start of the path.
+ * \param [in]  encoding
+ *     The encoding to write the path in.
+ * \param [in]  fp
+ *     The file handle to write the path to, which is rewound before each run.
+ * \param [out] times
+ *     The array which will contain the time of each run in seconds.
+ * \param [in]  runs
+ *     The number of times to write the path.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int time_write(struct node_t* start, enum path_encoding_t encoding, FILE* fp, double* times, size_t runs)
+{
+    for (size_t run = 0; run < runs; run++)
+    {
+        rewind(fp);
+
+        double begin = now();
+
+        struct path_t path;
+        int write_result = make_path(&path, start);
+        if (write_result == 0)
+        {
+            write_result = write_encoded_path(path, encoding, fp);
+            if (fflush(fp) != 0) write_result = -1;
+            free_path(&path);
+        }
+
+        times[run] = now() - begin;
+
+        if (write_result != 0) return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * \internal
+ *
+ * Measures every phase of solving a maze, writing a line of the CSV report for
+ * each.
+ *
+ * This function writes the maze in the text and binary formats to temporary
+ * files and measures reading each, then measures solving it with each search
+ * algorithm, then measures writing the path found in each encoding, then
+ * measures repairing an incremental search after a single wall is opened. The
+ * searches which share their work between threads are measured with each power
+ * of two threads below the thread count and with the thread count. A search
+ * which exceeds the time limit is marked as too slow, and is skipped by every
+ * later call.
+ *
+ * \param [in]     maze
+ *     The maze to measure.
+ * \param [in]     runs
+ *     The number of times to repeat each measurement.
+ * \param [in]     csv
+ *     The file handle to write the report to.
+ * \param [in,out] too_slow
+ *     The array indicating for each search algorithm whether it is too slow to
+ *     be measured.
+ *
+ * \returns
+ *     -1 if any measurement failed, 0 on success.
+ */
+static int bench_maze(struct maze_t maze, size_t runs, FILE* csv, bool* too_slow)
+{
+    double* times = (double*) malloc(runs * sizeof(double));
+    if (times == NULL) return -1;
+
+    int result = 0;
+
+    // Measure reading the maze in each format from a temporary file.
+    static const char* formats[2] = { "text", "binary" };
+
+    for (size_t format = 0; format < 2; format++)
+    {
+        const char* directory = getenv("TMPDIR");
+        char filename[4096];
+        snprintf(filename, sizeof(filename), "%s/maze-bench-XXXXXX", (directory != NULL) ? directory : "/tmp");
+
+        int fd = mkstemp(filename);
+        FILE* fp = (fd >= 0) ? fdopen(fd, "wb") : NULL;
+
+        int write_result = -1;
+        if (fp != NULL)
+        {
+            write_result = (format == 0) ? write_maze_text(maze, fp) : write_maze_binary(maze, fp);
+            if (fclose(fp) != 0) write_result = -1;
+        }
+        else if (fd >= 0)
+        {
+            close(fd);
+        }
+
+        if (write_result == 0 && time_parse(filename, times, runs) == 0)
+        {
+            report_times(csv, maze.size, "parse", formats[format], 1, times, runs);
+        }
+        else
+        {
+            fprintf(stderr, "Failed to measure reading the maze in the %s format\n", formats[format]);
+            result = -1;
+        }
+
+        if (fd >= 0) remove(filename);
+    }
+
+    // Measure solving the maze with each search algorithm.
+    struct node_list_t list;
+    if (make_list(&list, 0) != 0)
+    {
+        free(times);
+        return -1;
+    }
+
+    bool solved = false;
+
+    for (size_t index = 0; index < search_engine_count; index++)
+    {
+        const struct search_engine_t* engine = &search_engines[index];
+        size_t threads = engine->threaded ? 1 : thread_count;
+
+        while (!too_slow[index] && threads <= thread_count)
+        {
+            set_search_threads(threads);
+
+            size_t measured = 0;
+            if (time_solve(engine, maze, &list, times, runs, &measured) == 0)
+            {
+                report_times(csv, maze.size, "solve", engine->name, engine->threaded ? threads : 1, times, measured);
+                solved = true;
+
+                // Skip the search on bigger mazes once it exceeds the limit.
+                if (measured < runs)
+                {
+                    fprintf(stderr, "The %s search exceeded the time limit, skipping bigger mazes\n", engine->name);
+                    too_slow[index] = true;
+                }
+            }
+            else
+            {
+                fprintf(stderr, "Failed to solve the maze with the %s search\n", engine->name);
+                result = -1;
+                break;
+            }
+
+            // Double the threads, ending with the thread count itself.
+            threads = (threads < thread_count && threads * 2 > thread_count) ? thread_count : threads * 2;
+        }
+    }
+
+    set_search_threads(thread_count);
+
+    // Measure writing the path found by the last search in each encoding.
+    FILE* fp = tmpfile();
+
+    for (size_t index = 0; solved && index < sizeof(encodings) / sizeof(encodings[0]); index++)
+    {
+        if (fp != NULL && time_write(get_node(&list, list.length - 1), encodings[index].encoding, fp, times, runs) == 0)
+        {
+            report_times(csv, maze.size, "write", encodings[index].name, 1, times, runs);
+        }
+        else
+        {
+            fprintf(stderr, "Failed to measure writing the path in the %s encoding\n", encodings[index].name);
+            result = -1;
+        }
+    }
+
+    if (fp != NULL) fclose(fp);
+
+    // Measure repairing the incremental search after a wall is opened, which
+    // can be compared with solving the maze with it from scratch.
+    size_t measured = 0;
+    if (time_repair(maze, &list, times, runs, &measured) == 0)
+    {
+        if (measured > 0) report_times(csv, maze.size, "repair", "incremental", 1, times, measured);
+    }
+    else
+    {
+        fprintf(stderr, "Failed to measure repairing the incremental search\n");
+        result = -1;
+    }
+
+    resize_list(&list, 0);
+    free(times);
+
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    size_t runs = 7;
+    size_t min_size = 100;
+    size_t max_size = 10000;
+    struct generator_options_t options = { .algorithm = GENERATOR_ELLER, .seed = 1, .braid = 0 };
+    char* csv_filename = NULL;
+
+    // Use every available processor for the parallel search by default.
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    if (processors > 0) thread_count = (size_t) processors;
+
+    // Read the options preceding the file names.
+    int arg_index = 1;
+    for (; arg_index < argc && argv[arg_index][0] == '-'; arg_index++)
+    {
+        char* arg = argv[arg_index];
+        bool has_value = arg_index + 1 < argc;
+
+        if (strcmp(arg, "-r") == 0 && has_value) runs = strtoul(argv[++arg_index], NULL, 10);
+        else if (strcmp(arg, "-n") == 0 && has_value) min_size = strtoul(argv[++arg_index], NULL, 10);
+        else if (strcmp(arg, "-m") == 0 && has_value) max_size = strtoul(argv[++arg_index], NULL, 10);
+        else if (strcmp(arg, "-t") == 0 && has_value) thread_count = strtoul(argv[++arg_index], NULL, 10);
+        else if (strcmp(arg, "-l") == 0 && has_value) time_limit = strtod(argv[++arg_index], NULL);
+        else if (strcmp(arg, "-x") == 0 && has_value) options.seed = strtoull(argv[++arg_index], NULL, 10);
+        else if (strcmp(arg, "-B") == 0 && has_value) options.braid = (unsigned int) strtoul(argv[++arg_index], NULL, 10);
+        else if (strcmp(arg, "-g") == 0 && has_value)
+        {
+            char* name = argv[++arg_index];
+            size_t count = sizeof(generators) / sizeof(generators[0]);
+            size_t index = 0;
+
+            while (index < count && strcmp(name, generators[index].name) != 0) index++;
+
+            if (index == count)
+            {
+                printf("Unknown generator: %s\n", name);
+                return -1;
+            }
+
+            options.algorithm = generators[index].algorithm;
+        }
+        else if (strcmp(arg, "-o") == 0 && has_value) csv_filename = argv[++arg_index];
+        else
+        {
+            printf("Usage: maze [-r runs] [-n min_size] [-m max_size] [-t threads] [-l time_limit] [-g eller|backtracker|kruskal|wilson] [-B braid_percent] [-x seed] [-o csv_file] [maze_file ...]\n");
+            return -1;
+        }
+    }
+
+    if (runs == 0 || min_size == 0 || max_size < min_size || thread_count == 0)
+    {
+        printf("The number of runs and threads and the sizes must not be zero\n");
+        return -1;
+    }
+
+    if (!(time_limit > 0))
+    {
+        printf("The time limit must be positive\n");
+        return -1;
+    }
+
+    set_search_threads(thread_count);
+
+    FILE* csv = (csv_filename != NULL) ? fopen(csv_filename, "w") : stdout;
+
+    if (csv == NULL)
+    {
+        printf("Failed to open %s\n", csv_filename);
+        return -1;
+    }
+
+    // No search is known to be too slow until it has been measured.
+    bool* too_slow = (bool*) calloc(search_engine_count, sizeof(bool));
+
+    if (too_slow == NULL)
+    {
+        if (csv != stdout) fclose(csv);
+        return -1;
+    }
+
+    fprintf(csv, "rows,columns,phase,variant,threads,runs,median_ms,p99_ms\n");
+
+    int result = 0;
+
+    if (arg_index < argc)
+    {
+        // Measure each of the given maze files.
+        for (; arg_index < argc; arg_index++)
+        {
+            struct maze_t maze;
+            if (read_maze_file(&maze, argv[arg_index]) != 0)
+            {
+                fprintf(stderr, "Failed to read %s\n", argv[arg_index]);
+                result = -1;
+                continue;
+            }
+
+            if (bench_maze(maze, runs, csv, too_slow) != 0) result = -1;
+            free_maze(&maze);
+        }
+    }
+    else
+    {
+        // Measure square mazes of sizes stepping by roughly half an order of
+        // magnitude: 100, 300, 1000, 3000, 10000 and so on.
+        for (size_t size = min_size; size <= max_size;)
+        {
+            options.size = (struct maze_size_t) { size, size };
+
+            struct maze_t maze;
+            if (generate_maze(&maze, options) != 0)
+            {
+                fprintf(stderr, "Failed to generate a maze of size %zu\n", size);
+                result = -1;
+                break;
+            }
+
+            if (bench_maze(maze, runs, csv, too_slow) != 0) result = -1;
+            free_maze(&maze);
+
+            size_t next = (size % 3 == 0) ? size / 3 * 10 : size * 3;
+            if (size < max_size && next > max_size) next = max_size;
+            size = (next > size) ? next : max_size + 1;
+        }
+    }
+
+    if (csv != stdout && fclose(csv) != 0) result = -1;
+    free(too_slow);
+
+    return result;
+}
+
+#endif // BENCH
@@ -0,0 +1,420 @@
+#include "bitboard.h"
+
+#include "action.h"
+#include "location.h"
+#include "maze.h"
+#include "node_list.h"
+#include "stats.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+
+/**
+ * \internal
+ *
+ * Represents the state of a bit-parallel breadth-first search.
+ *
+ * This struct contains the bitmaps of visited locations, of the current
+ * frontier and of the frontier being built for the next level, all with the
+ * same layout as the bitplanes of the maze. Only the words of the frontiers
+ * holding any locations are processed, so the position of every such word of
+ * each frontier is also kept in an array, along with the number of words in
+ * it. A word is added to the array of the next frontier when its first
+ * location is reached, so each position appears at most once. The number of
+ * locations in each frontier is counted as they are reached.
+ */
+struct wavefront_t
+{
+    uint64_t* visited;
+    uint64_t* frontier;
+    uint64_t* next;
+    size_t* active;
+    size_t* next_active;
+    size_t active_count;
+    size_t next_count;
+    size_t length;
+    size_t next_length;
+};
+
+/**
+ * \internal
+ *
+ * Finds the position of the lowest set bit in a word.
+ *
+ * \param [in] word
+ *     The word to search.
+ *
+ * \pre
+ *     The word must not be zero.
+ *
+ * \returns
+ *     The position of the lowest set bit, counting from zero.
+ */
+static unsigned int lowest_bit(uint64_t word);
+
+/**
+ * \internal
+ *
+ * Moves the locations of one word of the frontier of a bit-parallel search in
+ * the direction of a given action.
+ *
+ * This helper function masks the given word of the frontier with the same word
+ * of the plane of the given action, then shifts the result by one column if the
+ * action moves along the row, or moves it to the same word of the next row if
+ * the action moves between rows, adding the locations reached to the next
+ * frontier. A location shifted out of one end of the word is carried into the
+ * neighbouring word of the same row, if there is one.
+ *
+ * \param [in,out] wave
+ *     A pointer to the wavefront.
+ * \param [in]     planes
+ *     A pointer to the bitplanes of the maze.
+ * \param [in]     position
+ *     The position of the word of the frontier to move.
+ * \param [in]     action
+ *     The action to take.
+ * \param [out]    actions
+ *     A pointer to the array of actions leading back to the origin of the
+ *     search, indexed by location.
+ */
+static void move_word(struct wavefront_t* wave, struct bitplanes_t* planes, size_t position, enum action_t action, unsigned char* actions);
+
+/**
+ * \internal
+ *
+ * Adds the unvisited locations of a word to the next frontier of a bit-parallel
+ * search.
+ *
+ * This helper function marks each given location which has not already been
+ * visited as visited, adds it to the next frontier, adding the word to the
+ * array of active words of the next frontier if it was empty, counts it, and
+ * records the reverse of the action that reached it.
+ *
+ * \param [in,out] wave
+ *     A pointer to the wavefront.
+ * \param [in]     planes
+ *     A pointer to the bitplanes of the maze.
+ * \param [in]     position
+ *     The position of the word that the locations belong to.
+ * \param [in]     reached
+ *     The locations reached within the word.
+ * \param [in]     action
+ *     The action that reached the locations.
+ * \param [out]    actions
+ *     A pointer to the array of actions leading back to the origin of the
+ *     search, indexed by location.
+ */
+static void reach_word(struct wavefront_t* wave, struct bitplanes_t* planes, size_t position, uint64_t reached, enum action_t action, unsigned char* actions);
+
+/**
+ * \internal
+ *
+ * Expands the whole frontier of a bit-parallel search by one level.
+ *
+ * \param [in,out] wave
+ *     A pointer to the wavefront.
+ * \param [in]     planes
+ *     A pointer to the bitplanes of the maze.
+ * \param [out]    actions
+ *     A pointer to the array of actions leading back to the origin of the
+ *     search, indexed by location.
+ *
+ * \returns
+ *     Whether the new frontier contains any locations.
+ */
+static bool expand_wavefront(struct wavefront_t* wave, struct bitplanes_t* planes, unsigned char* actions);
+
+// Define make_bitplanes (bitboard.h).
+int make_bitplanes(struct bitplanes_t* planes, struct maze_t maze)
+{
+    // Assert that the pointer to the bitplanes variable is valid.
+    assert(planes != NULL);
+
+    size_t rows = maze.size.rows;
+    size_t columns = maze.size.columns;
+    size_t stride = (columns + 63) / 64;
+    size_t plane_length = rows * stride;
+
+    // Allocate the memory required for all four planes at once.
+    uint64_t* ptr = (uint64_t*) calloc(4 * plane_length, sizeof(uint64_t));
+
+    // Indicate failure if allocation failed.
+    if (ptr == NULL) return -1;
+
+    // Initialize bitplanes properties.
+    for (enum action_t action = EAST; action <= NORTH; action++)
+    {
+        planes->planes[action] = ptr + (size_t) action * plane_length;
+    }
+
+    planes->rows = rows;
+    planes->columns = columns;
+    planes->stride = stride;
+
+    // Create a buffer for the unpacked sets of actions of a single row.
+    unsigned char* action_sets = (unsigned char*) malloc(columns * sizeof(unsigned char));
+    if (action_sets == NULL)
+    {
+        free(ptr);
+        return -1;
+    }
+
+    // Set the bit for each action available at each location, a word at a time.
+    for (size_t row = 0; row < rows; row++)
+    {
+        get_row_action_sets(maze, row, action_sets);
+
+        for (size_t word = 0; word < stride; word++)
+        {
+            uint64_t words[4] = { 0, 0, 0, 0 };
+
+            for (size_t bit = 0; bit < 64 && word * 64 + bit < columns; bit++)
+            {
+                unsigned int action_set = action_sets[word * 64 + bit];
+
+                for (enum action_t action = EAST; action <= NORTH; action++)
+                {
+                    words[action] |= (uint64_t) ((action_set >> action) & 1) << bit;
+                }
+            }
+
+            for (enum action_t action = EAST; action <= NORTH; action++)
+            {
+                planes->planes[action][row * stride + word] = words[action];
+            }
+        }
+    }
+
+    free(action_sets);
+
+    return 0;
+}
+
+// Define free_bitplanes (bitboard.h).
+void free_bitplanes(struct bitplanes_t* planes)
+{
+    // Assert that the pointer to the bitplanes variable is valid.
+    assert(planes != NULL);
+
+    // The planes share one allocation, which begins with the first plane.
+    free(planes->planes[EAST]);
+
+    for (enum action_t action = EAST; action <= NORTH; action++)
+    {
+        planes->planes[action] = NULL;
+    }
+}
+
+// Define solve_maze_bitboard (bitboard.h).
+int solve_maze_bitboard(struct node_list_t* list, struct maze_t maze)
+{
+    return solve_maze_bitboard_measured(list, maze, NULL);
+}
+
+// Define solve_maze_bitboard_measured (bitboard.h).
+int solve_maze_bitboard_measured(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats)
+{
+    // Assert that the pointer to the node list variable is valid.
+    assert(list != NULL);
+
+    struct bitplanes_t planes;
+    if (make_bitplanes(&planes, maze) != 0) return -1;
+
+    size_t length = planes.rows * planes.stride;
+
+    // Allocate the state of the search, with every bitmap initially empty.
+    struct wavefront_t wave;
+    wave.visited = (uint64_t*) calloc(length, sizeof(uint64_t));
+    wave.frontier = (uint64_t*) calloc(length, sizeof(uint64_t));
+    wave.next = (uint64_t*) calloc(length, sizeof(uint64_t));
+    wave.active = (size_t*) malloc(length * sizeof(size_t));
+    wave.next_active = (size_t*) malloc(length * sizeof(size_t));
+    wave.active_count = 0;
+    wave.next_count = 0;
+    wave.length = 0;
+    wave.next_length = 0;
+
+    unsigned char* actions = (unsigned char*) malloc(maze.size.rows * maze.size.columns * sizeof(unsigned char));
+
+    int result = -1;
+
+    if (wave.visited != NULL && wave.frontier != NULL && wave.next != NULL
+     && wave.active != NULL && wave.next_active != NULL && actions != NULL)
+    {
+        // Begin the search at the end of the maze, as this implementation works
+        // backwards.
+        size_t end_word = maze.end.row * planes.stride + maze.end.column / 64;
+        wave.visited[end_word] = (uint64_t) 1 << (maze.end.column % 64);
+        wave.frontier[end_word] = wave.visited[end_word];
+        wave.active[wave.active_count++] = end_word;
+        wave.length = 1;
+
+        size_t start_word = maze.start.row * planes.stride + maze.start.column / 64;
+        uint64_t start_bit = (uint64_t) 1 << (maze.start.column % 64);
+
+        // Expand the frontier until the start has been reached, or there is
+        // nothing left to expand, counting the locations of each frontier.
+        size_t expansions = 0;
+        size_t pushes = 1;
+        size_t frontier_peak = 1;
+
+        bool expanding = true;
+        while (expanding && !(wave.visited[start_word] & start_bit))
+        {
+            expansions += wave.length;
+            expanding = expand_wavefront(&wave, &planes, actions);
+
+            pushes += wave.length;
+            if (wave.length > frontier_peak) frontier_peak = wave.length;
+        }
+
+        // Record the work done.
+        if (stats != NULL)
+        {
+            stats->recorded = true;
+            stats->expansions = expansions;
+            stats->pushes = pushes;
+            stats->duplicate_pushes = 0;
+            stats->frontier_peak = frontier_peak;
+        }
+
+        // If the start of the maze was reached, follow the actions to build the
+        // path.
+        if (wave.visited[start_word] & start_bit)
+        {
+            result = append_path(list, maze, actions);
+        }
+    }
+
+    free(actions);
+    free(wave.next_active);
+    free(wave.active);
+    free(wave.next);
+    free(wave.frontier);
+    free(wave.visited);
+    free_bitplanes(&planes);
+
+    return result;
+}
+
+// Define lowest_bit (bitboard.c).
+static unsigned int lowest_bit(uint64_t word)
+{
+#if defined(__GNUC__)
+    return (unsigned int) __builtin_ctzll(word);
+#else
+    unsigned int bit = 0;
+    for (; !(word & 1); word >>= 1) bit++;
+    return bit;
+#endif
+}
+
+// Define move_word (bitboard.c).
+static void move_word(struct wavefront_t* wave, struct bitplanes_t* planes, size_t position, enum action_t action, unsigned char* actions)
+{
+    size_t stride = planes->stride;
+    size_t word = position % stride;
+
+    uint64_t moving = wave->frontier[position] & planes->planes[action][position];
+    if (moving == 0) return;
+
+    switch (action)
+    {
+        case EAST:
+            // Shift towards higher columns, carrying the highest bit into the
+            // next word of the row.
+            if (word + 1 < stride)
+            {
+                reach_word(wave, planes, position, moving << 1, action, actions);
+                reach_word(wave, planes, position + 1, moving >> 63, action, actions);
+            }
+            else
+            {
+                // Discard any location shifted past the final column.
+                uint64_t shifted = moving << 1;
+                if (planes->columns % 64 != 0) shifted &= ((uint64_t) 1 << (planes->columns % 64)) - 1;
+
+                reach_word(wave, planes, position, shifted, action, actions);
+            }
+            break;
+        case WEST:
+            // Shift towards lower columns, carrying the lowest bit into the
+            // previous word of the row.
+            reach_word(wave, planes, position, moving >> 1, action, actions);
+            if (word > 0) reach_word(wave, planes, position - 1, (moving & 1) << 63, action, actions);
+            break;
+        case SOUTH:
+            // Moving between rows keeps the same columns.
+            if (position + stride < planes->rows * stride)
+            {
+                reach_word(wave, planes, position + stride, moving, action, actions);
+            }
+            break;
+        case NORTH:
+            if (position >= stride) reach_word(wave, planes, position - stride, moving, action, actions);
+            break;
+    }
+}
+
+// Define reach_word (bitboard.c).
+static void reach_word(struct wavefront_t* wave, struct bitplanes_t* planes, size_t position, uint64_t reached, enum action_t action, unsigned char* actions)
+{
+    reached &= ~wave->visited[position];
+    if (reached == 0) return;
+
+    // Add the word to the active words of the next frontier the first time it
+    // is reached.
+    if (wave->next[position] == 0) wave->next_active[wave->next_count++] = position;
+
+    wave->visited[position] |= reached;
+    wave->next[position] |= reached;
+
+    // Record the way back for each newly reached location.
+    unsigned char back = (unsigned char) reverse_action(action);
+    size_t base = (position / planes->stride) * planes->columns + (position % planes->stride) * 64;
+
+    for (; reached != 0; reached &= reached - 1)
+    {
+        actions[base + lowest_bit(reached)] = back;
+        wave->next_length++;
+    }
+}
+
+// Define expand_wavefront (bitboard.c).
+static bool expand_wavefront(struct wavefront_t* wave, struct bitplanes_t* planes, unsigned char* actions)
+{
+    // Move every active word of the frontier in every direction.
+    for (size_t index = 0; index < wave->active_count; index++)
+    {
+        for (enum action_t action = EAST; action <= NORTH; action++)
+        {
+            move_word(wave, planes, wave->active[index], action, actions);
+        }
+    }
+
+    // Clear the words of the frontier which were active, so that it is empty
+    // again before it is used to build the frontier after next.
+    for (size_t index = 0; index < wave->active_count; index++)
+    {
+        wave->frontier[wave->active[index]] = 0;
+    }
+
+    // The next frontier becomes the current one.
+    uint64_t* frontier = wave->frontier;
+    wave->frontier = wave->next;
+    wave->next = frontier;
+
+    size_t* active = wave->active;
+    wave->active = wave->next_active;
+    wave->next_active = active;
+
+    wave->active_count = wave->next_count;
+    wave->next_count = 0;
+
+    wave->length = wave->next_length;
+    wave->next_length = 0;
+
+    return wave->active_count > 0;
+}
@@ -0,0 +1,139 @@
+#include "bounded_queue.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+// Define make_bounded_queue (bounded_queue.h).
+int make_bounded_queue(struct bounded_queue_t* queue, size_t capacity)
+{
+    // Assert that the pointer to the bounded queue variable is valid.
+    assert(queue != NULL);
+    // Assert that the capacity is a power of two.
+    assert(capacity >= 2 && (capacity & (capacity - 1)) == 0);
+
+    // Allocate the memory required for the slots.
+    void* ptr = malloc(capacity * sizeof(struct queue_slot_t));
+
+    // Indicate failure if allocation failed.
+    if (ptr == NULL) return -1;
+
+    // Initialize bounded queue properties. Each slot is initially ready to be
+    // written at its own position.
+    queue->slots = (struct queue_slot_t*) ptr;
+    queue->mask = capacity - 1;
+
+    for (size_t position = 0; position < capacity; position++)
+    {
+        atomic_init(&queue->slots[position].sequence, position);
+        queue->slots[position].value = NULL;
+    }
+
+    atomic_init(&queue->tail, 0);
+    atomic_init(&queue->head, 0);
+
+    return 0;
+}
+
+// Define free_bounded_queue (bounded_queue.h).
+void free_bounded_queue(struct bounded_queue_t* queue)
+{
+    // Assert that the pointer to the bounded queue variable is valid.
+    assert(queue != NULL);
+
+    free(queue->slots);
+    queue->slots = NULL;
+}
+
+// Define try_push_value (bounded_queue.h).
+bool try_push_value(struct bounded_queue_t* queue, void* value)
+{
+    // Assert that the pointer to the bounded queue variable is valid.
+    assert(queue != NULL);
+
+    size_t position = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    struct queue_slot_t* slot;
+
+    for (;;)
+    {
+        slot = &queue->slots[position & queue->mask];
+        size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        intptr_t difference = (intptr_t) sequence - (intptr_t) position;
+
+        // The slot is ready to be written at this position, so try to claim
+        // the position.
+        if (difference == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit(&queue->tail, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        // The slot still holds the value from the previous pass, so the queue
+        // is full.
+        else if (difference < 0)
+        {
+            return false;
+        }
+        // Another thread claimed the position first, so try the next one.
+        else
+        {
+            position = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+        }
+    }
+
+    // Publish the value to the thread which will remove it.
+    slot->value = value;
+    atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+
+    return true;
+}
+
+// Define try_pop_value (bounded_queue.h).
+bool try_pop_value(struct bounded_queue_t* queue, void** value)
+{
+    // Assert that the pointer to the bounded queue variable is valid.
+    assert(queue != NULL);
+    // Assert that the pointer to the value variable is valid.
+    assert(value != NULL);
+
+    size_t position = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    struct queue_slot_t* slot;
+
+    for (;;)
+    {
+        slot = &queue->slots[position & queue->mask];
+        size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        intptr_t difference = (intptr_t) sequence - (intptr_t) (position + 1);
+
+        // The slot holds a value written at this position, so try to claim the
+        // position.
+        if (difference == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit(&queue->head, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        // The value for this position has not been written, so the queue is
+        // empty.
+        else if (difference < 0)
+        {
+            return false;
+        }
+        // Another thread claimed the position first, so try the next one.
+        else
+        {
+            position = atomic_load_explicit(&queue->head, memory_order_relaxed);
+        }
+    }
+
+    // Take the value, then make the slot ready to be written in the next pass.
+    *value = slot->value;
+    atomic_store_explicit(&slot->sequence, position + queue->mask + 1, memory_order_release);
+
+    return true;
+}
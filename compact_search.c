@@ -0,0 +1,298 @@
+#include "compact_search.h"
+
+#include "action.h"
+#include "location.h"
+#include "maze.h"
+#include "stats.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/**
+ * \internal
+ *
+ * Represents a first-in, first-out queue of 32-bit location indexes.
+ *
+ * This struct contains a pointer to a dynamically allocated circular buffer,
+ * along with the position of the first index in the queue and the number of
+ * indexes in the queue.
+ */
+struct index_queue_t
+{
+    uint32_t* indexes;
+    size_t head;
+    size_t length;
+    size_t capacity;
+};
+
+/**
+ * \internal
+ *
+ * Adds an index to the back of a queue.
+ *
+ * This helper function attempts to add the given index to the queue, doubling
+ * the capacity of the circular buffer if it is full.
+ *
+ * \param [in,out] queue
+ *     A pointer to the queue.
+ * \param [in]     index
+ *     The index to add.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int enqueue_index(struct index_queue_t* queue, uint32_t index);
+
+/**
+ * \internal
+ *
+ * Removes the index at the front of a queue.
+ *
+ * \param [in,out] queue
+ *     A pointer to the queue.
+ *
+ * \pre
+ *     The queue must not be empty.
+ *
+ * \returns
+ *     The removed index.
+ */
+static uint32_t dequeue_index(struct index_queue_t* queue);
+
+/**
+ * \internal
+ *
+ * Solves a given maze using breadth-first search with a compact search state,
+ * reusing a given set of buffers and recording the work done.
+ *
+ * This helper function implements both solve_maze_compact_buffered() and
+ * solve_maze_compact_measured().
+ *
+ * \param [out]    list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]     maze
+ *     The maze to solve.
+ * \param [in,out] search
+ *     A pointer to the buffers to search with.
+ * \param [out]    stats
+ *     A pointer to the statistics variable which will record the work done, or
+ *     NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int search_compact(struct node_list_t* list, struct maze_t maze, struct compact_search_t* search, struct search_stats_t* stats);
+
+// Define make_compact_search (compact_search.h).
+int make_compact_search(struct compact_search_t* search, struct maze_size_t size)
+{
+    // Assert that the pointer to the compact search variable is valid.
+    assert(search != NULL);
+
+    if (make_location_set(&search->reached, size) != 0) return -1;
+
+    if (make_direction_map(&search->directions, size) != 0)
+    {
+        free_location_set(&search->reached);
+        return -1;
+    }
+
+    // Initialize compact search properties.
+    search->frontier = NULL;
+    search->frontier_capacity = 0;
+    search->capacity = size.rows * size.columns;
+
+    return 0;
+}
+
+// Define free_compact_search (compact_search.h).
+void free_compact_search(struct compact_search_t* search)
+{
+    // Assert that the pointer to the compact search variable is valid.
+    assert(search != NULL);
+
+    free(search->frontier);
+    free_direction_map(&search->directions);
+    free_location_set(&search->reached);
+
+    search->frontier = NULL;
+    search->frontier_capacity = 0;
+    search->capacity = 0;
+}
+
+// Define solve_maze_compact (compact_search.h).
+int solve_maze_compact(struct node_list_t* list, struct maze_t maze)
+{
+    return solve_maze_compact_measured(list, maze, NULL);
+}
+
+// Define solve_maze_compact_measured (compact_search.h).
+int solve_maze_compact_measured(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats)
+{
+    // Assert that the pointer to the node list variable is valid.
+    assert(list != NULL);
+
+    struct compact_search_t search;
+    if (make_compact_search(&search, maze.size) != 0) return -1;
+
+    int result = search_compact(list, maze, &search, stats);
+
+    free_compact_search(&search);
+
+    return result;
+}
+
+// Define solve_maze_compact_buffered (compact_search.h).
+int solve_maze_compact_buffered(struct node_list_t* list, struct maze_t maze, struct compact_search_t* search)
+{
+    // Assert that the pointer to the node list variable is valid.
+    assert(list != NULL);
+    // Assert that the pointer to the compact search variable is valid.
+    assert(search != NULL);
+
+    return search_compact(list, maze, search, NULL);
+}
+
+// Define search_compact (compact_search.c).
+static int search_compact(struct node_list_t* list, struct maze_t maze, struct compact_search_t* search, struct search_stats_t* stats)
+{
+    // Indicate failure if the locations cannot be indexed with 32 bits.
+    if (maze.size.rows * maze.size.columns > UINT32_MAX) return -1;
+
+    // Replace the location set and direction map if they are too small for the
+    // maze. Otherwise, only the reached locations need to be forgotten, as the
+    // directions are only read at reached locations.
+    if (maze.size.rows * maze.size.columns > search->capacity)
+    {
+        struct compact_search_t replacement;
+        if (make_compact_search(&replacement, maze.size) != 0) return -1;
+
+        replacement.frontier = search->frontier;
+        replacement.frontier_capacity = search->frontier_capacity;
+
+        free_direction_map(&search->directions);
+        free_location_set(&search->reached);
+
+        *search = replacement;
+    }
+    else
+    {
+        search->reached.size = maze.size;
+        search->directions.size = maze.size;
+        clear_location_set(&search->reached);
+    }
+
+    struct location_set_t* reached = &search->reached;
+    struct direction_map_t* directions = &search->directions;
+
+    // Begin the search at the end of the maze, as this implementation works
+    // backwards.
+    struct index_queue_t frontier = { search->frontier, 0, 0, search->frontier_capacity };
+    add_location(reached, maze.end);
+    int result = enqueue_index(&frontier, (uint32_t) location_index(maze.size, maze.end));
+
+    size_t expansions = 0;
+    size_t pushes = 1;
+    size_t frontier_peak = 1;
+
+    while (result == 0 && frontier.length > 0 && !contains_location(reached, maze.start))
+    {
+        uint32_t index = dequeue_index(&frontier);
+        expansions++;
+        struct location_t location = { index / maze.size.columns, index % maze.size.columns };
+
+        // Get the set of actions available for the location.
+        enum action_set_t action_set = get_action_set(maze, location);
+
+        for (enum action_t action = EAST; action <= NORTH; action++)
+        {
+            // Check if the action is contained in the set of actions.
+            if (!(action_set & (1 << action))) continue;
+
+            // Check that the location reachable by the action has not already
+            // been reached.
+            struct location_t child = action_result(location, action);
+            if (contains_location(reached, child)) continue;
+
+            // Mark the location as reached, recording the way back.
+            uint32_t child_index = (uint32_t) location_index(maze.size, child);
+            add_location(reached, child);
+            set_direction(directions, child_index, reverse_action(action));
+
+            result = enqueue_index(&frontier, child_index);
+            if (result != 0) break;
+
+            pushes++;
+            if (frontier.length > frontier_peak) frontier_peak = frontier.length;
+        }
+    }
+
+    // Record the work done.
+    if (stats != NULL)
+    {
+        stats->recorded = true;
+        stats->expansions = expansions;
+        stats->pushes = pushes;
+        stats->duplicate_pushes = 0;
+        stats->frontier_peak = frontier_peak;
+    }
+
+    // Keep the buffer of the frontier, which may have grown, for the next
+    // search.
+    search->frontier = frontier.indexes;
+    search->frontier_capacity = frontier.capacity;
+
+    // If the start of the maze was reached, follow the directions to build the
+    // path.
+    if (result == 0)
+    {
+        result = contains_location(reached, maze.start)
+               ? append_direction_path(list, maze, directions)
+               : -1;
+    }
+
+    return result;
+}
+
+// Define enqueue_index (compact_search.c).
+static int enqueue_index(struct index_queue_t* queue, uint32_t index)
+{
+    // If the capacity has been reached, resize the buffer.
+    if (queue->length >= queue->capacity)
+    {
+        // Resize according to 2 * previous capacity.
+        size_t new_capacity = (queue->capacity == 0) ? 64 : queue->capacity * 2;
+        void* ptr = realloc((void*) queue->indexes, new_capacity * sizeof(uint32_t));
+
+        // Indicate failure if resize failed.
+        if (ptr == NULL) return -1;
+
+        queue->indexes = (uint32_t*) ptr;
+
+        // The buffer is full, so any indexes before the head wrapped around.
+        // Move them to follow on from the end of the old buffer.
+        memcpy(queue->indexes + queue->capacity, queue->indexes, queue->head * sizeof(uint32_t));
+
+        queue->capacity = new_capacity;
+    }
+
+    queue->indexes[(queue->head + queue->length) % queue->capacity] = index;
+    queue->length++;
+
+    return 0;
+}
+
+// Define dequeue_index (compact_search.c).
+static uint32_t dequeue_index(struct index_queue_t* queue)
+{
+    uint32_t index = queue->indexes[queue->head];
+
+    queue->head = (queue->head + 1) % queue->capacity;
+    queue->length--;
+
+    return index;
+}
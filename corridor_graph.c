@@ -0,0 +1,524 @@
+#include "corridor_graph.h"
+
+#include "action.h"
+#include "action_set.h"
+#include "node.h"
+#include "node_list.h"
+#include "node_queue.h"
+#include "maze.h"
+#include "stats.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+
+/**
+ * \internal
+ *
+ * Represents the state of a junction during a search of a corridor graph.
+ *
+ * This struct contains the number of actions taken to reach the junction plus
+ * one, so that zero indicates that the junction has not been reached, the
+ * position of the corridor the junction was reached through, and the junction
+ * that corridor leaves. Once the start has been reached, the junctions on the
+ * path also hold the next junction on the path, leading away from the end.
+ */
+struct junction_state_t
+{
+    size_t cost;
+    size_t corridor;
+    size_t parent;
+    size_t child;
+};
+
+/**
+ * \internal
+ *
+ * Counts the set bits of a word.
+ *
+ * \param [in] word
+ *     The word.
+ *
+ * \returns
+ *     The number of set bits.
+ */
+static unsigned int count_bits(uint64_t word);
+
+/**
+ * \internal
+ *
+ * Finds the lowest set bit of a non-zero word.
+ *
+ * \param [in] word
+ *     The word, which must not be zero.
+ *
+ * \returns
+ *     The index of the lowest set bit.
+ */
+static unsigned int lowest_bit(uint64_t word);
+
+/**
+ * \internal
+ *
+ * Determines if a location is a junction of a maze.
+ *
+ * \param [in] maze
+ *     The maze containing the location.
+ * \param [in] location
+ *     The location to check.
+ * \param [in] action_set
+ *     The set of actions available at the location.
+ *
+ * \returns
+ *     Whether the location is the start or end of the maze, or does not have
+ *     exactly two actions available.
+ */
+static bool is_junction(struct maze_t maze, struct location_t location, enum action_set_t action_set);
+
+/**
+ * \internal
+ *
+ * Takes a step along a corridor of a maze.
+ *
+ * This helper function takes the given action from the given location, and if
+ * the location reached is not a junction, sets the given action to the only
+ * other action available there, so that the next step carries on along the
+ * corridor.
+ *
+ * \param [in]     maze
+ *     The maze containing the corridor.
+ * \param [in,out] location
+ *     A pointer to the location to step from, which will contain the location
+ *     reached.
+ * \param [in,out] action
+ *     A pointer to the action to take, which will contain the action to take
+ *     next.
+ *
+ * \returns
+ *     -1 if the step leaves the maze or reaches a location from which the
+ *     corridor does not lead back, 1 if a junction is reached, 0 otherwise.
+ */
+static int follow_corridor(struct maze_t maze, struct location_t* location, enum action_t* action);
+
+/**
+ * \internal
+ *
+ * Gets the location of a junction in a corridor graph.
+ *
+ * \param [in] graph
+ *     A pointer to the corridor graph.
+ * \param [in] junction
+ *     The index of the junction in the graph.
+ *
+ * \returns
+ *     The location of the junction.
+ */
+static struct location_t junction_location(const struct corridor_graph_t* graph, size_t junction);
+
+/**
+ * \internal
+ *
+ * Appends the path found by a search of a corridor graph to a node list.
+ *
+ * This helper function follows the junctions on the path from the end of the
+ * maze, walking along the corridor leading to each of them to append a node for
+ * every location, such that the final node in the list will be the start.
+ *
+ * \param [in,out] list
+ *     A pointer to the node list to append the path to.
+ * \param [in]     maze
+ *     The maze containing the path.
+ * \param [in]     graph
+ *     A pointer to the corridor graph of the maze.
+ * \param [in,out] states
+ *     A pointer to the array holding the state of every junction.
+ * \param [in]     start
+ *     The index of the junction at the start of the maze.
+ * \param [in]     end
+ *     The index of the junction at the end of the maze.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int append_corridor_path(struct node_list_t* list, struct maze_t maze, const struct corridor_graph_t* graph, struct junction_state_t* states, size_t start, size_t end);
+
+// Define make_corridor_graph (corridor_graph.h).
+int make_corridor_graph(struct corridor_graph_t* graph, struct maze_t maze)
+{
+    // Assert that the pointer to the corridor graph variable is valid.
+    assert(graph != NULL);
+
+    size_t length = maze.size.rows * maze.size.columns;
+
+    // Indicate failure if the locations cannot be indexed with 32 bits.
+    if (length > UINT32_MAX) return -1;
+
+    size_t word_count = (length + 63) / 64;
+
+    *graph = (struct corridor_graph_t) { .size = maze.size };
+    graph->bits = (uint64_t*) calloc(word_count, sizeof(uint64_t));
+    graph->ranks = (uint32_t*) malloc(word_count * sizeof(uint32_t));
+
+    unsigned char* row_action_sets = (unsigned char*) malloc(maze.size.columns);
+
+    if (graph->bits == NULL || graph->ranks == NULL || row_action_sets == NULL)
+    {
+        free(row_action_sets);
+        free_corridor_graph(graph);
+        return -1;
+    }
+
+    // Mark the junctions and count the corridors leaving them, which is at
+    // most the number of actions available at them.
+    size_t action_count = 0;
+
+    for (size_t row = 0; row < maze.size.rows; row++)
+    {
+        get_row_action_sets(maze, row, row_action_sets);
+
+        for (size_t column = 0; column < maze.size.columns; column++)
+        {
+            enum action_set_t action_set = (enum action_set_t) row_action_sets[column];
+            if (!is_junction(maze, (struct location_t) { row, column }, action_set)) continue;
+
+            size_t index = row * maze.size.columns + column;
+            graph->bits[index / 64] |= (uint64_t) 1 << (index % 64);
+            action_count += (size_t) count_bits((uint64_t) action_set);
+        }
+    }
+
+    free(row_action_sets);
+
+    // Count the junctions before each word of bits.
+    size_t junction_count = 0;
+    for (size_t word = 0; word < word_count; word++)
+    {
+        graph->ranks[word] = (uint32_t) junction_count;
+        junction_count += (size_t) count_bits(graph->bits[word]);
+    }
+
+    graph->junctions = (uint32_t*) malloc(junction_count * sizeof(uint32_t));
+    graph->offsets = (size_t*) malloc((junction_count + 1) * sizeof(size_t));
+    graph->corridors = (struct corridor_t*) malloc(action_count * sizeof(struct corridor_t));
+    graph->junction_count = junction_count;
+
+    if ((graph->junctions == NULL && junction_count != 0) || graph->offsets == NULL || (graph->corridors == NULL && action_count != 0))
+    {
+        free_corridor_graph(graph);
+        return -1;
+    }
+
+    // Record the junctions in ascending order of index.
+    size_t junction = 0;
+    for (size_t word = 0; word < word_count; word++)
+    {
+        for (uint64_t bits = graph->bits[word]; bits != 0; bits &= bits - 1)
+        {
+            graph->junctions[junction++] = (uint32_t) (word * 64 + (size_t) lowest_bit(bits));
+        }
+    }
+
+    // Walk along every corridor leaving each junction to find where it leads.
+    for (junction = 0; junction < junction_count; junction++)
+    {
+        graph->offsets[junction] = graph->corridor_count;
+
+        struct location_t origin = junction_location(graph, junction);
+        enum action_set_t action_set = get_action_set(maze, origin);
+
+        for (enum action_t first = EAST; first <= NORTH; first++)
+        {
+            if (!(action_set & (1 << first))) continue;
+
+            struct location_t location = origin;
+            enum action_t action = first;
+            size_t steps = 0;
+            int step = 0;
+
+            // A corridor cannot be longer than the maze, so a longer walk must
+            // be going round a loop of passages which only lead one way.
+            do
+            {
+                step = follow_corridor(maze, &location, &action);
+                steps++;
+            }
+            while (step == 0 && steps < length);
+
+            size_t target = 0;
+            if (step != 1 || !find_junction(graph, location, &target) || target == junction) continue;
+
+            graph->corridors[graph->corridor_count++] = (struct corridor_t) { (uint32_t) target, (uint32_t) steps, (unsigned char) first };
+        }
+    }
+
+    graph->offsets[junction_count] = graph->corridor_count;
+
+    // Release the space left by any corridors which were left out.
+    if (graph->corridor_count < action_count && graph->corridor_count != 0)
+    {
+        void* ptr = realloc((void*) graph->corridors, graph->corridor_count * sizeof(struct corridor_t));
+        if (ptr != NULL) graph->corridors = (struct corridor_t*) ptr;
+    }
+
+    return 0;
+}
+
+// Define free_corridor_graph (corridor_graph.h).
+void free_corridor_graph(struct corridor_graph_t* graph)
+{
+    // Assert that the pointer to the corridor graph variable is valid.
+    assert(graph != NULL);
+
+    free(graph->corridors);
+    free(graph->offsets);
+    free(graph->ranks);
+    free(graph->bits);
+    free(graph->junctions);
+
+    graph->junctions = NULL;
+    graph->bits = NULL;
+    graph->ranks = NULL;
+    graph->offsets = NULL;
+    graph->corridors = NULL;
+    graph->junction_count = 0;
+    graph->corridor_count = 0;
+}
+
+// Define find_junction (corridor_graph.h).
+bool find_junction(const struct corridor_graph_t* graph, struct location_t location, size_t* junction)
+{
+    // Assert that the pointer to the corridor graph variable is valid.
+    assert(graph != NULL);
+    // Assert that the pointer to the junction variable is valid.
+    assert(junction != NULL);
+
+    if (!check_location(graph->size, location)) return false;
+
+    size_t index = location_index(graph->size, location);
+    uint64_t word = graph->bits[index / 64];
+    uint64_t bit = (uint64_t) 1 << (index % 64);
+
+    if (!(word & bit)) return false;
+
+    // Number the junction by the junctions before its word, plus those before
+    // it within the word.
+    *junction = graph->ranks[index / 64] + (size_t) count_bits(word & (bit - 1));
+
+    return true;
+}
+
+// Define solve_corridor_graph (corridor_graph.h).
+int solve_corridor_graph(struct node_list_t* list, struct maze_t maze, const struct corridor_graph_t* graph, struct search_stats_t* stats)
+{
+    // Assert that the pointer to the node list variable is valid.
+    assert(list != NULL);
+    // Assert that the pointer to the corridor graph variable is valid.
+    assert(graph != NULL);
+
+    size_t start = 0;
+    size_t end = 0;
+    if (!find_junction(graph, maze.start, &start) || !find_junction(graph, maze.end, &end)) return -1;
+
+    // Create the array that will contain the state of every junction, which is
+    // initially zero as no junctions are reached.
+    struct junction_state_t* states = (struct junction_state_t*) calloc(graph->junction_count, sizeof(struct junction_state_t));
+    if (states == NULL) return -1;
+
+    // Create the queue that will contain all junctions in the frontier. The
+    // queue indexes nodes by location, so each junction is given the location
+    // in a single row whose column is the index of the junction.
+    struct node_queue_t frontier;
+    if (make_queue(&frontier, (struct maze_size_t) { 1, graph->junction_count }, 64) != 0)
+    {
+        free(states);
+        return -1;
+    }
+
+    // Push the end junction onto the frontier, which is reached by taking no
+    // actions, as this implementation works backwards.
+    struct node_t node = { { 0, end }, NULL };
+    states[end].cost = 1;
+    int result = push_node(&frontier, &node, location_manhattan(maze.end, maze.start));
+
+    size_t expansions = 0;
+    bool found = false;
+
+    while (result == 0 && frontier.length > 0)
+    {
+        // Get the next junction to expand.
+        pop_node(&frontier, &node);
+        size_t junction = node.location.column;
+        expansions++;
+
+        // If the junction is the start, the search is complete.
+        if (junction == start)
+        {
+            found = true;
+            break;
+        }
+
+        // Push every junction which is reached sooner through one of the
+        // corridors leaving this junction than it has been before.
+        for (size_t position = graph->offsets[junction]; position < graph->offsets[junction + 1]; position++)
+        {
+            struct corridor_t corridor = graph->corridors[position];
+            struct junction_state_t* state = &states[corridor.target];
+            size_t cost = states[junction].cost + corridor.length;
+
+            if (state->cost != 0 && state->cost <= cost) continue;
+
+            state->cost = cost;
+            state->corridor = position;
+            state->parent = junction;
+
+            struct node_t child = { { 0, corridor.target }, NULL };
+            size_t estimate = cost - 1 + location_manhattan(junction_location(graph, corridor.target), maze.start);
+
+            result = push_node(&frontier, &child, estimate);
+            if (result != 0) break;
+        }
+    }
+
+    // Record the work done, where junctions rather than locations are counted.
+    if (stats != NULL)
+    {
+        stats->recorded = true;
+        stats->expansions = expansions;
+        stats->pushes = frontier.order + frontier.merges;
+        stats->duplicate_pushes = frontier.merges;
+        stats->frontier_peak = frontier.peak_length;
+    }
+
+    free_queue(&frontier);
+
+    // If the start of the maze was reached, walk the corridors to build the
+    // path.
+    if (result == 0) result = found ? append_corridor_path(list, maze, graph, states, start, end) : -1;
+
+    free(states);
+
+    return result;
+}
+
+// Define solve_maze_corridors_measured (corridor_graph.h).
+int solve_maze_corridors_measured(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats)
+{
+    // Assert that the pointer to the node list variable is valid.
+    assert(list != NULL);
+
+    struct corridor_graph_t graph;
+    if (make_corridor_graph(&graph, maze) != 0) return -1;
+
+    int result = solve_corridor_graph(list, maze, &graph, stats);
+
+    free_corridor_graph(&graph);
+
+    return result;
+}
+
+// Define solve_maze_corridors (corridor_graph.h).
+int solve_maze_corridors(struct node_list_t* list, struct maze_t maze)
+{
+    return solve_maze_corridors_measured(list, maze, NULL);
+}
+
+// Define count_bits (corridor_graph.c).
+static unsigned int count_bits(uint64_t word)
+{
+#if defined(__GNUC__)
+    return (unsigned int) __builtin_popcountll(word);
+#else
+    unsigned int count = 0;
+    for (; word != 0; word &= word - 1) count++;
+    return count;
+#endif
+}
+
+// Define lowest_bit (corridor_graph.c).
+static unsigned int lowest_bit(uint64_t word)
+{
+#if defined(__GNUC__)
+    return (unsigned int) __builtin_ctzll(word);
+#else
+    unsigned int bit = 0;
+    for (; !(word & 1); word >>= 1) bit++;
+    return bit;
+#endif
+}
+
+// Define is_junction (corridor_graph.c).
+static bool is_junction(struct maze_t maze, struct location_t location, enum action_set_t action_set)
+{
+    return count_bits((uint64_t) action_set) != 2
+        || location_equal(location, maze.start)
+        || location_equal(location, maze.end);
+}
+
+// Define follow_corridor (corridor_graph.c).
+static int follow_corridor(struct maze_t maze, struct location_t* location, enum action_t* action)
+{
+    struct location_t next = action_result(*location, *action);
+    if (!check_location(maze.size, next)) return -1;
+
+    *location = next;
+
+    enum action_set_t action_set = get_action_set(maze, next);
+    if (is_junction(maze, next, action_set)) return 1;
+
+    // Leave by the action that does not lead back, which is the only one left
+    // unless the corridor does not lead back at all.
+    unsigned int exits = (unsigned int) action_set & ~(1u << reverse_action(*action));
+    if ((exits & (exits - 1)) != 0) return -1;
+
+    *action = (enum action_t) lowest_bit(exits);
+
+    return 0;
+}
+
+// Define junction_location (corridor_graph.c).
+static struct location_t junction_location(const struct corridor_graph_t* graph, size_t junction)
+{
+    uint32_t index = graph->junctions[junction];
+
+    return (struct location_t) { index / graph->size.columns, index % graph->size.columns };
+}
+
+// Define append_corridor_path (corridor_graph.c).
+static int append_corridor_path(struct node_list_t* list, struct maze_t maze, const struct corridor_graph_t* graph, struct junction_state_t* states, size_t start, size_t end)
+{
+    // Link each junction on the path to the next one away from the end.
+    for (size_t junction = start; junction != end; junction = states[junction].parent)
+    {
+        states[states[junction].parent].child = junction;
+    }
+
+    // Make space for a node at every location on the path, so that the parents
+    // of the nodes are not moved as they are appended.
+    size_t length = states[start].cost - 1;
+    if (list->capacity < list->length + length + 1)
+    {
+        if (resize_list(list, list->length + length + 1) != 0) return -1;
+    }
+
+    struct node_t node = { maze.end, NULL };
+    if (insert_node(list, &node, list->length) != 0) return -1;
+
+    // Walk along the corridor to each junction on the path in turn, appending
+    // a node for every location along the way.
+    for (size_t junction = end; junction != start; junction = states[junction].child)
+    {
+        struct corridor_t corridor = graph->corridors[states[states[junction].child].corridor];
+        struct location_t location = junction_location(graph, junction);
+        enum action_t action = (enum action_t) corridor.action;
+
+        for (uint32_t step = 0; step < corridor.length; step++)
+        {
+            follow_corridor(maze, &location, &action);
+
+            node = (struct node_t) { location, get_node(list, list->length - 1) };
+            if (insert_node(list, &node, list->length) != 0) return -1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,401 @@
+#include "dead_end.h"
+
+#include "action.h"
+#include "action_set.h"
+#include "location.h"
+#include "maze_size.h"
+#include "maze.h"
+#include "node.h"
+#include "node_list.h"
+#include "compact_search.h"
+#include "stats.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/**
+ * \internal
+ *
+ * Represents a dynamically allocated stack of location indexes.
+ *
+ * This struct contains a pointer to the array of indexes, along with the
+ * number of indexes in the stack and the number it has space for.
+ */
+struct index_stack_t
+{
+    size_t* indexes;
+    size_t length;
+    size_t capacity;
+};
+
+/**
+ * \internal
+ *
+ * Pushes an index onto a stack.
+ *
+ * This helper function attempts to add the given index to the top of the
+ * stack, doubling the capacity of the stack if it is full.
+ *
+ * \param [in,out] stack
+ *     A pointer to the stack.
+ * \param [in]     index
+ *     The index to push.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int push_index(struct index_stack_t* stack, size_t index);
+
+/**
+ * \internal
+ *
+ * Determines if a set of actions holds exactly one action.
+ *
+ * \param [in] action_set
+ *     The set of actions.
+ *
+ * \returns
+ *     Whether the set holds exactly one action.
+ */
+static bool single_action(unsigned int action_set);
+
+/**
+ * \internal
+ *
+ * Finds the lowest set bit of a non-zero word.
+ *
+ * \param [in] word
+ *     The word, which must not be zero.
+ *
+ * \returns
+ *     The index of the lowest set bit.
+ */
+static unsigned int lowest_bit(uint64_t word);
+
+/**
+ * \internal
+ *
+ * Finds the locations with a single action available among the sixteen
+ * locations packed into a 64-bit word of an action set array.
+ *
+ * This helper function counts the actions of every location in the word at
+ * once, two bits at a time and then four, and then tests every count against
+ * one at once, without letting any count carry into the next.
+ *
+ * \param [in] word
+ *     The word of the action set array, with the location of lowest index in
+ *     the lowest four bits.
+ *
+ * \returns
+ *     A word with the highest bit of each location with a single action set.
+ */
+static uint64_t find_single_actions(uint64_t word);
+
+/**
+ * \internal
+ *
+ * Takes a step along the path left in a pruned maze.
+ *
+ * \param [in]     maze
+ *     The pruned maze.
+ * \param [in,out] location
+ *     A pointer to the location to step from, which will contain the location
+ *     reached.
+ * \param [in,out] action
+ *     A pointer to the action taken to reach the location, which will contain
+ *     the action taken to leave it.
+ * \param [in]     first
+ *     Whether the location is the first on the path, so no action was taken to
+ *     reach it.
+ *
+ * \returns
+ *     Whether there was exactly one way on from the location, leading to a
+ *     location within the maze.
+ */
+static bool step_pruned_path(struct maze_t maze, struct location_t* location, enum action_t* action, bool first);
+
+/**
+ * \internal
+ *
+ * Fills the dead ends of a maze, giving a pruned copy of the maze, and records
+ * the work done.
+ *
+ * This helper function implements both fill_dead_ends() and
+ * solve_maze_dead_ends_measured().
+ *
+ * \param [out] pruned
+ *     A pointer to the maze variable that will be initialized with the pruned
+ *     copy of the maze.
+ * \param [in]  maze
+ *     The maze to prune.
+ * \param [out] filled
+ *     A pointer to the variable which will contain the number of locations
+ *     sealed, or NULL.
+ * \param [out] stats
+ *     A pointer to the statistics variable which will record the work done, or
+ *     NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int seal_dead_ends(struct maze_t* pruned, struct maze_t maze, size_t* filled, struct search_stats_t* stats);
+
+// Define fill_dead_ends (dead_end.h).
+int fill_dead_ends(struct maze_t* pruned, struct maze_t maze, size_t* filled)
+{
+    // Assert that the pointer to the pruned maze variable is valid.
+    assert(pruned != NULL);
+
+    return seal_dead_ends(pruned, maze, filled, NULL);
+}
+
+// Define solve_maze_dead_ends (dead_end.h).
+int solve_maze_dead_ends(struct node_list_t* list, struct maze_t maze)
+{
+    return solve_maze_dead_ends_measured(list, maze, NULL);
+}
+
+// Define solve_maze_dead_ends_measured (dead_end.h).
+int solve_maze_dead_ends_measured(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats)
+{
+    // Assert that the pointer to the node list variable is valid.
+    assert(list != NULL);
+
+    struct maze_t pruned;
+    if (seal_dead_ends(&pruned, maze, NULL, stats) != 0) return -1;
+
+    // Walk from the end to find the length of the path, which must have one
+    // way on at every location.
+    size_t limit = maze.size.rows * maze.size.columns;
+    struct location_t location = maze.end;
+    enum action_t action = EAST;
+    size_t length = 0;
+    bool clear = true;
+
+    while (clear && !location_equal(location, maze.start))
+    {
+        clear = step_pruned_path(pruned, &location, &action, length == 0) && ++length < limit;
+    }
+
+    int result = 0;
+
+    if (!clear)
+    {
+        // Search the pruned maze instead, as it still has a loop, adding the
+        // work done by the search to the work done pruning.
+        struct search_stats_t search_stats = { .recorded = false };
+        result = solve_maze_compact_measured(list, pruned, (stats != NULL) ? &search_stats : NULL);
+
+        if (stats != NULL && search_stats.recorded)
+        {
+            stats->expansions += search_stats.expansions;
+            stats->pushes += search_stats.pushes;
+            stats->duplicate_pushes += search_stats.duplicate_pushes;
+            if (search_stats.frontier_peak > stats->frontier_peak) stats->frontier_peak = search_stats.frontier_peak;
+        }
+    }
+    else
+    {
+        // Make space for a node at every location on the path, so that the
+        // parents of the nodes are not moved as they are appended.
+        if (list->capacity < list->length + length + 1)
+        {
+            result = resize_list(list, list->length + length + 1);
+        }
+
+        // Walk the path again, appending a node for every location.
+        struct node_t node = { maze.end, NULL };
+        if (result == 0) result = insert_node(list, &node, list->length);
+
+        location = maze.end;
+        for (size_t step = 0; result == 0 && step < length; step++)
+        {
+            step_pruned_path(pruned, &location, &action, step == 0);
+
+            node = (struct node_t) { location, get_node(list, list->length - 1) };
+            result = insert_node(list, &node, list->length);
+        }
+    }
+
+    free_maze(&pruned);
+
+    return result;
+}
+
+// Define seal_dead_ends (dead_end.c).
+static int seal_dead_ends(struct maze_t* pruned, struct maze_t maze, size_t* filled, struct search_stats_t* stats)
+{
+    if (make_maze(pruned, maze.size, maze.start, maze.end) != 0) return -1;
+
+    size_t length = maze.size.rows * maze.size.columns;
+    memcpy(pruned->action_sets, maze.action_sets, (length + 1) / 2);
+
+    const unsigned char* action_sets = pruned->action_sets;
+    struct index_stack_t stack = { NULL, 0, 0 };
+    int result = 0;
+
+    // Scan the whole words of the action set array for dead ends, sixteen
+    // locations at a time.
+    size_t word_count = length / 16;
+    for (size_t word_index = 0; result == 0 && word_index < word_count; word_index++)
+    {
+        const unsigned char* bytes = action_sets + word_index * 8;
+
+        uint64_t word = 0;
+        for (size_t byte = 0; byte < 8; byte++) word |= (uint64_t) bytes[byte] << (byte * 8);
+
+        for (uint64_t singles = find_single_actions(word); singles != 0; singles &= singles - 1)
+        {
+            result = push_index(&stack, word_index * 16 + (size_t) lowest_bit(singles) / 4);
+            if (result != 0) break;
+        }
+    }
+
+    // Scan the locations left over one at a time.
+    for (size_t index = word_count * 16; result == 0 && index < length; index++)
+    {
+        if (single_action(get_indexed_action_set(*pruned, index))) result = push_index(&stack, index);
+    }
+
+    size_t start_index = location_index(maze.size, maze.start);
+    size_t end_index = location_index(maze.size, maze.end);
+    size_t count = 0;
+
+    // The stack is at its largest once the scan has finished.
+    size_t pushes = stack.length;
+    size_t pops = 0;
+    size_t frontier_peak = stack.length;
+
+    // Seal each dead end, carrying on along the passage while the neighbour
+    // becomes a dead end. Every pop pushes at most one index, so the stack
+    // never grows beyond the dead ends found by the scan.
+    while (result == 0 && stack.length > 0)
+    {
+        size_t index = stack.indexes[--stack.length];
+        pops++;
+
+        if (index == start_index || index == end_index) continue;
+
+        // Skip any location already sealed from the other side.
+        enum action_set_t action_set = get_indexed_action_set(*pruned, index);
+        if (!single_action(action_set)) continue;
+
+        set_indexed_action_set(*pruned, (enum action_set_t) 0, index);
+        count++;
+
+        enum action_t action = (enum action_t) lowest_bit(action_set);
+        struct location_t location = { index / maze.size.columns, index % maze.size.columns };
+        struct location_t next = action_result(location, action);
+
+        if (!check_location(maze.size, next)) continue;
+
+        // Close the passage back from the neighbour.
+        size_t next_index = location_index(maze.size, next);
+        unsigned int next_set = get_indexed_action_set(*pruned, next_index) & ~(1u << reverse_action(action));
+        set_indexed_action_set(*pruned, (enum action_set_t) next_set, next_index);
+
+        if (single_action(next_set))
+        {
+            result = push_index(&stack, next_index);
+            pushes++;
+        }
+    }
+
+    free(stack.indexes);
+
+    if (result != 0)
+    {
+        free_maze(pruned);
+        return -1;
+    }
+
+    if (filled != NULL) *filled = count;
+
+    // Record the work done, where every location taken from the stack without
+    // being sealed was pushed for nothing.
+    if (stats != NULL)
+    {
+        stats->recorded = true;
+        stats->expansions = count;
+        stats->pushes = pushes;
+        stats->duplicate_pushes = pops - count;
+        stats->frontier_peak = frontier_peak;
+    }
+
+    return 0;
+}
+
+// Define push_index (dead_end.c).
+static int push_index(struct index_stack_t* stack, size_t index)
+{
+    // If the capacity has been reached, resize the stack.
+    if (stack->length >= stack->capacity)
+    {
+        // Resize according to 2 * previous capacity.
+        size_t new_capacity = (stack->capacity == 0) ? 64 : stack->capacity * 2;
+        void* ptr = realloc((void*) stack->indexes, new_capacity * sizeof(size_t));
+
+        // Indicate failure if resize failed.
+        if (ptr == NULL) return -1;
+
+        stack->indexes = (size_t*) ptr;
+        stack->capacity = new_capacity;
+    }
+
+    stack->indexes[stack->length++] = index;
+
+    return 0;
+}
+
+// Define single_action (dead_end.c).
+static bool single_action(unsigned int action_set)
+{
+    return action_set != 0 && (action_set & (action_set - 1)) == 0;
+}
+
+// Define lowest_bit (dead_end.c).
+static unsigned int lowest_bit(uint64_t word)
+{
+#if defined(__GNUC__)
+    return (unsigned int) __builtin_ctzll(word);
+#else
+    unsigned int bit = 0;
+    for (; !(word & 1); word >>= 1) bit++;
+    return bit;
+#endif
+}
+
+// Define find_single_actions (dead_end.c).
+static uint64_t find_single_actions(uint64_t word)
+{
+    // Count the actions of each location, first in each pair of bits, then in
+    // each group of four.
+    uint64_t pairs = word - ((word >> 1) & 0x5555555555555555);
+    uint64_t counts = (pairs & 0x3333333333333333) + ((pairs >> 2) & 0x3333333333333333);
+
+    // A location has a single action where its count differs from one in no
+    // bits. Adding seven to the low three bits of each difference sets its
+    // highest bit if any of them are set, without carrying into the next.
+    uint64_t differences = counts ^ 0x1111111111111111;
+    uint64_t nonzero = ((differences & 0x7777777777777777) + 0x7777777777777777) | differences;
+
+    return ~nonzero & 0x8888888888888888;
+}
+
+// Define step_pruned_path (dead_end.c).
+static bool step_pruned_path(struct maze_t maze, struct location_t* location, enum action_t* action, bool first)
+{
+    unsigned int action_set = (unsigned int) get_action_set(maze, *location);
+    if (!first) action_set &= ~(1u << reverse_action(*action));
+
+    if (!single_action(action_set)) return false;
+
+    *action = (enum action_t) lowest_bit(action_set);
+    *location = action_result(*location, *action);
+
+    return check_location(maze.size, *location);
+}
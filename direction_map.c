@@ -0,0 +1,114 @@
+#include "direction_map.h"
+
+#include "location.h"
+#include "node.h"
+#include "node_list.h"
+#include "maze.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+
+// Define make_direction_map (direction_map.h).
+int make_direction_map(struct direction_map_t* map, struct maze_size_t size)
+{
+    // Assert that the pointer to the direction map variable is valid.
+    assert(map != NULL);
+
+    // Allocate the memory required for the map, packing four locations into
+    // each byte.
+    void* ptr = calloc((size.rows * size.columns + 3) / 4, sizeof(unsigned char));
+
+    // Indicate failure if allocation failed.
+    if (ptr == NULL) return -1;
+
+    // Initialize direction map properties.
+    map->bits = (unsigned char*) ptr;
+    map->size = size;
+
+    return 0;
+}
+
+// Define free_direction_map (direction_map.h).
+void free_direction_map(struct direction_map_t* map)
+{
+    // Assert that the pointer to the direction map variable is valid.
+    assert(map != NULL);
+
+    free(map->bits);
+    map->bits = NULL;
+}
+
+// Define set_direction (direction_map.h).
+void set_direction(struct direction_map_t* map, size_t index, enum action_t action)
+{
+    // Assert that the pointer to the direction map variable is valid.
+    assert(map != NULL);
+    // Assert that the index is within the maze.
+    assert(index < map->size.rows * map->size.columns);
+
+    // Replace the two bits holding the action, leaving the others.
+    unsigned int shift = (index % 4) * 2;
+    unsigned char* byte = &map->bits[index / 4];
+
+    *byte = (unsigned char) ((*byte & ~(0x3u << shift)) | ((unsigned int) action << shift));
+}
+
+// Define get_direction (direction_map.h).
+enum action_t get_direction(struct direction_map_t* map, size_t index)
+{
+    // Assert that the pointer to the direction map variable is valid.
+    assert(map != NULL);
+    // Assert that the index is within the maze.
+    assert(index < map->size.rows * map->size.columns);
+
+    return (enum action_t) ((map->bits[index / 4] >> ((index % 4) * 2)) & 0x3);
+}
+
+// Define append_direction_path (direction_map.h).
+int append_direction_path(struct node_list_t* list, struct maze_t maze, struct direction_map_t* map)
+{
+    // Assert that the pointer to the node list variable is valid.
+    assert(list != NULL);
+    // Assert that the pointer to the direction map variable is valid.
+    assert(map != NULL);
+
+    size_t limit = maze.size.rows * maze.size.columns;
+
+    // Follow the actions from the start to find the length of the path,
+    // indicating failure if the path leaves the maze or revisits a location.
+    struct location_t location = maze.start;
+    size_t length = 0;
+
+    while (!location_equal(location, maze.end))
+    {
+        location = action_result(location, get_direction(map, location_index(maze.size, location)));
+
+        if (!check_location(maze.size, location) || ++length >= limit) return -1;
+    }
+
+    // Make space for a node at every location on the path, so that the parents
+    // of the nodes are not moved as they are appended.
+    size_t base = list->length;
+    if (list->capacity < base + length + 1)
+    {
+        if (resize_list(list, base + length + 1) != 0) return -1;
+    }
+
+    list->length = base + length + 1;
+
+    // Follow the actions again, placing the nodes in reverse order, so that the
+    // end is appended first and the start last.
+    location = maze.start;
+    for (size_t step = 0; step <= length; step++)
+    {
+        struct node_t* node = get_node(list, base + length - step);
+
+        node->location = location;
+        node->parent = (step == length) ? NULL : get_node(list, base + length - step - 1);
+
+        if (step < length) location = action_result(location, get_direction(map, location_index(maze.size, location)));
+    }
+
+    return 0;
+}
@@ -0,0 +1,768 @@
+#include "generator.h"
+
+#include "location.h"
+#include "maze_size.h"
+#include "action.h"
+#include "action_set.h"
+#include "maze.h"
+#include "direction_map.h"
+#include "io.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/**
+ * \internal
+ *
+ * Represents the state of Eller's algorithm between rows.
+ *
+ * This struct contains the row being built and the row below it, which holds
+ * the passages carried down so far, along with the sets of the locations of
+ * each row, kept as a disjoint set forest over its columns where a column which
+ * is its own parent names its set. Every pseudo-random number drawn for the
+ * choices of the algorithm gives 64 of them, which are kept until used.
+ */
+struct eller_t
+{
+    size_t rows;
+    size_t columns;
+    size_t row;
+    size_t* sets;
+    size_t* next_sets;
+    size_t* carried;
+    unsigned char* action_sets;
+    unsigned char* next_action_sets;
+    uint64_t state;
+    uint64_t bits;
+    unsigned int bits_left;
+    unsigned int braid;
+};
+
+/**
+ * \internal
+ *
+ * Advances a splitmix64 pseudo-random number generator.
+ *
+ * \param [in,out] state
+ *     A pointer to the state of the generator, which may be any value.
+ *
+ * \returns
+ *     The next pseudo-random number.
+ */
+static uint64_t next_random(uint64_t* state);
+
+/**
+ * \internal
+ *
+ * Chooses a pseudo-random number below a given bound.
+ *
+ * \param [in,out] state
+ *     A pointer to the state of the generator.
+ * \param [in]     bound
+ *     The bound, which must be between 1 and 2^32.
+ *
+ * \returns
+ *     A pseudo-random number which is less than the bound.
+ */
+static size_t random_below(uint64_t* state, size_t bound);
+
+/**
+ * \internal
+ *
+ * Determines if there is a location next to a given location in a maze, in the
+ * direction of a given action.
+ *
+ * \param [in] size
+ *     The size of the maze.
+ * \param [in] location
+ *     The location.
+ * \param [in] action
+ *     The action.
+ *
+ * \returns
+ *     Whether the action stays within the maze.
+ */
+static bool has_neighbour(struct maze_size_t size, struct location_t location, enum action_t action);
+
+/**
+ * \internal
+ *
+ * Opens the wall between a location and the location next to it, in the
+ * direction of a given action, adding the action to the set of actions of the
+ * location and the reverse action to the set of actions of its neighbour.
+ *
+ * \param [in] maze
+ *     The maze.
+ * \param [in] location
+ *     The location.
+ * \param [in] action
+ *     The action, which must stay within the maze.
+ */
+static void carve_passage(struct maze_t maze, struct location_t location, enum action_t action);
+
+/**
+ * \internal
+ *
+ * Determines if a set of actions holds exactly one action, so that the location
+ * it belongs to is a dead end.
+ *
+ * \param [in] action_set
+ *     The set of actions.
+ *
+ * \returns
+ *     Whether the set holds exactly one action.
+ */
+static bool is_dead_end(unsigned int action_set);
+
+/**
+ * \internal
+ *
+ * Generates a perfect maze with the recursive backtracker algorithm.
+ *
+ * Rather than keeping a stack of the locations on the current walk, this helper
+ * function records the direction back to the previous location of the walk in
+ * a direction map, taking a quarter of a byte per location. A location has been
+ * visited once it has a passage, apart from the first location of the walk.
+ *
+ * \param [in]     maze
+ *     The maze, which must not have any passages.
+ * \param [in,out] state
+ *     A pointer to the state of the pseudo-random number generator.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int generate_backtracker(struct maze_t maze, uint64_t* state);
+
+/**
+ * \internal
+ *
+ * Generates a perfect maze with Kruskal's algorithm.
+ *
+ * Rather than shuffling an array of every wall, this helper function visits
+ * the walls in the order of a pseudo-random permutation of their indices, so
+ * that it only needs the disjoint set forest of the locations, taking four
+ * bytes per location.
+ *
+ * \param [in]     maze
+ *     The maze, which must not have any passages.
+ * \param [in,out] state
+ *     A pointer to the state of the pseudo-random number generator.
+ *
+ * \returns
+ *     -1 on failure, including when the maze has too many locations for the
+ *     forest, 0 on success.
+ */
+static int generate_kruskal(struct maze_t maze, uint64_t* state);
+
+/**
+ * \internal
+ *
+ * Generates a perfect maze with Wilson's algorithm.
+ *
+ * This helper function adds each location not yet in the maze by a random walk
+ * from it to the maze, recording the last direction taken from each location
+ * in a direction map, so that loops in the walk are erased as they are
+ * overwritten. A location is in the maze once it has a passage, apart from the
+ * first location, which starts in the maze.
+ *
+ * \param [in]     maze
+ *     The maze, which must not have any passages.
+ * \param [in,out] state
+ *     A pointer to the state of the pseudo-random number generator.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int generate_wilson(struct maze_t maze, uint64_t* state);
+
+/**
+ * \internal
+ *
+ * Removes dead ends from a maze at random by opening one of their walls.
+ *
+ * \param [in]     maze
+ *     The maze.
+ * \param [in]     braid
+ *     The percentage of dead ends to remove.
+ * \param [in,out] state
+ *     A pointer to the state of the pseudo-random number generator.
+ */
+static void braid_maze(struct maze_t maze, unsigned int braid, uint64_t* state);
+
+/**
+ * \internal
+ *
+ * Prepares the state of Eller's algorithm for a maze.
+ *
+ * \param [out] eller
+ *     A pointer to the state variable that will be initialized.
+ * \param [in]  options
+ *     The options to generate the maze with.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int make_eller(struct eller_t* eller, struct generator_options_t options);
+
+/**
+ * \internal
+ *
+ * Releases the memory held by the state of Eller's algorithm.
+ *
+ * \param [in,out] eller
+ *     A pointer to the state to free.
+ */
+static void free_eller(struct eller_t* eller);
+
+/**
+ * \internal
+ *
+ * Builds the next row of a maze with Eller's algorithm.
+ *
+ * This helper function joins neighbouring locations of the row which are in
+ * different sets at random, or always in the last row, then carries each set
+ * down into the next row at random, at least once, then braids the row.
+ *
+ * \param [in,out] eller
+ *     A pointer to the state of the algorithm, which must not have built every
+ *     row.
+ *
+ * \returns
+ *     A pointer to the sets of actions of the row, which are valid until the
+ *     next row is built.
+ */
+static const unsigned char* next_eller_row(struct eller_t* eller);
+
+/**
+ * \internal
+ *
+ * Draws a pseudo-random choice for Eller's algorithm.
+ *
+ * \param [in,out] eller
+ *     A pointer to the state of the algorithm.
+ *
+ * \returns
+ *     Either choice with equal probability.
+ */
+static bool next_eller_choice(struct eller_t* eller);
+
+/**
+ * \internal
+ *
+ * Finds the set of a column in a disjoint set forest, halving the path to it.
+ *
+ * \param [in,out] sets
+ *     The array holding the parent of each column.
+ * \param [in]     column
+ *     The column.
+ *
+ * \returns
+ *     The column naming the set.
+ */
+static size_t find_column_set(size_t* sets, size_t column);
+
+// Define generate_maze (generator.h).
+int generate_maze(struct maze_t* maze, struct generator_options_t options)
+{
+    // Assert that the pointer to the maze variable is valid.
+    assert(maze != NULL);
+    // Assert that the maze has at least one location.
+    assert(options.size.rows > 0 && options.size.columns > 0);
+
+    struct location_t start = { 0, 0 };
+    struct location_t end = { options.size.rows - 1, options.size.columns - 1 };
+
+    if (make_maze(maze, options.size, start, end) != 0) return -1;
+
+    uint64_t state = options.seed;
+    int result = -1;
+
+    switch (options.algorithm)
+    {
+        case GENERATOR_BACKTRACKER: result = generate_backtracker(*maze, &state); break;
+        case GENERATOR_KRUSKAL    : result = generate_kruskal(*maze, &state); break;
+        case GENERATOR_WILSON     : result = generate_wilson(*maze, &state); break;
+        case GENERATOR_ELLER      :
+        {
+            struct eller_t eller;
+            if (make_eller(&eller, options) != 0) break;
+
+            for (size_t row = 0; row < options.size.rows; row++)
+            {
+                set_row_action_sets(*maze, row, next_eller_row(&eller));
+            }
+
+            free_eller(&eller);
+            result = 0;
+            break;
+        }
+    }
+
+    if (result != 0)
+    {
+        free_maze(maze);
+        return -1;
+    }
+
+    // Eller's algorithm braids each row as it builds it.
+    if (options.braid > 0 && options.algorithm != GENERATOR_ELLER) braid_maze(*maze, options.braid, &state);
+
+    return 0;
+}
+
+// Define stream_maze (generator.h).
+int stream_maze(struct generator_options_t options, FILE* fp)
+{
+    // Assert that the algorithm builds the maze a row at a time.
+    assert(options.algorithm == GENERATOR_ELLER);
+    // Assert that the maze has at least one location.
+    assert(options.size.rows > 0 && options.size.columns > 0);
+    // Assert that the file handle is valid.
+    assert(fp != NULL);
+
+    struct eller_t eller;
+    if (make_eller(&eller, options) != 0) return -1;
+
+    char* buffer = (char*) malloc(options.size.columns * 3 * sizeof(char));
+    if (buffer == NULL)
+    {
+        free_eller(&eller);
+        return -1;
+    }
+
+    int result = (fprintf(fp, "%zu %zu\n0 0\n%zu %zu\n", options.size.rows, options.size.columns,
+                          options.size.rows - 1, options.size.columns - 1) < 0) ? -1 : 0;
+
+    // Write each row as soon as it is built.
+    for (size_t row = 0; row < options.size.rows && result == 0; row++)
+    {
+        result = write_maze_text_row(next_eller_row(&eller), options.size.columns, buffer, fp);
+    }
+
+    free(buffer);
+    free_eller(&eller);
+
+    return result;
+}
+
+// Define next_random (generator.c).
+static uint64_t next_random(uint64_t* state)
+{
+    uint64_t x = (*state += 0x9E3779B97F4A7C15ULL);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+
+    return x ^ (x >> 31);
+}
+
+// Define random_below (generator.c).
+static size_t random_below(uint64_t* state, size_t bound)
+{
+    return (size_t) (((next_random(state) >> 32) * (uint64_t) bound) >> 32);
+}
+
+// Define has_neighbour (generator.c).
+static bool has_neighbour(struct maze_size_t size, struct location_t location, enum action_t action)
+{
+    switch (action)
+    {
+        case EAST : return location.column + 1 < size.columns;
+        case SOUTH: return location.row + 1 < size.rows;
+        case WEST : return location.column > 0;
+        case NORTH: return location.row > 0;
+    }
+}
+
+// Define carve_passage (generator.c).
+static void carve_passage(struct maze_t maze, struct location_t location, enum action_t action)
+{
+    struct location_t neighbour = action_result(location, action);
+
+    set_action_set(maze, (enum action_set_t) (get_action_set(maze, location) | (1 << action)), location);
+    set_action_set(maze, (enum action_set_t) (get_action_set(maze, neighbour) | (1 << reverse_action(action))), neighbour);
+}
+
+// Define is_dead_end (generator.c).
+static bool is_dead_end(unsigned int action_set)
+{
+    return action_set != 0 && (action_set & (action_set - 1)) == 0;
+}
+
+// Define generate_backtracker (generator.c).
+static int generate_backtracker(struct maze_t maze, uint64_t* state)
+{
+    struct direction_map_t parents;
+    if (make_direction_map(&parents, maze.size) != 0) return -1;
+
+    struct location_t root = { 0, 0 };
+    struct location_t location = root;
+
+    for (;;)
+    {
+        // Find the neighbours which have not been visited.
+        enum action_t actions[4];
+        size_t count = 0;
+
+        for (enum action_t action = EAST; action <= NORTH; action++)
+        {
+            if (!has_neighbour(maze.size, location, action)) continue;
+
+            struct location_t neighbour = action_result(location, action);
+            if (get_action_set(maze, neighbour) == 0 && !location_equal(neighbour, root))
+            {
+                actions[count++] = action;
+            }
+        }
+
+        // Walk on to one of them at random, or back up if there are none.
+        if (count > 0)
+        {
+            enum action_t action = actions[random_below(state, count)];
+
+            carve_passage(maze, location, action);
+            location = action_result(location, action);
+            set_direction(&parents, location_index(maze.size, location), reverse_action(action));
+        }
+        else if (location_equal(location, root))
+        {
+            break;
+        }
+        else
+        {
+            location = action_result(location, get_direction(&parents, location_index(maze.size, location)));
+        }
+    }
+
+    free_direction_map(&parents);
+
+    return 0;
+}
+
+// Define generate_kruskal (generator.c).
+static int generate_kruskal(struct maze_t maze, uint64_t* state)
+{
+    size_t length = maze.size.rows * maze.size.columns;
+
+    // Indicate failure if the locations cannot be indexed by the forest.
+    if (length > UINT32_MAX) return -1;
+
+    uint32_t* sets = (uint32_t*) malloc(length * sizeof(uint32_t));
+    if (sets == NULL) return -1;
+
+    for (size_t index = 0; index < length; index++) sets[index] = (uint32_t) index;
+
+    // Each location owns the walls to its east and south, so wall 2i + 1 is the
+    // south wall of location i. The walls are visited in the order of a four
+    // round Feistel network over enough bits to index every wall, skipping the
+    // indices beyond the last wall, which keeps the order a permutation.
+    uint64_t walls = (uint64_t) length * 2;
+    unsigned int half_bits = 1;
+    while (((uint64_t) 1 << (half_bits * 2)) < walls) half_bits++;
+
+    uint64_t mask = ((uint64_t) 1 << half_bits) - 1;
+    uint64_t keys[4];
+    for (size_t round = 0; round < 4; round++) keys[round] = next_random(state);
+
+    size_t joined = 0;
+
+    for (uint64_t position = 0; position < walls && joined + 1 < length; position++)
+    {
+        uint64_t wall = position;
+
+        do
+        {
+            uint64_t left = wall >> half_bits;
+            uint64_t right = wall & mask;
+
+            for (size_t round = 0; round < 4; round++)
+            {
+                uint64_t mixed = keys[round] ^ right;
+                uint64_t next = left ^ (next_random(&mixed) & mask);
+                left = right;
+                right = next;
+            }
+
+            wall = (left << half_bits) | right;
+        }
+        while (wall >= walls);
+
+        size_t index = (size_t) (wall / 2);
+        enum action_t action = (wall & 1) ? SOUTH : EAST;
+        struct location_t location = { index / maze.size.columns, index % maze.size.columns };
+
+        if (!has_neighbour(maze.size, location, action)) continue;
+
+        // Open the wall if it separates two sets, then join them.
+        size_t a = index;
+        size_t b = location_index(maze.size, action_result(location, action));
+
+        while (sets[a] != a) a = sets[a] = sets[sets[a]];
+        while (sets[b] != b) b = sets[b] = sets[sets[b]];
+        if (a == b) continue;
+
+        carve_passage(maze, location, action);
+        if (next_random(state) & 1) sets[a] = (uint32_t) b;
+        else sets[b] = (uint32_t) a;
+        joined++;
+    }
+
+    free(sets);
+
+    return 0;
+}
+
+// Define generate_wilson (generator.c).
+static int generate_wilson(struct maze_t maze, uint64_t* state)
+{
+    struct direction_map_t walk;
+    if (make_direction_map(&walk, maze.size) != 0) return -1;
+
+    struct location_t root = { 0, 0 };
+    size_t length = maze.size.rows * maze.size.columns;
+
+    for (size_t index = 1; index < length; index++)
+    {
+        struct location_t first = { index / maze.size.columns, index % maze.size.columns };
+        if (get_action_set(maze, first) != 0) continue;
+
+        // Walk at random until the walk reaches the maze.
+        struct location_t location = first;
+        while (get_action_set(maze, location) == 0 && !location_equal(location, root))
+        {
+            enum action_t action;
+            do action = (enum action_t) random_below(state, 4);
+            while (!has_neighbour(maze.size, location, action));
+
+            set_direction(&walk, location_index(maze.size, location), action);
+            location = action_result(location, action);
+        }
+
+        // Follow the last direction taken from each location, which skips any
+        // loops, to carve the walk into the maze.
+        struct location_t reached = location;
+        for (location = first; !location_equal(location, reached);)
+        {
+            enum action_t action = get_direction(&walk, location_index(maze.size, location));
+            carve_passage(maze, location, action);
+            location = action_result(location, action);
+        }
+    }
+
+    free_direction_map(&walk);
+
+    return 0;
+}
+
+// Define braid_maze (generator.c).
+static void braid_maze(struct maze_t maze, unsigned int braid, uint64_t* state)
+{
+    for (size_t row = 0; row < maze.size.rows; row++)
+    {
+        for (size_t column = 0; column < maze.size.columns; column++)
+        {
+            struct location_t location = { row, column };
+            enum action_set_t action_set = get_action_set(maze, location);
+
+            if (!is_dead_end(action_set) || random_below(state, 100) >= braid) continue;
+
+            // Open one of the walls of the dead end at random.
+            enum action_t actions[4];
+            size_t count = 0;
+
+            for (enum action_t action = EAST; action <= NORTH; action++)
+            {
+                if (!(action_set & (1 << action)) && has_neighbour(maze.size, location, action))
+                {
+                    actions[count++] = action;
+                }
+            }
+
+            if (count > 0) carve_passage(maze, location, actions[random_below(state, count)]);
+        }
+    }
+}
+
+// Define make_eller (generator.c).
+static int make_eller(struct eller_t* eller, struct generator_options_t options)
+{
+    size_t columns = options.size.columns;
+
+    eller->rows = options.size.rows;
+    eller->columns = columns;
+    eller->row = 0;
+    eller->sets = (size_t*) malloc(columns * sizeof(size_t));
+    eller->next_sets = (size_t*) malloc(columns * sizeof(size_t));
+    eller->carried = (size_t*) malloc(columns * sizeof(size_t));
+    eller->action_sets = (unsigned char*) calloc(columns, sizeof(unsigned char));
+    eller->next_action_sets = (unsigned char*) calloc(columns, sizeof(unsigned char));
+    eller->state = options.seed;
+    eller->bits = 0;
+    eller->bits_left = 0;
+    eller->braid = options.braid;
+
+    if (eller->sets == NULL || eller->next_sets == NULL || eller->carried == NULL
+     || eller->action_sets == NULL || eller->next_action_sets == NULL)
+    {
+        free_eller(eller);
+        return -1;
+    }
+
+    // Begin with every location of the first row in a set of its own.
+    for (size_t column = 0; column < columns; column++) eller->sets[column] = column;
+
+    return 0;
+}
+
+// Define free_eller (generator.c).
+static void free_eller(struct eller_t* eller)
+{
+    free(eller->next_action_sets);
+    free(eller->action_sets);
+    free(eller->carried);
+    free(eller->next_sets);
+    free(eller->sets);
+}
+
+// Define next_eller_row (generator.c).
+static const unsigned char* next_eller_row(struct eller_t* eller)
+{
+    size_t columns = eller->columns;
+
+    // Move on to the row below the last row built, if there is one.
+    if (eller->row > 0)
+    {
+        unsigned char* action_sets = eller->action_sets;
+        eller->action_sets = eller->next_action_sets;
+        eller->next_action_sets = action_sets;
+        memset(eller->next_action_sets, 0, columns);
+
+        size_t* sets = eller->sets;
+        eller->sets = eller->next_sets;
+        eller->next_sets = sets;
+    }
+
+    bool last = ++eller->row == eller->rows;
+    unsigned char* action_sets = eller->action_sets;
+    size_t* sets = eller->sets;
+
+    // Join neighbouring locations of different sets at random, or always in
+    // the last row, so that every set ends up connected.
+    for (size_t column = 0; column + 1 < columns; column++)
+    {
+        size_t a = find_column_set(sets, column);
+        size_t b = find_column_set(sets, column + 1);
+        if (a == b || (!last && next_eller_choice(eller))) continue;
+
+        action_sets[column] |= EAST_FLAG;
+        action_sets[column + 1] |= WEST_FLAG;
+        sets[b] = a;
+    }
+
+    // Carry each set down at random, then make sure that every set is carried
+    // down at least once, from its rightmost location.
+    if (!last)
+    {
+        size_t* carried = eller->carried;
+        for (size_t column = 0; column < columns; column++) carried[column] = SIZE_MAX;
+
+        for (size_t column = 0; column < columns; column++)
+        {
+            if (next_eller_choice(eller)) continue;
+
+            action_sets[column] |= SOUTH_FLAG;
+            carried[find_column_set(sets, column)] = column;
+        }
+
+        for (size_t column = columns; column-- > 0;)
+        {
+            size_t set = find_column_set(sets, column);
+            if (carried[set] != SIZE_MAX) continue;
+
+            action_sets[column] |= SOUTH_FLAG;
+            carried[set] = column;
+        }
+    }
+
+    // Open a wall of dead ends at random, but never to the north, as that row
+    // may already have been written.
+    for (size_t column = 0; column < columns && eller->braid > 0; column++)
+    {
+        if (!is_dead_end(action_sets[column]) || random_below(&eller->state, 100) >= eller->braid) continue;
+
+        enum action_t actions[3];
+        size_t count = 0;
+
+        if (column + 1 < columns && !(action_sets[column] & EAST_FLAG)) actions[count++] = EAST;
+        if (column > 0 && !(action_sets[column] & WEST_FLAG)) actions[count++] = WEST;
+        if (!last && !(action_sets[column] & SOUTH_FLAG)) actions[count++] = SOUTH;
+        if (count == 0) continue;
+
+        enum action_t action = actions[random_below(&eller->state, count)];
+        size_t neighbour = (action == EAST) ? column + 1 : column - 1;
+
+        if (action == SOUTH)
+        {
+            action_sets[column] |= SOUTH_FLAG;
+            continue;
+        }
+
+        action_sets[column] |= (unsigned char) (1 << action);
+        action_sets[neighbour] |= (unsigned char) (1 << reverse_action(action));
+        sets[find_column_set(sets, neighbour)] = find_column_set(sets, column);
+    }
+
+    // Place each location of the next row reached from above in the set of the
+    // leftmost such location of the same set, and every other location in a new
+    // set of its own.
+    if (!last)
+    {
+        size_t* carried = eller->carried;
+        for (size_t column = 0; column < columns; column++) carried[column] = SIZE_MAX;
+
+        for (size_t column = 0; column < columns; column++)
+        {
+            eller->next_sets[column] = column;
+            if (!(action_sets[column] & SOUTH_FLAG)) continue;
+
+            eller->next_action_sets[column] |= NORTH_FLAG;
+
+            size_t set = find_column_set(sets, column);
+            if (carried[set] == SIZE_MAX) carried[set] = column;
+            eller->next_sets[column] = carried[set];
+        }
+    }
+
+    return action_sets;
+}
+
+// Define next_eller_choice (generator.c).
+static bool next_eller_choice(struct eller_t* eller)
+{
+    if (eller->bits_left == 0)
+    {
+        eller->bits = next_random(&eller->state);
+        eller->bits_left = 64;
+    }
+
+    bool choice = eller->bits & 1;
+    eller->bits >>= 1;
+    eller->bits_left--;
+
+    return choice;
+}
+
+// Define find_column_set (generator.c).
+static size_t find_column_set(size_t* sets, size_t column)
+{
+    while (sets[column] != column)
+    {
+        sets[column] = sets[sets[column]];
+        column = sets[column];
+    }
+
+    return column;
+}
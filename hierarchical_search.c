@@ -0,0 +1,1079 @@
+#include "hierarchical_search.h"
+
+#include "action.h"
+#include "action_set.h"
+#include "node.h"
+#include "node_list.h"
+#include "node_queue.h"
+#include "maze.h"
+#include "stats.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/**
+ * \internal
+ *
+ * Represents the locations covered by a cluster.
+ *
+ * This struct contains the row and column of the top left location of the
+ * cluster, along with its number of rows and columns.
+ */
+struct cluster_bounds_t
+{
+    size_t row;
+    size_t column;
+    size_t rows;
+    size_t columns;
+};
+
+/**
+ * \internal
+ *
+ * Represents the buffers used to search a single cluster.
+ *
+ * This struct contains the number of actions taken to reach each location of
+ * the cluster, in row-major order within the cluster, which is UINT32_MAX for
+ * locations not reached, and the queue of locations to expand, each of which
+ * has space for every location of a cluster.
+ */
+struct cluster_search_t
+{
+    uint32_t* distances;
+    uint32_t* queue;
+};
+
+/**
+ * \internal
+ *
+ * Represents the results of processing a single cluster while making a cluster
+ * graph, which are gathered into the graph once every cluster is processed.
+ *
+ * This struct contains the location indexes of the entrances of the cluster,
+ * the edges leaving them, one entrance after another, and the number of edges
+ * leaving each entrance.
+ */
+struct cluster_work_t
+{
+    uint32_t* entrances;
+    size_t entrance_count;
+    struct cluster_edge_t* edges;
+    size_t edge_count;
+    size_t edge_capacity;
+    size_t* degrees;
+};
+
+/**
+ * \internal
+ *
+ * Represents a step of making a cluster graph which processes every cluster
+ * independently.
+ */
+enum build_step_t
+{
+    FIND_ENTRANCES,
+    CONNECT_ENTRANCES
+};
+
+/**
+ * \internal
+ *
+ * Represents the state shared by every thread making a cluster graph.
+ *
+ * This struct contains the graph being made, the maze it is made from, the
+ * results of processing each cluster, the step being taken, the next cluster
+ * to process, which each thread takes in turn, and whether any thread failed.
+ */
+struct cluster_builder_t
+{
+    struct cluster_graph_t* graph;
+    struct maze_t maze;
+    struct cluster_work_t* work;
+    enum build_step_t step;
+    atomic_size_t next;
+    atomic_bool failed;
+};
+
+/**
+ * \internal
+ *
+ * Represents the state of an entrance during a search of a cluster graph.
+ *
+ * This struct contains the number of actions taken to reach the entrance plus
+ * one, so that zero indicates that the entrance has not been reached, and the
+ * entrance it was reached from.
+ */
+struct entrance_state_t
+{
+    size_t cost;
+    size_t parent;
+};
+
+/**
+ * \internal
+ *
+ * Gets the locations covered by a cluster of a cluster graph.
+ *
+ * \param [in] graph
+ *     A pointer to the cluster graph.
+ * \param [in] cluster
+ *     The index of the cluster, in row-major order of the clusters.
+ *
+ * \returns
+ *     The bounds of the cluster.
+ */
+static struct cluster_bounds_t get_cluster_bounds(const struct cluster_graph_t* graph, size_t cluster);
+
+/**
+ * \internal
+ *
+ * Gets the cluster of a cluster graph containing a given location.
+ *
+ * \param [in] graph
+ *     A pointer to the cluster graph.
+ * \param [in] location
+ *     The location within the maze of the graph.
+ *
+ * \returns
+ *     The index of the cluster, in row-major order of the clusters.
+ */
+static size_t get_cluster(const struct cluster_graph_t* graph, struct location_t location);
+
+/**
+ * \internal
+ *
+ * Gets the location of an entrance of a cluster graph.
+ *
+ * \param [in] graph
+ *     A pointer to the cluster graph.
+ * \param [in] entrance
+ *     The index of the entrance in the graph.
+ *
+ * \returns
+ *     The location of the entrance.
+ */
+static struct location_t entrance_location(const struct cluster_graph_t* graph, size_t entrance);
+
+/**
+ * \internal
+ *
+ * Determines if a location is within a cluster.
+ *
+ * \param [in] bounds
+ *     The bounds of the cluster.
+ * \param [in] location
+ *     The location to check, which may be outside the maze.
+ *
+ * \returns
+ *     Whether the location is within the cluster.
+ */
+static bool within_cluster(struct cluster_bounds_t bounds, struct location_t location);
+
+/**
+ * \internal
+ *
+ * Gets the index of a location within a cluster.
+ *
+ * \param [in] bounds
+ *     The bounds of the cluster.
+ * \param [in] location
+ *     The location within the cluster.
+ *
+ * \returns
+ *     The index of the location in row-major order within the cluster.
+ */
+static size_t cluster_index(struct cluster_bounds_t bounds, struct location_t location);
+
+/**
+ * \internal
+ *
+ * Creates the buffers used to search clusters of a given size.
+ *
+ * \param [out] search
+ *     A pointer to the cluster search variable that will be initialized.
+ * \param [in]  cluster_size
+ *     The number of rows and columns of each cluster.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int make_cluster_search(struct cluster_search_t* search, size_t cluster_size);
+
+/**
+ * \internal
+ *
+ * Releases the memory held by the buffers used to search clusters.
+ *
+ * \param [in,out] search
+ *     A pointer to the cluster search to free.
+ */
+static void free_cluster_search(struct cluster_search_t* search);
+
+/**
+ * \internal
+ *
+ * Searches a cluster from a given location using breadth-first search.
+ *
+ * This helper function finds the fewest actions taken to reach every location
+ * of the cluster from the given location without leaving the cluster, or, if
+ * searching into the location, the fewest actions taken to reach the given
+ * location from every location of the cluster. The two only differ where a
+ * passage leads one way.
+ *
+ * \param [in]     maze
+ *     The maze containing the cluster.
+ * \param [in]     bounds
+ *     The bounds of the cluster.
+ * \param [in]     source
+ *     The location within the cluster to search from.
+ * \param [in]     into
+ *     Whether to follow the actions leading into each location, rather than
+ *     those leading out of it.
+ * \param [in,out] search
+ *     A pointer to the buffers to search with, which will contain the number
+ *     of actions taken to reach each location.
+ */
+static void search_cluster(struct maze_t maze, struct cluster_bounds_t bounds, struct location_t source, bool into, struct cluster_search_t* search);
+
+/**
+ * \internal
+ *
+ * Finds the entrances of a cluster.
+ *
+ * \param [in]     graph
+ *     A pointer to the cluster graph being made.
+ * \param [in]     maze
+ *     The maze the graph is made from.
+ * \param [in]     cluster
+ *     The index of the cluster.
+ * \param [in,out] work
+ *     A pointer to the results of processing the cluster, which will contain
+ *     its entrances.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int find_cluster_entrances(const struct cluster_graph_t* graph, struct maze_t maze, size_t cluster, struct cluster_work_t* work);
+
+/**
+ * \internal
+ *
+ * Connects the entrances of a cluster to the entrances they can reach within
+ * the cluster, and to the entrances of the neighbouring clusters they lead
+ * into.
+ *
+ * \param [in]     graph
+ *     A pointer to the cluster graph being made, whose entrances have been
+ *     gathered.
+ * \param [in]     maze
+ *     The maze the graph is made from.
+ * \param [in]     cluster
+ *     The index of the cluster.
+ * \param [in,out] work
+ *     A pointer to the results of processing the cluster, which will contain
+ *     the edges leaving its entrances.
+ * \param [in,out] search
+ *     A pointer to the buffers to search the cluster with.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int connect_cluster_entrances(const struct cluster_graph_t* graph, struct maze_t maze, size_t cluster, struct cluster_work_t* work, struct cluster_search_t* search);
+
+/**
+ * \internal
+ *
+ * Adds an edge to the results of processing a cluster.
+ *
+ * This helper function attempts to append the given edge, doubling the
+ * capacity of the edges if they are full.
+ *
+ * \param [in,out] work
+ *     A pointer to the results of processing the cluster.
+ * \param [in]     edge
+ *     The edge to add.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int add_cluster_edge(struct cluster_work_t* work, struct cluster_edge_t edge);
+
+/**
+ * \internal
+ *
+ * Takes the current step of making a cluster graph on a single thread.
+ *
+ * This helper function repeatedly takes the next cluster which no thread has
+ * taken and processes it, until every cluster has been taken or a thread has
+ * failed.
+ *
+ * \param [in,out] arg
+ *     A pointer to the shared cluster builder.
+ *
+ * \returns
+ *     NULL.
+ */
+static void* run_builder(void* arg);
+
+/**
+ * \internal
+ *
+ * Takes the current step of making a cluster graph on a given number of
+ * threads, including the calling thread, waiting for every thread to finish.
+ *
+ * \param [in,out] builder
+ *     A pointer to the shared cluster builder.
+ * \param [in]     threads
+ *     The number of threads to use.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int run_builders(struct cluster_builder_t* builder, size_t threads);
+
+/**
+ * \internal
+ *
+ * Pushes an entrance onto the frontier of a search of a cluster graph if it is
+ * reached sooner than it has been before.
+ *
+ * \param [in,out] frontier
+ *     A pointer to the frontier of the search.
+ * \param [in,out] states
+ *     A pointer to the array holding the state of every entrance.
+ * \param [in]     parent
+ *     The entrance the entrance is reached from.
+ * \param [in]     entrance
+ *     The entrance reached.
+ * \param [in]     cost
+ *     The number of actions taken to reach the entrance plus one.
+ * \param [in]     location
+ *     The location of the entrance.
+ * \param [in]     goal
+ *     The location the search is heading for.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int reach_entrance(struct node_queue_t* frontier, struct entrance_state_t* states, size_t parent, size_t entrance, size_t cost, struct location_t location, struct location_t goal);
+
+/**
+ * \internal
+ *
+ * Appends the path found by a search of a cluster graph to a node list.
+ *
+ * This helper function follows the entrances on the path from the start of the
+ * maze, searching the cluster of each edge within a cluster to find the
+ * locations along it, then appends a node for every location in reverse order,
+ * such that the final node in the list will be the start.
+ *
+ * \param [in,out] list
+ *     A pointer to the node list to append the path to.
+ * \param [in]     maze
+ *     The maze containing the path.
+ * \param [in]     graph
+ *     A pointer to the cluster graph of the maze.
+ * \param [in]     states
+ *     A pointer to the array holding the state of every entrance, followed by
+ *     the states of the start and the end.
+ * \param [in,out] search
+ *     A pointer to the buffers to search clusters with.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int append_cluster_path(struct node_list_t* list, struct maze_t maze, const struct cluster_graph_t* graph, const struct entrance_state_t* states, struct cluster_search_t* search);
+
+// Define make_cluster_graph (hierarchical_search.h).
+int make_cluster_graph(struct cluster_graph_t* graph, struct maze_t maze, size_t cluster_size, size_t threads)
+{
+    // Assert that the pointer to the cluster graph variable is valid.
+    assert(graph != NULL);
+    // Assert that the clusters have locations and there is a thread to use.
+    assert(cluster_size > 0 && threads > 0);
+
+    // Indicate failure if the locations cannot be indexed with 32 bits.
+    if (maze.size.rows * maze.size.columns > UINT32_MAX) return -1;
+
+    *graph = (struct cluster_graph_t)
+    {
+        .cluster_size = cluster_size,
+        .cluster_rows = (maze.size.rows + cluster_size - 1) / cluster_size,
+        .cluster_columns = (maze.size.columns + cluster_size - 1) / cluster_size,
+        .size = maze.size
+    };
+
+    size_t cluster_count = graph->cluster_rows * graph->cluster_columns;
+    struct cluster_work_t* work = (struct cluster_work_t*) calloc(cluster_count, sizeof(struct cluster_work_t));
+    if (work == NULL) return -1;
+
+    struct cluster_builder_t builder = { .graph = graph, .maze = maze, .work = work, .step = FIND_ENTRANCES };
+    atomic_init(&builder.next, 0);
+    atomic_init(&builder.failed, false);
+
+    int result = run_builders(&builder, threads);
+
+    // Gather the entrances of every cluster, so that the entrances of the
+    // neighbouring clusters can be found while connecting them.
+    if (result == 0)
+    {
+        graph->clusters = (size_t*) malloc((cluster_count + 1) * sizeof(size_t));
+
+        for (size_t cluster = 0; cluster < cluster_count; cluster++) graph->entrance_count += work[cluster].entrance_count;
+
+        graph->entrances = (uint32_t*) malloc(graph->entrance_count * sizeof(uint32_t));
+
+        if (graph->clusters == NULL || (graph->entrances == NULL && graph->entrance_count != 0)) result = -1;
+    }
+
+    if (result == 0)
+    {
+        size_t position = 0;
+        for (size_t cluster = 0; cluster < cluster_count; cluster++)
+        {
+            graph->clusters[cluster] = position;
+
+            if (work[cluster].entrance_count == 0) continue;
+
+            memcpy(graph->entrances + position, work[cluster].entrances, work[cluster].entrance_count * sizeof(uint32_t));
+            position += work[cluster].entrance_count;
+        }
+
+        graph->clusters[cluster_count] = position;
+
+        builder.step = CONNECT_ENTRANCES;
+        result = run_builders(&builder, threads);
+    }
+
+    // Gather the edges leaving every entrance.
+    if (result == 0)
+    {
+        graph->offsets = (size_t*) malloc((graph->entrance_count + 1) * sizeof(size_t));
+
+        for (size_t cluster = 0; cluster < cluster_count; cluster++) graph->edge_count += work[cluster].edge_count;
+
+        graph->edges = (struct cluster_edge_t*) malloc(graph->edge_count * sizeof(struct cluster_edge_t));
+
+        if (graph->offsets == NULL || (graph->edges == NULL && graph->edge_count != 0)) result = -1;
+    }
+
+    if (result == 0)
+    {
+        size_t entrance = 0;
+        size_t position = 0;
+
+        for (size_t cluster = 0; cluster < cluster_count; cluster++)
+        {
+            for (size_t local = 0; local < work[cluster].entrance_count; local++)
+            {
+                graph->offsets[entrance++] = position;
+                position += work[cluster].degrees[local];
+            }
+
+            if (work[cluster].edge_count == 0) continue;
+
+            memcpy(graph->edges + graph->offsets[entrance - work[cluster].entrance_count], work[cluster].edges,
+                   work[cluster].edge_count * sizeof(struct cluster_edge_t));
+        }
+
+        graph->offsets[entrance] = position;
+    }
+
+    for (size_t cluster = 0; cluster < cluster_count; cluster++)
+    {
+        free(work[cluster].degrees);
+        free(work[cluster].edges);
+        free(work[cluster].entrances);
+    }
+
+    free(work);
+
+    if (result != 0) free_cluster_graph(graph);
+
+    return result;
+}
+
+// Define free_cluster_graph (hierarchical_search.h).
+void free_cluster_graph(struct cluster_graph_t* graph)
+{
+    // Assert that the pointer to the cluster graph variable is valid.
+    assert(graph != NULL);
+
+    free(graph->edges);
+    free(graph->offsets);
+    free(graph->clusters);
+    free(graph->entrances);
+
+    graph->entrances = NULL;
+    graph->clusters = NULL;
+    graph->offsets = NULL;
+    graph->edges = NULL;
+    graph->entrance_count = 0;
+    graph->edge_count = 0;
+}
+
+// Define find_entrance (hierarchical_search.h).
+bool find_entrance(const struct cluster_graph_t* graph, struct location_t location, size_t* entrance)
+{
+    // Assert that the pointer to the cluster graph variable is valid.
+    assert(graph != NULL);
+    // Assert that the pointer to the entrance variable is valid.
+    assert(entrance != NULL);
+
+    size_t cluster = get_cluster(graph, location);
+    uint32_t index = (uint32_t) location_index(graph->size, location);
+
+    // Find the first entrance of the cluster with an index no less than the
+    // given index.
+    size_t low = graph->clusters[cluster];
+    size_t high = graph->clusters[cluster + 1];
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+
+        if (graph->entrances[middle] < index) low = middle + 1;
+        else high = middle;
+    }
+
+    *entrance = low;
+
+    return low < graph->clusters[cluster + 1] && graph->entrances[low] == index;
+}
+
+// Define solve_cluster_graph (hierarchical_search.h).
+int solve_cluster_graph(struct node_list_t* list, struct maze_t maze, const struct cluster_graph_t* graph, struct search_stats_t* stats)
+{
+    // Assert that the pointer to the node list variable is valid.
+    assert(list != NULL);
+    // Assert that the pointer to the cluster graph variable is valid.
+    assert(graph != NULL);
+
+    // The start and the end are given the indexes after the entrances.
+    size_t start = graph->entrance_count;
+    size_t end = graph->entrance_count + 1;
+
+    // Search the clusters of the start and the end, to find which entrances of
+    // their clusters they can reach.
+    struct cluster_search_t start_search;
+    struct cluster_search_t end_search;
+    if (make_cluster_search(&start_search, graph->cluster_size) != 0) return -1;
+    if (make_cluster_search(&end_search, graph->cluster_size) != 0)
+    {
+        free_cluster_search(&start_search);
+        return -1;
+    }
+
+    size_t start_cluster = get_cluster(graph, maze.start);
+    size_t end_cluster = get_cluster(graph, maze.end);
+    struct cluster_bounds_t start_bounds = get_cluster_bounds(graph, start_cluster);
+    struct cluster_bounds_t end_bounds = get_cluster_bounds(graph, end_cluster);
+
+    // The path leads from the end, so the entrances must lead into the start,
+    // but out of the end.
+    search_cluster(maze, start_bounds, maze.start, true, &start_search);
+    search_cluster(maze, end_bounds, maze.end, false, &end_search);
+
+    // Create the array that will contain the state of every entrance, which is
+    // initially zero as no entrances are reached.
+    struct entrance_state_t* states = (struct entrance_state_t*) calloc(graph->entrance_count + 2, sizeof(struct entrance_state_t));
+
+    // Create the queue that will contain all entrances in the frontier, each of
+    // which is given the location in a single row whose column is its index.
+    struct node_queue_t frontier;
+    if (states == NULL || make_queue(&frontier, (struct maze_size_t) { 1, graph->entrance_count + 2 }, 64) != 0)
+    {
+        free(states);
+        free_cluster_search(&end_search);
+        free_cluster_search(&start_search);
+        return -1;
+    }
+
+    // Push the end onto the frontier, which is reached by taking no actions, as
+    // this implementation works backwards.
+    struct node_t node = { { 0, end }, NULL };
+    states[end].cost = 1;
+    int result = push_node(&frontier, &node, location_manhattan(maze.end, maze.start));
+
+    size_t expansions = 0;
+    bool found = false;
+
+    while (result == 0 && frontier.length > 0)
+    {
+        // Get the next entrance to expand.
+        pop_node(&frontier, &node);
+        size_t entrance = node.location.column;
+        size_t cost = states[entrance].cost;
+        expansions++;
+
+        // If the entrance is the start, the search is complete.
+        if (entrance == start)
+        {
+            found = true;
+            break;
+        }
+
+        if (entrance == end)
+        {
+            // The end leads to the entrances of its cluster that it can reach,
+            // and to the start if it is in the same cluster.
+            for (size_t other = graph->clusters[end_cluster]; result == 0 && other < graph->clusters[end_cluster + 1]; other++)
+            {
+                struct location_t location = entrance_location(graph, other);
+                uint32_t distance = end_search.distances[cluster_index(end_bounds, location)];
+
+                if (distance == UINT32_MAX) continue;
+
+                result = reach_entrance(&frontier, states, end, other, cost + distance, location, maze.start);
+            }
+
+            if (result == 0 && start_cluster == end_cluster)
+            {
+                uint32_t distance = end_search.distances[cluster_index(end_bounds, maze.start)];
+                if (distance != UINT32_MAX) result = reach_entrance(&frontier, states, end, start, cost + distance, maze.start, maze.start);
+            }
+
+            continue;
+        }
+
+        // Push the entrances reached by the edges leaving this entrance.
+        for (size_t position = graph->offsets[entrance]; result == 0 && position < graph->offsets[entrance + 1]; position++)
+        {
+            struct cluster_edge_t edge = graph->edges[position];
+            result = reach_entrance(&frontier, states, entrance, edge.target, cost + edge.cost, entrance_location(graph, edge.target), maze.start);
+        }
+
+        // The entrances of the cluster of the start lead to the start if they
+        // can reach it.
+        struct location_t location = entrance_location(graph, entrance);
+        if (result == 0 && get_cluster(graph, location) == start_cluster)
+        {
+            uint32_t distance = start_search.distances[cluster_index(start_bounds, location)];
+            if (distance != UINT32_MAX) result = reach_entrance(&frontier, states, entrance, start, cost + distance, maze.start, maze.start);
+        }
+    }
+
+    // Record the work done, where entrances rather than locations are counted.
+    if (stats != NULL)
+    {
+        stats->recorded = true;
+        stats->expansions = expansions;
+        stats->pushes = frontier.order + frontier.merges;
+        stats->duplicate_pushes = frontier.merges;
+        stats->frontier_peak = frontier.peak_length;
+    }
+
+    free_queue(&frontier);
+    free_cluster_search(&end_search);
+
+    // If the start of the maze was reached, refine the path through each
+    // cluster.
+    if (result == 0) result = found ? append_cluster_path(list, maze, graph, states, &start_search) : -1;
+
+    free(states);
+    free_cluster_search(&start_search);
+
+    return result;
+}
+
+// Define solve_maze_hierarchical (hierarchical_search.h).
+int solve_maze_hierarchical(struct node_list_t* list, struct maze_t maze, size_t cluster_size, size_t threads, struct search_stats_t* stats)
+{
+    // Assert that the pointer to the node list variable is valid.
+    assert(list != NULL);
+
+    struct cluster_graph_t graph;
+    if (make_cluster_graph(&graph, maze, cluster_size, threads) != 0) return -1;
+
+    int result = solve_cluster_graph(list, maze, &graph, stats);
+
+    free_cluster_graph(&graph);
+
+    return result;
+}
+
+// Define get_cluster_bounds (hierarchical_search.c).
+static struct cluster_bounds_t get_cluster_bounds(const struct cluster_graph_t* graph, size_t cluster)
+{
+    size_t row = (cluster / graph->cluster_columns) * graph->cluster_size;
+    size_t column = (cluster % graph->cluster_columns) * graph->cluster_size;
+
+    return (struct cluster_bounds_t)
+    {
+        row,
+        column,
+        (graph->size.rows - row < graph->cluster_size) ? graph->size.rows - row : graph->cluster_size,
+        (graph->size.columns - column < graph->cluster_size) ? graph->size.columns - column : graph->cluster_size
+    };
+}
+
+// Define get_cluster (hierarchical_search.c).
+static size_t get_cluster(const struct cluster_graph_t* graph, struct location_t location)
+{
+    return (location.row / graph->cluster_size) * graph->cluster_columns + location.column / graph->cluster_size;
+}
+
+// Define entrance_location (hierarchical_search.c).
+static struct location_t entrance_location(const struct cluster_graph_t* graph, size_t entrance)
+{
+    uint32_t index = graph->entrances[entrance];
+
+    return (struct location_t) { index / graph->size.columns, index % graph->size.columns };
+}
+
+// Define within_cluster (hierarchical_search.c).
+static bool within_cluster(struct cluster_bounds_t bounds, struct location_t location)
+{
+    // A location before the cluster wraps around to beyond it.
+    return location.row - bounds.row < bounds.rows && location.column - bounds.column < bounds.columns;
+}
+
+// Define cluster_index (hierarchical_search.c).
+static size_t cluster_index(struct cluster_bounds_t bounds, struct location_t location)
+{
+    return (location.row - bounds.row) * bounds.columns + (location.column - bounds.column);
+}
+
+// Define make_cluster_search (hierarchical_search.c).
+static int make_cluster_search(struct cluster_search_t* search, size_t cluster_size)
+{
+    search->distances = (uint32_t*) malloc(cluster_size * cluster_size * sizeof(uint32_t));
+    search->queue = (uint32_t*) malloc(cluster_size * cluster_size * sizeof(uint32_t));
+
+    if (search->distances == NULL || search->queue == NULL)
+    {
+        free_cluster_search(search);
+        return -1;
+    }
+
+    return 0;
+}
+
+// Define free_cluster_search (hierarchical_search.c).
+static void free_cluster_search(struct cluster_search_t* search)
+{
+    free(search->queue);
+    free(search->distances);
+
+    search->distances = NULL;
+    search->queue = NULL;
+}
+
+// Define search_cluster (hierarchical_search.c).
+static void search_cluster(struct maze_t maze, struct cluster_bounds_t bounds, struct location_t source, bool into, struct cluster_search_t* search)
+{
+    memset(search->distances, 0xFF, bounds.rows * bounds.columns * sizeof(uint32_t));
+
+    size_t head = 0;
+    size_t tail = 0;
+
+    search->distances[cluster_index(bounds, source)] = 0;
+    search->queue[tail++] = (uint32_t) cluster_index(bounds, source);
+
+    while (head < tail)
+    {
+        uint32_t index = search->queue[head++];
+        struct location_t location = { bounds.row + index / bounds.columns, bounds.column + index % bounds.columns };
+
+        // Get the set of actions available for the location.
+        enum action_set_t action_set = get_action_set(maze, location);
+
+        for (enum action_t action = EAST; action <= NORTH; action++)
+        {
+            // Check that the location in the direction of the action is within
+            // the cluster.
+            struct location_t child = action_result(location, action);
+            if (!within_cluster(bounds, child)) continue;
+
+            // Check if the action is contained in the set of actions, or if
+            // searching into the source, that the location has an action
+            // leading back.
+            if (into && !(get_action_set(maze, child) & (1 << reverse_action(action)))) continue;
+            if (!into && !(action_set & (1 << action))) continue;
+
+            // Check that the location has not already been reached.
+
+            size_t child_index = cluster_index(bounds, child);
+            if (search->distances[child_index] != UINT32_MAX) continue;
+
+            search->distances[child_index] = search->distances[index] + 1;
+            search->queue[tail++] = (uint32_t) child_index;
+        }
+    }
+}
+
+// Define find_cluster_entrances (hierarchical_search.c).
+static int find_cluster_entrances(const struct cluster_graph_t* graph, struct maze_t maze, size_t cluster, struct cluster_work_t* work)
+{
+    struct cluster_bounds_t bounds = get_cluster_bounds(graph, cluster);
+
+    // Only the locations around the border of the cluster can be entrances.
+    work->entrances = (uint32_t*) malloc(2 * (bounds.rows + bounds.columns) * sizeof(uint32_t));
+    if (work->entrances == NULL) return -1;
+
+    for (size_t row = 0; row < bounds.rows; row++)
+    {
+        // Visit every column of the first and last rows, but only the first
+        // and last columns of the other rows, in ascending order of index.
+        bool edge_row = row == 0 || row == bounds.rows - 1 || bounds.columns == 1;
+        size_t stride = edge_row ? 1 : bounds.columns - 1;
+
+        for (size_t column = 0; column < bounds.columns; column += stride)
+        {
+            struct location_t location = { bounds.row + row, bounds.column + column };
+            enum action_set_t action_set = get_action_set(maze, location);
+
+            for (enum action_t action = EAST; action <= NORTH; action++)
+            {
+                struct location_t next = action_result(location, action);
+                if (within_cluster(bounds, next) || !check_location(maze.size, next)) continue;
+
+                // The location is an entrance if an action leads between it and
+                // the other cluster either way.
+                bool leaves = action_set & (1 << action);
+                bool enters = get_action_set(maze, next) & (1 << reverse_action(action));
+                if (!leaves && !enters) continue;
+
+                work->entrances[work->entrance_count++] = (uint32_t) location_index(maze.size, location);
+                break;
+            }
+        }
+    }
+
+    return 0;
+}
+
+// Define connect_cluster_entrances (hierarchical_search.c).
+static int connect_cluster_entrances(const struct cluster_graph_t* graph, struct maze_t maze, size_t cluster, struct cluster_work_t* work, struct cluster_search_t* search)
+{
+    if (work->entrance_count == 0) return 0;
+
+    work->degrees = (size_t*) calloc(work->entrance_count, sizeof(size_t));
+    if (work->degrees == NULL) return -1;
+
+    struct cluster_bounds_t bounds = get_cluster_bounds(graph, cluster);
+    size_t first = graph->clusters[cluster];
+
+    for (size_t local = 0; local < work->entrance_count; local++)
+    {
+        size_t count = work->edge_count;
+        struct location_t location = entrance_location(graph, first + local);
+
+        // Connect the entrance to every other entrance it can reach within the
+        // cluster.
+        search_cluster(maze, bounds, location, false, search);
+
+        for (size_t other = 0; other < work->entrance_count; other++)
+        {
+            uint32_t distance = search->distances[cluster_index(bounds, entrance_location(graph, first + other))];
+            if (other == local || distance == UINT32_MAX) continue;
+
+            if (add_cluster_edge(work, (struct cluster_edge_t) { (uint32_t) (first + other), distance }) != 0) return -1;
+        }
+
+        // Connect the entrance to the entrances it leads to in the neighbouring
+        // clusters, which are only missing if a passage leads one way.
+        enum action_set_t action_set = get_action_set(maze, location);
+
+        for (enum action_t action = EAST; action <= NORTH; action++)
+        {
+            if (!(action_set & (1 << action))) continue;
+
+            struct location_t next = action_result(location, action);
+            if (within_cluster(bounds, next) || !check_location(maze.size, next)) continue;
+
+            size_t target = 0;
+            if (!find_entrance(graph, next, &target)) continue;
+
+            if (add_cluster_edge(work, (struct cluster_edge_t) { (uint32_t) target, 1 }) != 0) return -1;
+        }
+
+        work->degrees[local] = work->edge_count - count;
+    }
+
+    return 0;
+}
+
+// Define add_cluster_edge (hierarchical_search.c).
+static int add_cluster_edge(struct cluster_work_t* work, struct cluster_edge_t edge)
+{
+    // If the capacity has been reached, resize the edges.
+    if (work->edge_count >= work->edge_capacity)
+    {
+        // Resize according to 2 * previous capacity.
+        size_t new_capacity = (work->edge_capacity == 0) ? 64 : work->edge_capacity * 2;
+        void* ptr = realloc((void*) work->edges, new_capacity * sizeof(struct cluster_edge_t));
+
+        // Indicate failure if resize failed.
+        if (ptr == NULL) return -1;
+
+        work->edges = (struct cluster_edge_t*) ptr;
+        work->edge_capacity = new_capacity;
+    }
+
+    work->edges[work->edge_count++] = edge;
+
+    return 0;
+}
+
+// Define run_builder (hierarchical_search.c).
+static void* run_builder(void* arg)
+{
+    struct cluster_builder_t* builder = (struct cluster_builder_t*) arg;
+    size_t cluster_count = builder->graph->cluster_rows * builder->graph->cluster_columns;
+
+    // Only connecting the entrances needs to search the clusters.
+    struct cluster_search_t search = { NULL, NULL };
+    if (builder->step == CONNECT_ENTRANCES && make_cluster_search(&search, builder->graph->cluster_size) != 0)
+    {
+        atomic_store(&builder->failed, true);
+        return NULL;
+    }
+
+    while (!atomic_load_explicit(&builder->failed, memory_order_relaxed))
+    {
+        size_t cluster = atomic_fetch_add_explicit(&builder->next, 1, memory_order_relaxed);
+        if (cluster >= cluster_count) break;
+
+        struct cluster_work_t* work = &builder->work[cluster];
+        int result = (builder->step == FIND_ENTRANCES)
+                   ? find_cluster_entrances(builder->graph, builder->maze, cluster, work)
+                   : connect_cluster_entrances(builder->graph, builder->maze, cluster, work, &search);
+
+        if (result != 0) atomic_store(&builder->failed, true);
+    }
+
+    free_cluster_search(&search);
+
+    return NULL;
+}
+
+// Define run_builders (hierarchical_search.c).
+static int run_builders(struct cluster_builder_t* builder, size_t threads)
+{
+    atomic_store(&builder->next, 0);
+
+    // Start every thread but the first, which is the calling thread. If the
+    // threads cannot be started, the clusters are taken by fewer threads.
+    pthread_t* handles = (threads > 1) ? (pthread_t*) malloc((threads - 1) * sizeof(pthread_t)) : NULL;
+
+    size_t started = 0;
+    while (handles != NULL && started < threads - 1)
+    {
+        if (pthread_create(&handles[started], NULL, run_builder, (void*) builder) != 0) break;
+        started++;
+    }
+
+    run_builder((void*) builder);
+
+    for (size_t thread = 0; thread < started; thread++)
+    {
+        pthread_join(handles[thread], NULL);
+    }
+
+    free(handles);
+
+    return atomic_load(&builder->failed) ? -1 : 0;
+}
+
+// Define reach_entrance (hierarchical_search.c).
+static int reach_entrance(struct node_queue_t* frontier, struct entrance_state_t* states, size_t parent, size_t entrance, size_t cost, struct location_t location, struct location_t goal)
+{
+    struct entrance_state_t* state = &states[entrance];
+    if (state->cost != 0 && state->cost <= cost) return 0;
+
+    state->cost = cost;
+    state->parent = parent;
+
+    struct node_t node = { { 0, entrance }, NULL };
+
+    return push_node(frontier, &node, cost - 1 + location_manhattan(location, goal));
+}
+
+// Define append_cluster_path (hierarchical_search.c).
+static int append_cluster_path(struct node_list_t* list, struct maze_t maze, const struct cluster_graph_t* graph, const struct entrance_state_t* states, struct cluster_search_t* search)
+{
+    size_t start = graph->entrance_count;
+    size_t end = graph->entrance_count + 1;
+    size_t length = states[start].cost - 1;
+
+    // Collect the locations on the path in order from the start.
+    struct location_t* locations = (struct location_t*) malloc((length + 1) * sizeof(struct location_t));
+    if (locations == NULL) return -1;
+
+    size_t count = 0;
+    locations[count++] = maze.start;
+
+    int result = 0;
+    for (size_t entrance = start; result == 0 && entrance != end; entrance = states[entrance].parent)
+    {
+        size_t next = states[entrance].parent;
+        struct location_t from = (entrance == start) ? maze.start : entrance_location(graph, entrance);
+        struct location_t to = (next == end) ? maze.end : entrance_location(graph, next);
+
+        // An edge between clusters is a single action.
+        if (get_cluster(graph, from) != get_cluster(graph, to))
+        {
+            if (count > length)
+            {
+                result = -1;
+                break;
+            }
+
+            locations[count++] = to;
+            continue;
+        }
+
+        // Otherwise, search the cluster from the far end of the edge, which the
+        // path leads from, then step to the location one action closer to it
+        // which has an action leading back.
+        struct cluster_bounds_t bounds = get_cluster_bounds(graph, get_cluster(graph, to));
+        search_cluster(maze, bounds, to, false, search);
+
+        struct location_t location = from;
+        uint32_t distance = search->distances[cluster_index(bounds, location)];
+
+        while (result == 0 && distance > 0)
+        {
+            result = -1;
+
+            for (enum action_t action = EAST; action <= NORTH; action++)
+            {
+                struct location_t child = action_result(location, action);
+                if (!within_cluster(bounds, child) || search->distances[cluster_index(bounds, child)] != distance - 1) continue;
+                if (!(get_action_set(maze, child) & (1 << reverse_action(action)))) continue;
+
+                location = child;
+                distance--;
+                result = 0;
+                break;
+            }
+
+            if (result == 0 && count > length) result = -1;
+            if (result == 0) locations[count++] = location;
+        }
+    }
+
+    if (result == 0 && count != length + 1) result = -1;
+
+    // Make space for a node at every location on the path, so that the parents
+    // of the nodes are not moved as they are appended.
+    if (result == 0 && list->capacity < list->length + count)
+    {
+        result = resize_list(list, list->length + count);
+    }
+
+    // Append the nodes from the end, so that the final node is the start.
+    for (size_t step = count; result == 0 && step > 0; step--)
+    {
+        struct node_t node = { locations[step - 1], (step == count) ? NULL : get_node(list, list->length - 1) };
+        result = insert_node(list, &node, list->length);
+    }
+
+    free(locations);
+
+    return result;
+}
@@ -37,6 +37,21 @@ enum action_t
  */
 struct location_t action_result(struct location_t location, enum action_t action);
 
+/**
+ * Finds the action which reverses a given action.
+ *
+ * This function simply finds the action in the opposite cardinal direction to
+ * the given action, such that taking both actions in turn returns to the
+ * original location.
+ *
+ * \param [in] action
+ *     The action to reverse.
+ *
+ * \returns
+ *     The action in the opposite direction to the given action.
+ */
+enum action_t reverse_action(enum action_t action);
+
 /**
  * Determines the action taken to move from one given location to another.
  *
@@ -0,0 +1,166 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "path.h"
+
+
+/**
+ * Represents a maze file to be solved as part of a batch.
+ *
+ * This struct contains the names of the file to read the maze from and the
+ * file to write its solution to, along with the result of solving it, which is
+ * -1 until the job has been completed successfully.
+ */
+struct batch_job_t
+{
+    char* input;
+    char* output;
+    int result;
+};
+
+/**
+ * Represents a batch of maze files to be solved together.
+ *
+ * This struct contains a pointer to a dynamically allocated array of jobs,
+ * along with the number of jobs and the number of jobs that can be stored
+ * before the array needs to be resized.
+ *
+ * \see test_batch()
+ */
+struct batch_t
+{
+    struct batch_job_t* jobs;
+    size_t length;
+    size_t capacity;
+};
+
+/**
+ * Creates an empty batch.
+ *
+ * \param [out] batch
+ *     A pointer to the batch variable that will be initialized.
+ *
+ * \pre
+ *     The pointer to the batch variable must not be NULL.
+ */
+void make_batch(struct batch_t* batch);
+
+/**
+ * Releases the memory held by a batch, including the names of its files.
+ *
+ * \param [in,out] batch
+ *     A pointer to the batch to free.
+ *
+ * \pre
+ *     The pointer to the batch variable must not be NULL.
+ */
+void free_batch(struct batch_t* batch);
+
+/**
+ * Adds a job to a batch.
+ *
+ * This function attempts to copy the given file names into a new job at the
+ * end of the batch, doubling the capacity of the batch if it is full.
+ *
+ * \param [in,out] batch
+ *     A pointer to the batch.
+ * \param [in]     input
+ *     The name of the file to read the maze from.
+ * \param [in]     output
+ *     The name of the file to write the solution to.
+ *
+ * \pre
+ *     The pointer to the batch variable must not be NULL.
+ * \pre
+ *     The file names must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int add_batch_job(struct batch_t* batch, const char* input, const char* output);
+
+/**
+ * Adds a job to a batch for every pair of file names listed in a file.
+ *
+ * This function reads the given file a line at a time, where each line which
+ * is not empty holds the name of a maze file followed by the name of the file
+ * to write its solution to, separated by whitespace.
+ *
+ * \param [in,out] batch
+ *     A pointer to the batch.
+ * \param [in]     filename
+ *     The name of the file listing the jobs.
+ *
+ * \pre
+ *     The pointer to the batch variable must not be NULL.
+ * \pre
+ *     The file name must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, including when a line does not hold exactly two names, 0
+ *     on success.
+ */
+int read_batch_list(struct batch_t* batch, const char* filename);
+
+/**
+ * Adds a job to a batch for every file in a directory.
+ *
+ * This function adds a job for each entry of the given input directory whose
+ * name does not begin with '.', writing the solution to a file of the same name
+ * in the given output directory. The jobs are added in order of name.
+ *
+ * \param [in,out] batch
+ *     A pointer to the batch.
+ * \param [in]     input_directory
+ *     The name of the directory containing the maze files.
+ * \param [in]     output_directory
+ *     The name of the directory to write the solutions to.
+ *
+ * \pre
+ *     The pointer to the batch variable must not be NULL.
+ * \pre
+ *     The directory names must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int read_batch_directory(struct batch_t* batch, const char* input_directory, const char* output_directory);
+
+/**
+ * Solves every maze in a batch on a pool of threads.
+ *
+ * This function divides the jobs of the batch evenly between the given number
+ * of threads. Each thread takes jobs from the front of its own share, and once
+ * its share is empty, steals the back half of the share of another thread, so
+ * that threads which finish early help with the larger mazes left elsewhere.
+ * Each thread keeps a node list and the buffers of a compact search (see
+ * solve_maze_compact_buffered()) for all of its jobs, so that memory is only
+ * allocated again for a maze bigger than any the thread has already solved.
+ * The result of each job is stored in the job, and a line reporting the result
+ * is written to the given status file as each job is completed.
+ *
+ * \param [in,out] batch
+ *     A pointer to the batch to solve.
+ * \param [in]     threads
+ *     The number of threads to solve the batch with.
+ * \param [in]     encoding
+ *     The encoding to write each path in.
+ * \param [in]     status
+ *     The file handle to report the result of each job to, or NULL.
+ *
+ * \pre
+ *     The pointer to the batch variable must not be NULL.
+ * \pre
+ *     The number of threads must be at least 1.
+ *
+ * \returns
+ *     -1 if any job failed, 0 if every job succeeded.
+ */
+int solve_batch(struct batch_t* batch, size_t threads, enum path_encoding_t encoding, FILE* status);
+
+
+#endif // BATCH_H
@@ -0,0 +1,122 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+struct maze_t;
+struct node_list_t;
+struct search_stats_t;
+
+/**
+ * Represents the sets of actions of a maze as four bitplanes.
+ *
+ * This struct contains a plane of bits for each action, indexed by the action,
+ * in which the bit for each location is set if the action is available at that
+ * location. Each plane is stored row by row, with every row padded to a whole
+ * number of 64-bit words (the stride) so that a row can be shifted as a unit.
+ * Within a row, the bit for each column is bit (column % 64) of word
+ * (column / 64).
+ *
+ * \see test_bitboard()
+ */
+struct bitplanes_t
+{
+    uint64_t* planes[4];
+    size_t rows;
+    size_t columns;
+    size_t stride;
+};
+
+/**
+ * Creates the bitplanes representing the sets of actions of a maze.
+ *
+ * This function attempts to initialize all the properties of the given pointer
+ * after allocating a section of memory for the four planes, then sets the bit
+ * of every available action at every location in the maze.
+ *
+ * \param [out] planes
+ *     A pointer to the bitplanes variable that will be initialized.
+ * \param [in]  maze
+ *     The maze to represent.
+ *
+ * \pre
+ *     The pointer to the bitplanes variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int make_bitplanes(struct bitplanes_t* planes, struct maze_t maze);
+
+/**
+ * Releases the memory held by a set of bitplanes.
+ *
+ * \param [in,out] planes
+ *     A pointer to the bitplanes to free.
+ *
+ * \pre
+ *     The pointer to the bitplanes variable must not be NULL.
+ */
+void free_bitplanes(struct bitplanes_t* planes);
+
+/**
+ * Solves a given maze using bit-parallel breadth-first search.
+ *
+ * This function attempts to find a shortest path from the end of the given maze
+ * back to the start. Instead of expanding one node at a time, the frontier of
+ * each level is held as a bitmap with the same layout as the bitplanes of the
+ * maze, and is expanded in each direction at once by masking it with the plane
+ * of the action and shifting whole words, 64 locations at a time. Only the
+ * words of the frontier holding any locations are processed, so each level
+ * costs time in proportion to the size of the frontier. The action leading back
+ * towards the end is recorded for each newly reached location, and once the
+ * start has been reached the path is appended to the given list using
+ * append_path(), such that the final node in the list will be the start of the
+ * maze. Only the nodes that form the path are inserted into the list.
+ *
+ * \see test_bitboard()
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int solve_maze_bitboard(struct node_list_t* list, struct maze_t maze);
+
+/**
+ * Solves a given maze using bit-parallel breadth-first search, recording the
+ * work done.
+ *
+ * This function behaves in the same way as solve_maze_bitboard(), and also
+ * records the locations expanded and reached in the given statistics, if the
+ * given pointer is not NULL. Each location is reached at most once, so no push
+ * is a duplicate.
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ * \param [out] stats
+ *     A pointer to the statistics variable which will record the work done, or
+ *     NULL.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int solve_maze_bitboard_measured(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats);
+
+
+#endif // BITBOARD_H
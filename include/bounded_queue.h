@@ -0,0 +1,114 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+
+/**
+ * Represents a slot in a bounded queue.
+ *
+ * This struct pairs a value with a sequence number, which tells the threads
+ * using the queue whether the slot is ready to be written or read in the
+ * current pass through the buffer.
+ */
+struct queue_slot_t
+{
+    atomic_size_t sequence;
+    void* value;
+};
+
+/**
+ * Represents a fixed size first-in, first-out queue of pointers, which can be
+ * used by any number of threads at once without locking.
+ *
+ * This struct contains a circular buffer of slots, whose capacity is a power of
+ * two, along with the positions at which the next value will be added and
+ * removed. Each thread claims a position by advancing it with a compare and
+ * swap, then publishes the value by updating the sequence number of the slot,
+ * so threads only wait for each other when the queue is full or empty. The two
+ * positions are kept on separate cache lines, so that threads adding values do
+ * not slow down threads removing them.
+ *
+ * \see test_bounded_queue()
+ */
+struct bounded_queue_t
+{
+    struct queue_slot_t* slots;
+    size_t mask;
+    char mask_padding[64];
+    atomic_size_t tail;
+    char tail_padding[64];
+    atomic_size_t head;
+    char head_padding[64];
+};
+
+/**
+ * Creates an empty bounded queue.
+ *
+ * \param [out] queue
+ *     A pointer to the bounded queue variable that will be initialized.
+ * \param [in]  capacity
+ *     The number of values the queue can hold, which must be a power of two.
+ *
+ * \pre
+ *     The pointer to the bounded queue variable must not be NULL.
+ * \pre
+ *     The capacity must be a power of two, and at least 2.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int make_bounded_queue(struct bounded_queue_t* queue, size_t capacity);
+
+/**
+ * Releases the memory held by a bounded queue.
+ *
+ * \param [in,out] queue
+ *     A pointer to the bounded queue to free.
+ *
+ * \pre
+ *     The pointer to the bounded queue variable must not be NULL.
+ * \pre
+ *     No other thread may be using the queue.
+ */
+void free_bounded_queue(struct bounded_queue_t* queue);
+
+/**
+ * Attempts to add a value to the back of a bounded queue.
+ *
+ * \param [in,out] queue
+ *     A pointer to the bounded queue.
+ * \param [in]     value
+ *     The value to add.
+ *
+ * \pre
+ *     The pointer to the bounded queue variable must not be NULL.
+ *
+ * \returns
+ *     Whether the value was added, which is only false if the queue is full.
+ */
+bool try_push_value(struct bounded_queue_t* queue, void* value);
+
+/**
+ * Attempts to remove the value at the front of a bounded queue.
+ *
+ * \param [in,out] queue
+ *     A pointer to the bounded queue.
+ * \param [out]    value
+ *     A pointer to the variable which will contain the removed value.
+ *
+ * \pre
+ *     The pointer to the bounded queue variable must not be NULL.
+ * \pre
+ *     The pointer to the value variable must not be NULL.
+ *
+ * \returns
+ *     Whether a value was removed, which is only false if the queue is empty.
+ */
+bool try_pop_value(struct bounded_queue_t* queue, void** value);
+
+
+#endif // BOUNDED_QUEUE_H
@@ -0,0 +1,155 @@
+#ifndef COMPACT_SEARCH_H
+#define COMPACT_SEARCH_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "maze_size.h"
+#include "location_set.h"
+#include "direction_map.h"
+
+
+struct maze_t;
+struct node_list_t;
+struct search_stats_t;
+
+/**
+ * Represents the buffers used by breadth-first search with a compact search
+ * state, which can be kept between searches.
+ *
+ * This struct contains the location set of reached locations, the direction
+ * map leading back to the end of the maze, and the buffer of the frontier,
+ * along with the number of locations the set and map have space for. Solving
+ * many mazes with the same buffers avoids allocating them again for each maze
+ * unless it is bigger than any before it.
+ *
+ * \see test_solve_maze_compact()
+ */
+struct compact_search_t
+{
+    struct location_set_t reached;
+    struct direction_map_t directions;
+    uint32_t* frontier;
+    size_t frontier_capacity;
+    size_t capacity;
+};
+
+/**
+ * Creates the buffers for breadth-first search with a compact search state.
+ *
+ * This function attempts to initialize all the properties of the given pointer,
+ * allocating a location set and a direction map for mazes of the given size.
+ * The buffer of the frontier is allocated when it is first needed.
+ *
+ * \param [out] search
+ *     A pointer to the compact search variable that will be initialized.
+ * \param [in]  size
+ *     The size of the mazes to allocate space for.
+ *
+ * \pre
+ *     The pointer to the compact search variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int make_compact_search(struct compact_search_t* search, struct maze_size_t size);
+
+/**
+ * Releases the memory held by the buffers of a compact search.
+ *
+ * \param [in,out] search
+ *     A pointer to the compact search to free.
+ *
+ * \pre
+ *     The pointer to the compact search variable must not be NULL.
+ */
+void free_compact_search(struct compact_search_t* search);
+
+/**
+ * Solves a given maze using breadth-first search with a compact search state,
+ * reusing a given set of buffers.
+ *
+ * This function behaves in the same way as solve_maze_compact(), but keeps its
+ * state in the given buffers, growing them only if the maze has more locations
+ * than they have space for. The buffers are left ready for the next search.
+ *
+ * \param [out]    list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]     maze
+ *     The maze to solve.
+ * \param [in,out] search
+ *     A pointer to the buffers to search with.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ * \pre
+ *     The pointer to the compact search variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, including when the maze has more locations than can be
+ *     indexed with 32 bits, 0 on success.
+ */
+int solve_maze_compact_buffered(struct node_list_t* list, struct maze_t maze, struct compact_search_t* search);
+
+/**
+ * Solves a given maze using breadth-first search with a compact search state.
+ *
+ * This function attempts to find a shortest path from the end of the given maze
+ * back to the start without creating a node for every location it reaches.
+ * Instead, each location in the frontier is a 32-bit location index (see
+ * location_index()), the locations reached are held in a location set, and the
+ * action leading back to the parent of each location is held in a direction
+ * map, so the search costs under a byte per location plus four bytes per
+ * location in the frontier. Once the start has been reached, the path is
+ * appended to the given list using append_direction_path(), such that the final
+ * node in the list will be the start of the maze. Only the nodes that form the
+ * path are inserted into the list.
+ *
+ * \see test_solve_maze_compact()
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, including when the maze has more locations than can be
+ *     indexed with 32 bits, 0 on success.
+ */
+int solve_maze_compact(struct node_list_t* list, struct maze_t maze);
+
+/**
+ * Solves a given maze using breadth-first search with a compact search state,
+ * recording the work done.
+ *
+ * This function behaves in the same way as solve_maze_compact(), and also
+ * records the locations expanded and added to the frontier in the given
+ * statistics, if the given pointer is not NULL. Each location is added to the
+ * frontier at most once, so no push is a duplicate.
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ * \param [out] stats
+ *     A pointer to the statistics variable which will record the work done, or
+ *     NULL.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, including when the maze has more locations than can be
+ *     indexed with 32 bits, 0 on success.
+ */
+int solve_maze_compact_measured(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats);
+
+
+#endif // COMPACT_SEARCH_H
@@ -0,0 +1,211 @@
+#ifndef CORRIDOR_GRAPH_H
+#define CORRIDOR_GRAPH_H
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "location.h"
+#include "maze_size.h"
+
+
+struct maze_t;
+struct node_list_t;
+struct search_stats_t;
+
+/**
+ * Represents a corridor between two junctions of a maze.
+ *
+ * This struct contains the index of the junction at the far end of the
+ * corridor (see find_junction()), the number of actions taken to walk along
+ * it, and the action taken to enter it from the junction it leaves.
+ */
+struct corridor_t
+{
+    uint32_t target;
+    uint32_t length;
+    unsigned char action;
+};
+
+/**
+ * Represents a maze with its corridors contracted into weighted edges.
+ *
+ * A location is a junction if it does not have exactly two actions available,
+ * so it is a dead end or a branch, or if it is the start or the end of the
+ * maze. Every other location lies in a corridor, which can only be walked
+ * along in one way, so a search only needs to consider the junctions and the
+ * corridors between them.
+ *
+ * This struct contains a pointer to a dynamically allocated array holding the
+ * location index (see location_index()) of every junction in ascending order,
+ * and the corridors leaving each junction, stored one junction after another,
+ * with the position of the first corridor of each junction held in a second
+ * array. The position after the corridors of the last junction is held at the
+ * end of that array. To find the junction at a location without searching,
+ * the graph also holds a bit for every location of the maze which is set at
+ * junctions, along with the number of junctions before each 64-bit word of
+ * bits, so that a junction is numbered by counting the bits set before it. Each
+ * corridor is held twice, once leaving each of its junctions, except for any
+ * corridor leading back to the junction it leaves, which is never on a
+ * shortest path and is left out.
+ *
+ * \see test_corridor_graph()
+ */
+struct corridor_graph_t
+{
+    uint32_t* junctions;
+    uint64_t* bits;
+    uint32_t* ranks;
+    size_t* offsets;
+    struct corridor_t* corridors;
+    size_t junction_count;
+    size_t corridor_count;
+    struct maze_size_t size;
+};
+
+/**
+ * Creates the corridor graph of a maze.
+ *
+ * This function attempts to initialize all the properties of the given pointer
+ * by scanning the maze for junctions, then walking along every corridor
+ * leaving each junction until another junction is reached. This takes time
+ * proportional to the number of locations in the maze, and memory proportional
+ * to the number of junctions, plus under a quarter of a byte per location to
+ * find them. Corridors which leave the maze, or which branch because a passage
+ * only leads one way, are left out.
+ *
+ * \param [out] graph
+ *     A pointer to the corridor graph variable that will be initialized.
+ * \param [in]  maze
+ *     The maze to contract.
+ *
+ * \pre
+ *     The pointer to the corridor graph variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, including when the maze has more locations than can be
+ *     indexed with 32 bits, 0 on success.
+ */
+int make_corridor_graph(struct corridor_graph_t* graph, struct maze_t maze);
+
+/**
+ * Releases the memory held by a corridor graph.
+ *
+ * \param [in,out] graph
+ *     A pointer to the corridor graph to free.
+ *
+ * \pre
+ *     The pointer to the corridor graph variable must not be NULL.
+ */
+void free_corridor_graph(struct corridor_graph_t* graph);
+
+/**
+ * Finds the junction at a given location in a corridor graph.
+ *
+ * This function checks the bit of the given location, and if it is set, counts
+ * the junctions before it, which takes constant time.
+ *
+ * \param [in]  graph
+ *     A pointer to the corridor graph.
+ * \param [in]  location
+ *     The location of the junction.
+ * \param [out] junction
+ *     A pointer to the variable which will contain the index of the junction
+ *     in the graph, if it is found.
+ *
+ * \pre
+ *     The pointer to the corridor graph variable must not be NULL.
+ * \pre
+ *     The pointer to the junction variable must not be NULL.
+ *
+ * \returns
+ *     Whether there is a junction at the given location.
+ */
+bool find_junction(const struct corridor_graph_t* graph, struct location_t location, size_t* junction);
+
+/**
+ * Solves a given maze using A* search over its corridor graph.
+ *
+ * This function attempts to find a shortest path from the end of the given
+ * maze back to the start, expanding only the junctions of the given graph,
+ * which must have been made from the same maze, ordered by the number of
+ * actions taken to reach them plus the Manhattan distance to the start. Once
+ * the start has been reached, the path is expanded back into a node for every
+ * location along each corridor, and appended to the given list such that the
+ * final node in the list will be the start of the maze. Only the nodes that
+ * form the path are inserted into the list.
+ *
+ * If the given pointer to the statistics variable is not NULL, the number of
+ * junctions expanded, the number of junctions pushed onto the frontier and how
+ * many of those were merged with a junction already queued, and the greatest
+ * number of junctions queued at once are recorded.
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ * \param [in]  graph
+ *     A pointer to the corridor graph of the maze.
+ * \param [out] stats
+ *     A pointer to the statistics variable which will record the work done, or
+ *     NULL.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ * \pre
+ *     The pointer to the corridor graph variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, including when the start cannot be reached, 0 on success.
+ */
+int solve_corridor_graph(struct node_list_t* list, struct maze_t maze, const struct corridor_graph_t* graph, struct search_stats_t* stats);
+
+/**
+ * Solves a given maze by contracting its corridors, recording the work done.
+ *
+ * This function makes the corridor graph of the maze, solves it using
+ * solve_corridor_graph() and frees it again.
+ *
+ * \see test_corridor_graph()
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ * \param [out] stats
+ *     A pointer to the statistics variable which will record the work done, or
+ *     NULL.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int solve_maze_corridors_measured(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats);
+
+/**
+ * Solves a given maze by contracting its corridors.
+ *
+ * This function behaves in the same way as solve_maze_corridors_measured(),
+ * which it is used to implement, without recording the work done.
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int solve_maze_corridors(struct node_list_t* list, struct maze_t maze);
+
+
+#endif // CORRIDOR_GRAPH_H
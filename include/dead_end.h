@@ -0,0 +1,104 @@
+#ifndef DEAD_END_H
+#define DEAD_END_H
+
+
+#include <stddef.h>
+
+
+struct maze_t;
+struct node_list_t;
+struct search_stats_t;
+
+/**
+ * Fills the dead ends of a maze, giving a pruned copy of the maze.
+ *
+ * This function copies the given maze, then seals every location of the copy
+ * with a single action available, other than the start and the end, closing
+ * the passage to its neighbour, and carries on along the passage while sealing
+ * a location leaves its neighbour with a single action available. Every branch
+ * which leads nowhere is filled in this way, so that the locations left open
+ * are those on a path between the start and end, or on a loop. In a perfect
+ * maze, they are exactly the locations on the path.
+ *
+ * The dead ends are first found by scanning sixteen locations at a time, one
+ * 64-bit word of the action set array, counting the actions of every location
+ * in the word at once. Each location is then sealed at most once, so this
+ * function takes time proportional to the number of locations in the maze, and
+ * memory for the copy and for a worklist of the dead ends found by the scan.
+ *
+ * \see test_fill_dead_ends()
+ *
+ * \param [out] pruned
+ *     A pointer to the maze variable that will be initialized with the pruned
+ *     copy of the maze.
+ * \param [in]  maze
+ *     The maze to prune.
+ * \param [out] filled
+ *     A pointer to the variable which will contain the number of locations
+ *     sealed, or NULL.
+ *
+ * \pre
+ *     The pointer to the pruned maze variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int fill_dead_ends(struct maze_t* pruned, struct maze_t maze, size_t* filled);
+
+/**
+ * Solves a given maze by filling its dead ends.
+ *
+ * This function prunes the given maze using fill_dead_ends(), then reads the
+ * path off the pruned maze by walking from the end, where every location left
+ * open has one way on, until the start is reached. Only the nodes that form the
+ * path are inserted into the given list, such that the final node in the list
+ * will be the start of the maze. If the pruned maze still has a loop, so that
+ * the way on is not clear, the pruned maze is solved using
+ * solve_maze_compact() instead.
+ *
+ * \see test_fill_dead_ends()
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int solve_maze_dead_ends(struct node_list_t* list, struct maze_t maze);
+
+/**
+ * Solves a given maze by filling its dead ends, recording the work done.
+ *
+ * This function behaves in the same way as solve_maze_dead_ends(), and also
+ * records the work done in the given statistics, if the given pointer is not
+ * NULL, where the frontier is the worklist of dead ends. Each location sealed
+ * counts as an expansion, and each location taken from the worklist which was
+ * no longer a dead end, or which was the start or the end, counts as a
+ * duplicate push. If the pruned maze is searched instead, the work done by the
+ * search is added to the work done pruning it.
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ * \param [out] stats
+ *     A pointer to the statistics variable which will record the work done, or
+ *     NULL.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int solve_maze_dead_ends_measured(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats);
+
+
+#endif // DEAD_END_H
@@ -0,0 +1,126 @@
+#ifndef DIRECTION_MAP_H
+#define DIRECTION_MAP_H
+
+
+#include <stddef.h>
+
+#include "action.h"
+#include "maze_size.h"
+
+
+struct location_t;
+struct maze_t;
+struct node_list_t;
+
+/**
+ * Represents an action recorded at every location in a maze.
+ *
+ * This struct contains a pointer to a dynamically allocated array holding two
+ * bits for every location in a maze of the given size, indexed by location (see
+ * location_index()), which is enough to store one action per location. A search
+ * can use it to record the direction back to the parent of each location it
+ * reaches, at a cost of a quarter of a byte per location rather than the size
+ * of a node.
+ *
+ * \see test_direction_map()
+ */
+struct direction_map_t
+{
+    unsigned char* bits;
+    struct maze_size_t size;
+};
+
+/**
+ * Creates a direction map for a maze of a given size.
+ *
+ * This function attempts to initialize all the properties of the given pointer
+ * after allocating a section of memory big enough to store two bits for every
+ * location in a maze of the given size. Every location initially holds EAST.
+ *
+ * \param [out] map
+ *     A pointer to the direction map variable that will be initialized.
+ * \param [in]  size
+ *     The size of the maze containing the locations.
+ *
+ * \pre
+ *     The pointer to the direction map variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int make_direction_map(struct direction_map_t* map, struct maze_size_t size);
+
+/**
+ * Releases the memory held by a direction map.
+ *
+ * \param [in,out] map
+ *     A pointer to the direction map to free.
+ *
+ * \pre
+ *     The pointer to the direction map variable must not be NULL.
+ */
+void free_direction_map(struct direction_map_t* map);
+
+/**
+ * Sets the action recorded at the location with a given index in a direction
+ * map.
+ *
+ * \param [in,out] map
+ *     A pointer to the direction map.
+ * \param [in]     index
+ *     The index of the location (see location_index()).
+ * \param [in]     action
+ *     The action to record.
+ *
+ * \pre
+ *     The pointer to the direction map variable must not be NULL.
+ * \pre
+ *     The index must be within the maze of the map.
+ */
+void set_direction(struct direction_map_t* map, size_t index, enum action_t action);
+
+/**
+ * Gets the action recorded at the location with a given index in a direction
+ * map.
+ *
+ * \param [in] map
+ *     A pointer to the direction map.
+ * \param [in] index
+ *     The index of the location (see location_index()).
+ *
+ * \pre
+ *     The pointer to the direction map variable must not be NULL.
+ * \pre
+ *     The index must be within the maze of the map.
+ *
+ * \returns
+ *     The action recorded at the location.
+ */
+enum action_t get_direction(struct direction_map_t* map, size_t index);
+
+/**
+ * Appends a path through a maze, described by a direction map, to a node list.
+ *
+ * This function behaves in the same way as append_path(), but follows the
+ * actions recorded in the given direction map, which must lead one step closer
+ * to the end of the maze at each location on the path from the start.
+ *
+ * \param [in,out] list
+ *     A pointer to the node list to append the path to.
+ * \param [in]     maze
+ *     The maze containing the path.
+ * \param [in]     map
+ *     A pointer to the direction map describing the path.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ * \pre
+ *     The pointer to the direction map variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int append_direction_path(struct node_list_t* list, struct maze_t maze, struct direction_map_t* map);
+
+
+#endif // DIRECTION_MAP_H
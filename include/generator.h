@@ -0,0 +1,107 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "maze_size.h"
+#include "maze.h"
+
+
+/**
+ * Represents an algorithm that can be used to generate a maze.
+ *
+ * Every algorithm generates a perfect maze, in which there is exactly one path
+ * between any two locations, before any loops are added by braiding.
+ *
+ * GENERATOR_BACKTRACKER carves a random depth-first walk, backing up when it
+ * is stuck, giving long winding passages with few branches. GENERATOR_KRUSKAL
+ * removes walls in a random order whenever they separate unconnected regions,
+ * giving many short dead ends. GENERATOR_WILSON joins loop-erased random walks,
+ * giving a uniformly random spanning tree, which has no bias towards any kind
+ * of passage. GENERATOR_ELLER builds the maze a row at a time, and is the only
+ * algorithm which can stream a maze to a file without holding it in memory.
+ */
+enum generator_t
+{
+    GENERATOR_BACKTRACKER,
+    GENERATOR_KRUSKAL,
+    GENERATOR_WILSON,
+    GENERATOR_ELLER
+};
+
+/**
+ * Represents the options used to generate a maze.
+ *
+ * This struct contains the algorithm, the size of the maze, the seed of the
+ * pseudo-random choices, and the percentage of dead ends to remove by opening a
+ * wall, which adds loops to the maze. A maze generated with the same options is
+ * always the same. The start of a generated maze is its top left corner and the
+ * end is its bottom right corner.
+ *
+ * \see test_generate_maze()
+ */
+struct generator_options_t
+{
+    enum generator_t algorithm;
+    struct maze_size_t size;
+    uint64_t seed;
+    unsigned int braid;
+};
+
+/**
+ * Generates a maze in memory.
+ *
+ * This function runs in time proportional to the number of locations, apart
+ * from GENERATOR_WILSON, whose random walks take longer on bigger mazes. Beyond
+ * the maze itself, which takes half a byte per location, GENERATOR_BACKTRACKER
+ * and GENERATOR_WILSON take a quarter of a byte per location, GENERATOR_KRUSKAL
+ * takes four bytes per location, and GENERATOR_ELLER takes memory for two rows.
+ *
+ * Braiding removes dead ends by opening a wall to any neighbour, apart from
+ * GENERATOR_ELLER, which only opens walls to the east, west or south, so that
+ * it can braid each row as it is finished, and may leave some dead ends.
+ *
+ * \param [out] maze
+ *     A pointer to the maze variable that will be initialized.
+ * \param [in]  options
+ *     The options to generate the maze with.
+ *
+ * \pre
+ *     The pointer to the maze variable must not be NULL.
+ * \pre
+ *     The maze must have at least one row and one column.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int generate_maze(struct maze_t* maze, struct generator_options_t options);
+
+/**
+ * Generates a maze a row at a time, writing it to a file as it goes.
+ *
+ * This function generates the same maze as generate_maze() does with
+ * GENERATOR_ELLER, but writes each row in the text format read by read_maze()
+ * as soon as it is finished, so that only two rows are ever held in memory,
+ * whatever the size of the maze.
+ *
+ * \param [in] options
+ *     The options to generate the maze with, which must use GENERATOR_ELLER.
+ * \param [in] fp
+ *     The file handle to write the maze to.
+ *
+ * \pre
+ *     The algorithm must be GENERATOR_ELLER.
+ * \pre
+ *     The maze must have at least one row and one column.
+ * \pre
+ *     The file pointer must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int stream_maze(struct generator_options_t options, FILE* fp);
+
+
+#endif // GENERATOR_H
@@ -0,0 +1,222 @@
+#ifndef HIERARCHICAL_SEARCH_H
+#define HIERARCHICAL_SEARCH_H
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "location.h"
+#include "maze_size.h"
+
+
+/**
+ * The number of rows and columns of each cluster used when no other size is
+ * chosen. Smaller clusters have fewer entrances to connect, so are faster to
+ * make, but give a bigger graph to search.
+ */
+#define DEFAULT_CLUSTER_SIZE 16
+
+
+struct maze_t;
+struct node_list_t;
+struct search_stats_t;
+
+/**
+ * Represents a path between two entrances of a cluster graph.
+ *
+ * This struct contains the index of the entrance the path leads to (see
+ * find_entrance()) and the number of actions taken along it.
+ */
+struct cluster_edge_t
+{
+    uint32_t target;
+    uint32_t cost;
+};
+
+/**
+ * Represents a maze divided into square clusters, abstracted into a graph of
+ * the entrances between them.
+ *
+ * The maze is divided into clusters of a fixed number of rows and columns,
+ * apart from those at the bottom and right edges of the maze, which may be
+ * smaller. An entrance is a location at the border of a cluster from which an
+ * action leads into another cluster, or into which an action leads from
+ * another cluster, as a passage may lead only one way. Each entrance has an
+ * edge to every entrance of the neighbouring cluster it leads into, costing one
+ * action, and an edge to every other entrance of its own cluster which it can
+ * reach without leaving the cluster, costing the fewest actions taken to do so.
+ * As every path through the maze passes through an entrance whenever it changes
+ * cluster, the shortest path between two entrances in the graph is as short as
+ * the shortest path between them in the maze.
+ *
+ * This struct contains a pointer to a dynamically allocated array holding the
+ * location index (see location_index()) of every entrance, grouped by cluster
+ * in row-major order of the clusters and in ascending order within each
+ * cluster, along with the position of the first entrance of each cluster, and
+ * the edges leaving each entrance, stored one entrance after another, with the
+ * position of the first edge of each entrance. Each array of positions ends
+ * with the position after the last cluster or entrance.
+ *
+ * \see test_cluster_graph()
+ */
+struct cluster_graph_t
+{
+    uint32_t* entrances;
+    size_t* clusters;
+    size_t* offsets;
+    struct cluster_edge_t* edges;
+    size_t entrance_count;
+    size_t edge_count;
+    size_t cluster_size;
+    size_t cluster_rows;
+    size_t cluster_columns;
+    struct maze_size_t size;
+};
+
+/**
+ * Creates the cluster graph of a maze.
+ *
+ * This function attempts to initialize all the properties of the given pointer
+ * by finding the entrances of every cluster, then searching each cluster from
+ * each of its entrances with breadth-first search to connect them. Both steps
+ * are shared between the given number of threads, each of which takes the next
+ * cluster until none are left, so the clusters are processed in parallel. The
+ * searches take time proportional to the number of locations in the maze
+ * multiplied by the number of entrances per cluster, which grows with the size
+ * of the clusters.
+ *
+ * \param [out] graph
+ *     A pointer to the cluster graph variable that will be initialized.
+ * \param [in]  maze
+ *     The maze to abstract.
+ * \param [in]  cluster_size
+ *     The number of rows and columns of each cluster.
+ * \param [in]  threads
+ *     The number of threads to use, including the calling thread.
+ *
+ * \pre
+ *     The pointer to the cluster graph variable must not be NULL.
+ * \pre
+ *     The cluster size must not be zero.
+ * \pre
+ *     The number of threads must not be zero.
+ *
+ * \returns
+ *     -1 on failure, including when the maze has more locations than can be
+ *     indexed with 32 bits, 0 on success.
+ */
+int make_cluster_graph(struct cluster_graph_t* graph, struct maze_t maze, size_t cluster_size, size_t threads);
+
+/**
+ * Releases the memory held by a cluster graph.
+ *
+ * \param [in,out] graph
+ *     A pointer to the cluster graph to free.
+ *
+ * \pre
+ *     The pointer to the cluster graph variable must not be NULL.
+ */
+void free_cluster_graph(struct cluster_graph_t* graph);
+
+/**
+ * Finds the entrance at a given location in a cluster graph.
+ *
+ * This function performs a binary search of the entrances of the cluster
+ * containing the given location.
+ *
+ * \param [in]  graph
+ *     A pointer to the cluster graph.
+ * \param [in]  location
+ *     The location of the entrance.
+ * \param [out] entrance
+ *     A pointer to the variable which will contain the index of the entrance
+ *     in the graph, if it is found.
+ *
+ * \pre
+ *     The pointer to the cluster graph variable must not be NULL.
+ * \pre
+ *     The pointer to the entrance variable must not be NULL.
+ * \pre
+ *     The location must be within the maze of the graph.
+ *
+ * \returns
+ *     Whether there is an entrance at the given location.
+ */
+bool find_entrance(const struct cluster_graph_t* graph, struct location_t location, size_t* entrance);
+
+/**
+ * Solves a given maze using hierarchical A* search over its cluster graph.
+ *
+ * This function attempts to find a shortest path from the end of the given
+ * maze back to the start. The clusters containing the start and end are
+ * searched first to connect them to the entrances of their clusters, then the
+ * entrances of the given graph, which must have been made from the same maze,
+ * are searched using A* search, ordered by the number of actions taken to
+ * reach them plus the Manhattan distance to the start. Once the start has been
+ * reached, only the clusters on the path are searched again to refine each
+ * edge into a node for every location, which are appended to the given list
+ * such that the final node in the list will be the start of the maze. Only the
+ * nodes that form the path are inserted into the list.
+ *
+ * If the given pointer to the statistics variable is not NULL, the number of
+ * entrances expanded, the number of entrances pushed onto the frontier and how
+ * many of those were merged with an entrance already queued, and the greatest
+ * number of entrances queued at once are recorded.
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ * \param [in]  graph
+ *     A pointer to the cluster graph of the maze.
+ * \param [out] stats
+ *     A pointer to the statistics variable which will record the work done, or
+ *     NULL.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ * \pre
+ *     The pointer to the cluster graph variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, including when the start cannot be reached, 0 on success.
+ */
+int solve_cluster_graph(struct node_list_t* list, struct maze_t maze, const struct cluster_graph_t* graph, struct search_stats_t* stats);
+
+/**
+ * Solves a given maze using hierarchical A* search, recording the work done.
+ *
+ * This function makes the cluster graph of the maze, solves it using
+ * solve_cluster_graph() and frees it again.
+ *
+ * \see test_cluster_graph()
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ * \param [in]  cluster_size
+ *     The number of rows and columns of each cluster.
+ * \param [in]  threads
+ *     The number of threads used to make the cluster graph.
+ * \param [out] stats
+ *     A pointer to the statistics variable which will record the work done, or
+ *     NULL.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ * \pre
+ *     The cluster size must not be zero.
+ * \pre
+ *     The number of threads must not be zero.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int solve_maze_hierarchical(struct node_list_t* list, struct maze_t maze, size_t cluster_size, size_t threads, struct search_stats_t* stats);
+
+
+#endif // HIERARCHICAL_SEARCH_H
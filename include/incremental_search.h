@@ -0,0 +1,173 @@
+#ifndef INCREMENTAL_SEARCH_H
+#define INCREMENTAL_SEARCH_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "location.h"
+#include "maze.h"
+#include "node_queue.h"
+
+
+struct node_list_t;
+struct search_stats_t;
+
+/**
+ * Represents the state of a Lifelong Planning A* search of a maze, kept between
+ * searches so that the maze can be solved again after its actions change by
+ * repairing only the part of the search affected by the change.
+ *
+ * This struct contains two arrays indexed by location (see location_index()).
+ * The first holds the distance of every location from the start of the maze
+ * found by the last search, known as g, and the second holds the distance one
+ * action further than the nearest location leading to it, known as rhs, with
+ * UINT32_MAX for locations which are not reached. A location whose distances
+ * differ is inconsistent and waits in the frontier, ordered by the lower of its
+ * distances plus the Manhattan distance to the end of the maze, then by the
+ * lower of its distances alone, both packed into a single cost by the given
+ * scale. The order of the frontier when the maze was last solved is kept so
+ * that the work done by each search can be recorded. Unlike the other searches,
+ * this search works forwards from the start, so that the path can be read back
+ * from the end into a list in the same order as theirs.
+ *
+ * The search refers to the action sets of the maze it was made from, which may
+ * be changed with set_action_set() between searches, so long as every location
+ * whose action set changed is then passed to update_incremental_search().
+ *
+ * \see test_incremental_search()
+ */
+struct incremental_search_t
+{
+    struct maze_t maze;
+    uint32_t* distances;
+    uint32_t* lookaheads;
+    struct node_queue_t frontier;
+    size_t scale;
+    size_t solved_order;
+};
+
+/**
+ * Creates the state of an incremental search of a maze.
+ *
+ * This function attempts to initialize all the properties of the given pointer,
+ * with every location unreached apart from the start of the maze, which waits
+ * in the frontier, so that the first search solves the whole maze.
+ *
+ * \param [out] search
+ *     A pointer to the incremental search variable that will be initialized.
+ * \param [in]  maze
+ *     The maze to search, whose start and end are fixed for the search.
+ *
+ * \pre
+ *     The pointer to the incremental search variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, including when the maze has too many locations for the
+ *     costs of the frontier to be held, 0 on success.
+ */
+int make_incremental_search(struct incremental_search_t* search, struct maze_t maze);
+
+/**
+ * Releases the memory held by an incremental search.
+ *
+ * \param [in,out] search
+ *     A pointer to the incremental search to free.
+ *
+ * \pre
+ *     The pointer to the incremental search variable must not be NULL.
+ */
+void free_incremental_search(struct incremental_search_t* search);
+
+/**
+ * Updates an incremental search after the action sets of a batch of locations
+ * of its maze have changed.
+ *
+ * This function recalculates the rhs distance of every given location and the
+ * locations around it, which are the only locations whose ways in can have
+ * changed, and queues any of them left inconsistent. No other locations are
+ * visited until the maze is solved again.
+ *
+ * \param [in,out] search
+ *     A pointer to the incremental search.
+ * \param [in]     locations
+ *     The array of locations whose action sets have changed.
+ * \param [in]     count
+ *     The number of locations in the array.
+ *
+ * \pre
+ *     The pointer to the incremental search variable must not be NULL.
+ * \pre
+ *     Every location must be within the maze of the search.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int update_incremental_search(struct incremental_search_t* search, const struct location_t* locations, size_t count);
+
+/**
+ * Solves the maze of an incremental search, repairing the search from its last
+ * solution.
+ *
+ * This function expands inconsistent locations from the frontier until the end
+ * of the maze is consistent and no location waiting could shorten the path to
+ * it, which after a small change to the maze expands only the locations whose
+ * distances the change affects. The path is then read back from the end by
+ * taking the nearest location leading to each location, appending a node for
+ * every location to the given list such that the final node in the list will
+ * be the start of the maze, as with the other searches. Only the nodes that
+ * form the path are inserted into the list.
+ *
+ * If the given pointer to the statistics variable is not NULL, the number of
+ * locations expanded by this search, the number of locations pushed onto the
+ * frontier since it was made or last solved, and the greatest number of
+ * locations queued at once in that time are recorded.
+ *
+ * \param [out]    list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in,out] search
+ *     A pointer to the incremental search.
+ * \param [out]    stats
+ *     A pointer to the statistics variable which will record the work done, or
+ *     NULL.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ * \pre
+ *     The pointer to the incremental search variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, including when the end cannot be reached, 0 on success.
+ */
+int solve_incremental_search(struct node_list_t* list, struct incremental_search_t* search, struct search_stats_t* stats);
+
+/**
+ * Solves a given maze once using Lifelong Planning A* search, recording the
+ * work done.
+ *
+ * This function makes an incremental search of the maze, solves it using
+ * solve_incremental_search() and frees it again, which searches the same
+ * locations as A* search.
+ *
+ * \see test_incremental_search()
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ * \param [out] stats
+ *     A pointer to the statistics variable which will record the work done, or
+ *     NULL.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int solve_maze_incremental(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats);
+
+
+#endif // INCREMENTAL_SEARCH_H
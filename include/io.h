@@ -2,11 +2,61 @@
 #define IO_H
 
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 
+#include "action.h"
+#include "maze.h"
+#include "path.h"
+
 
-struct maze_t;
 struct node_t;
+struct node_list_t;
+
+/**
+ * Represents a format that an image of a maze can be written in.
+ *
+ * IMAGE_PBM writes a binary portable bitmap, with one bit per pixel, showing
+ * only the walls of the maze in black.
+ *
+ * IMAGE_PGM writes a binary portable graymap, with one byte per pixel, showing
+ * the walls of the maze in black, the locations explored by a search in shades
+ * of gray from dark to light in the order they were explored, and the path in
+ * a darker gray than any explored location.
+ */
+enum image_format_t
+{
+    IMAGE_PBM,
+    IMAGE_PGM
+};
+
+/**
+ * Represents an image of a maze which can be rendered a band of rows at a time.
+ *
+ * Each location in the maze is drawn as a single pixel, with a pixel between
+ * each pair of locations which is open if there is an action between them and a
+ * wall otherwise, and a wall around the outside, so the image has 2 * rows + 1
+ * rows of 2 * columns + 1 pixels. The image never holds a whole raster.
+ * Instead, the nodes in a node list which are to be drawn are indexed by row
+ * with a counting sort, so that any band of rows can be rendered on its own,
+ * from any thread, in time proportional to its size.
+ *
+ * \see test_maze_image()
+ */
+struct maze_image_t
+{
+    struct maze_t maze;
+    struct node_list_t* list;
+    enum image_format_t format;
+    size_t width;
+    size_t height;
+    size_t line_length;
+    size_t* explored_offsets;
+    size_t* explored;
+    size_t* path_offsets;
+    size_t* path;
+};
 
 /**
  * Reads the contents of a file as a maze.
@@ -43,14 +93,143 @@ struct node_t;
  */
 int read_maze(struct maze_t* maze, FILE* fp);
 
+/**
+ * Reads the contents of a named file as a maze, by mapping the file into
+ * memory.
+ *
+ * This function behaves in the same way as read_maze(), accepting the same
+ * format, but rather than reading the file a line at a time into a fixed size
+ * buffer, it maps the whole file into memory and scans the numbers in place.
+ * This removes any limit on the length of a line, and avoids copying the file.
+ * Any whitespace may separate the numbers, and each set of walls must be a
+ * number between 0 and 15.
+ *
+ * If the file was instead written by write_maze_binary(), the maze uses the
+ * sets of actions in the mapped file directly, without parsing or copying them,
+ * and holds on to the mapping until it is released by free_maze(). The mapping
+ * is private, so changes to the maze are never written back to the file. The
+ * header of the file is checked, but the sets of actions are left unread until
+ * they are used, so they are not checked against the checksum in the header;
+ * use verify_maze_file() first to check them.
+ *
+ * \param[out] maze
+ *     A pointer to the maze variable that will store the maze.
+ * \param[in]  filename
+ *     The name of the file to read data from.
+ *
+ * \pre
+ *     The pointer to the maze variable must not be NULL.
+ * \pre
+ *     The file name must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int read_maze_file(struct maze_t* maze, const char* filename);
+
+/**
+ * Checks that a named file holds a maze that can be read by read_maze_file().
+ *
+ * This function maps the file into memory and reads it in full. The sets of
+ * actions of a file written by write_maze_binary() are checked against the
+ * checksum in its header, and any other file is scanned as a maze in the text
+ * format.
+ *
+ * \param[in] filename
+ *     The name of the file to check.
+ *
+ * \pre
+ *     The file name must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, when the file cannot be read or is corrupted, 0 on
+ *     success.
+ */
+int verify_maze_file(const char* filename);
+
+/**
+ * Writes a maze to a file in the text format read by read_maze().
+ *
+ * This function writes the size, start and end of the maze on the first three
+ * lines, followed by a line for each row of the maze holding the set of walls
+ * of each location as a number, separated by spaces. Each row is formatted in
+ * memory and written in one call.
+ *
+ * \param [in] maze
+ *     The maze to write to the file.
+ * \param [in] fp
+ *     The file handle to write the maze to.
+ *
+ * \pre
+ *     The file pointer must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int write_maze_text(struct maze_t maze, FILE* fp);
+
+/**
+ * Writes a single row of a maze to a file in the text format read by
+ * read_maze().
+ *
+ * This function writes the line for the row with the given sets of actions,
+ * as write_maze_text() does, so that a maze can be written a row at a time
+ * after its first three lines.
+ *
+ * \param [in] action_sets
+ *     The array holding the set of actions of each location in the row.
+ * \param [in] columns
+ *     The number of columns in the row.
+ * \param [in] buffer
+ *     A buffer of at least three characters for each column, which is used to
+ *     format the line.
+ * \param [in] fp
+ *     The file handle to write the row to.
+ *
+ * \pre
+ *     The pointers to the action set array and the buffer must not be NULL.
+ * \pre
+ *     The file pointer must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int write_maze_text_row(const unsigned char* action_sets, size_t columns, char* buffer, FILE* fp);
+
+/**
+ * Writes a maze to a file in a binary format that can be mapped into memory.
+ *
+ * This function writes a 64 byte header, followed by the packed sets of
+ * actions of the maze exactly as they are held in memory (see maze_t). The
+ * header begins with the characters "MAZE" and holds the version of the format,
+ * the size, start and end of the maze, and the 64 bit FNV-1a hash of the sets
+ * of actions, all in the byte order of the machine writing the file. A file in
+ * this format can be read with read_maze_file() in the time it takes to map
+ * it, and checked with verify_maze_file().
+ *
+ * \param [in] maze
+ *     The maze to write to the file.
+ * \param [in] fp
+ *     The file handle to write the maze to, which should be opened in binary
+ *     mode.
+ *
+ * \pre
+ *     The file pointer must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int write_maze_binary(struct maze_t maze, FILE* fp);
+
 /**
  * Writes an ascii character representation of a maze to a file.
  *
  * This function uses the character '#' along with whitespace to print out the
  * given maze to the file. Each location in the maze is represented by a 3x4
  * (rowsxcolumns) block of characters, apart from two of the edges, which have
- * an additional row and/or column to represent the edge. As an example, a 3x3
- * maze might be printed as follows:
+ * an additional row and/or column to represent the edge. Each line is built in
+ * memory and written in one call. As an example, a 3x3 maze might be printed as
+ * follows:
  *
  * \code{.unparsed}
  * #############
@@ -75,12 +254,42 @@ int read_maze(struct maze_t* maze, FILE* fp);
  */
 int write_maze(struct maze_t maze, FILE* fp);
 
+/**
+ * Writes an ascii character representation of a solved maze to a file.
+ *
+ * This function writes the given maze in the same way as write_maze(), but
+ * marks each location on the path found by a search with '*', and optionally
+ * each other location explored by the search with '.', in the middle of the
+ * block of characters representing the location. The path is followed from the
+ * final node in the given list, if it is the start of the maze, and the
+ * explored locations are those of every node in the list.
+ *
+ * \param [in] maze
+ *     The maze to write to the file.
+ * \param [in] list
+ *     A pointer to the node list filled by the search.
+ * \param [in] show_explored
+ *     Whether to mark the explored locations.
+ * \param [in] fp
+ *     The file handle to write the maze to.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ * \pre
+ *     The file pointer must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int write_solved_maze(struct maze_t maze, struct node_list_t* list, bool show_explored, FILE* fp);
+
 /**
  * Writes the actions taken in a given path to a file.
  *
  * This function follows the parent nodes of the start node to reconstruct the
- * actions taken to get from the start node in a maze to the end node. These
- * actions are then written to the given file.
+ * actions taken to get from the start node in a maze to the end node (see
+ * make_path()). These actions are then written to the given file, preceded by
+ * the number of actions, using write_encoded_path() with PATH_TEXT.
  *
  * \param [in] start
  *     The start node of the solved path.
@@ -97,5 +306,150 @@ int write_maze(struct maze_t maze, FILE* fp);
  */
 int write_path(struct node_t* start, FILE* fp);
 
+/**
+ * Writes a path to a file in a given encoding.
+ *
+ * This function encodes the whole path into a single buffer, whose size is
+ * known from the length of the path, and writes it to the given file in one
+ * call. The encodings are described by path_encoding_t.
+ *
+ * \param [in] path
+ *     The path to write to the file.
+ * \param [in] encoding
+ *     The encoding to write the path in.
+ * \param [in] fp
+ *     The file handle to write the path to, which should be opened in binary
+ *     mode for PATH_BINARY.
+ *
+ * \pre
+ *     The file pointer must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int write_encoded_path(struct path_t path, enum path_encoding_t encoding, FILE* fp);
+
+/**
+ * Converts an action into the printable character used for it when writing a
+ * path as text.
+ *
+ * \param [in] action
+ *     The action to convert.
+ *
+ * \returns
+ *     A printable character representing the given action.
+ */
+char action_char(enum action_t action);
+
+
+/**
+ * Creates an image of a maze, with the nodes explored by a search.
+ *
+ * This function attempts to initialize all the properties of the given pointer,
+ * sorting the indexes of the nodes in the given list by the row of their
+ * locations, along with the indexes of the nodes on the path followed from the
+ * final node in the list, if it is the start of the maze. The nodes are only
+ * sorted for IMAGE_PGM, as IMAGE_PBM only shows walls.
+ *
+ * \param [out] image
+ *     A pointer to the image variable that will be initialized.
+ * \param [in]  maze
+ *     The maze to draw.
+ * \param [in]  list
+ *     A pointer to the node list filled by a search, or NULL to only draw the
+ *     maze. The list must not change while the image is in use.
+ * \param [in]  format
+ *     The format of the image.
+ *
+ * \pre
+ *     The pointer to the image variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int make_maze_image(struct maze_image_t* image, struct maze_t maze, struct node_list_t* list, enum image_format_t format);
+
+/**
+ * Releases the memory held by an image of a maze.
+ *
+ * \param [in,out] image
+ *     A pointer to the image to free.
+ *
+ * \pre
+ *     The pointer to the image variable must not be NULL.
+ */
+void free_maze_image(struct maze_image_t* image);
+
+/**
+ * Finds the number of bytes of pixels drawn for a band of rows of a maze.
+ *
+ * \param [in] image
+ *     A pointer to the image.
+ * \param [in] first_row
+ *     The first row of the maze in the band.
+ * \param [in] last_row
+ *     The row of the maze after the final row in the band.
+ *
+ * \pre
+ *     The pointer to the image variable must not be NULL.
+ *
+ * \returns
+ *     The number of bytes needed by render_image_band().
+ */
+size_t image_band_size(struct maze_image_t* image, size_t first_row, size_t last_row);
+
+/**
+ * Renders the pixels for a band of rows of a maze.
+ *
+ * This function draws the two lines of pixels for each row of the maze in the
+ * band, along with the wall along the top of the image if the band begins with
+ * the first row, into the given buffer, in the binary encoding of the format of
+ * the image. The image is not changed, so different bands of the same image can
+ * be rendered at the same time by different threads, then written in order.
+ *
+ * \param [in]  image
+ *     A pointer to the image.
+ * \param [in]  first_row
+ *     The first row of the maze in the band.
+ * \param [in]  last_row
+ *     The row of the maze after the final row in the band.
+ * \param [out] buffer
+ *     A pointer to the buffer that will contain the pixels, which must have
+ *     space for the number of bytes given by image_band_size().
+ *
+ * \pre
+ *     The pointer to the image variable must not be NULL.
+ * \pre
+ *     The first row must not be after the last row, which must not be after the
+ *     final row of the maze.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int render_image_band(struct maze_image_t* image, size_t first_row, size_t last_row, unsigned char* buffer);
+
+/**
+ * Writes an image of a maze to a file.
+ *
+ * This function writes the header of the format of the image, followed by the
+ * pixels, rendered into a single buffer a band of rows at a time (see
+ * render_image_band()), so that only one band is held in memory at once.
+ *
+ * \param [in] image
+ *     A pointer to the image to write.
+ * \param [in] fp
+ *     The file handle to write the image to, which should be opened in binary
+ *     mode.
+ *
+ * \pre
+ *     The pointer to the image variable must not be NULL.
+ * \pre
+ *     The file pointer must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int write_maze_image(struct maze_image_t* image, FILE* fp);
+
 
 #endif // IO_H
@@ -39,6 +39,26 @@ struct location_t
  */
 size_t location_distance(struct location_t a, struct location_t b);
 
+/**
+ * Calculates the Manhattan distance between two locations.
+ *
+ * This function simply adds the distances between the two locations on each
+ * axis. Since every action in a maze moves a unit length along one axis, this
+ * is never more than the number of actions needed to move between the
+ * locations, so it is an admissible heuristic for finding shortest paths.
+ *
+ * \see test_location_manhattan()
+ *
+ * \param [in] a
+ *     The first of the locations.
+ * \param [in] b
+ *     The second of the locations.
+ *
+ * \returns
+ *     The Manhattan distance between the two locations.
+ */
+size_t location_manhattan(struct location_t a, struct location_t b);
+
 /**
  * Determines if two locations are equal to each other.
  *
@@ -0,0 +1,108 @@
+#ifndef LOCATION_SET_H
+#define LOCATION_SET_H
+
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "maze_size.h"
+
+
+struct location_t;
+
+/**
+ * Represents a set of locations in a maze.
+ *
+ * This struct contains a pointer to a dynamically allocated bitmap holding one
+ * bit for every location in a maze of the given size, indexed by location (see
+ * location_index()), so that locations can be added and tested in constant
+ * time. This makes it suitable for storing the closed set of a search.
+ *
+ * \see test_location_set()
+ */
+struct location_set_t
+{
+    unsigned char* bits;
+    struct maze_size_t size;
+};
+
+/**
+ * Creates an empty location set for a maze of a given size.
+ *
+ * This function attempts to initialize all the properties of the given pointer
+ * after allocating a section of memory for the bitmap, big enough to store a
+ * bit for every location in a maze of the given size.
+ *
+ * \param [out] set
+ *     A pointer to the location set variable that will be initialized.
+ * \param [in]  size
+ *     The size of the maze containing the locations.
+ *
+ * \pre
+ *     The pointer to the location set variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int make_location_set(struct location_set_t* set, struct maze_size_t size);
+
+/**
+ * Releases the memory held by a location set.
+ *
+ * \param [in,out] set
+ *     A pointer to the location set to free.
+ *
+ * \pre
+ *     The pointer to the location set variable must not be NULL.
+ */
+void free_location_set(struct location_set_t* set);
+
+/**
+ * Removes every location from a location set.
+ *
+ * This function simply clears the bitmap, so that the set can be reused for
+ * another search in a maze of the same size.
+ *
+ * \param [in,out] set
+ *     A pointer to the location set to clear.
+ *
+ * \pre
+ *     The pointer to the location set variable must not be NULL.
+ */
+void clear_location_set(struct location_set_t* set);
+
+/**
+ * Adds a location to a location set.
+ *
+ * \param [in,out] set
+ *     A pointer to the location set to add the location to.
+ * \param [in]     location
+ *     The location to add.
+ *
+ * \pre
+ *     The pointer to the location set variable must not be NULL.
+ * \pre
+ *     The location must be within the maze of the set.
+ */
+void add_location(struct location_set_t* set, struct location_t location);
+
+/**
+ * Determines if a location is in a location set.
+ *
+ * \param [in] set
+ *     A pointer to the location set.
+ * \param [in] location
+ *     The location to be found.
+ *
+ * \pre
+ *     The pointer to the location set variable must not be NULL.
+ * \pre
+ *     The location must be within the maze of the set.
+ *
+ * \returns
+ *     Whether the location is in the location set.
+ */
+bool contains_location(struct location_set_t* set, struct location_t location);
+
+
+#endif // LOCATION_SET_H
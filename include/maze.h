@@ -8,6 +8,7 @@
 
 
 struct node_list_t;
+struct search_stats_t;
 
 /**
  * Represents a maze.
@@ -15,13 +16,24 @@ struct node_list_t;
  * This struct contains the properties necessary to find a solution to the maze,
  * specifically a pointer to an array of sets of actions for every location in
  * the maze, along with the size of the maze and its start and end locations.
+ * Since a set of actions only needs four bits, the array packs the sets of two
+ * locations into each byte, with the location of even index (see
+ * location_index()) in the lower half of the byte. The array should only be
+ * accessed through set_action_set(), get_action_set(), their indexed forms and
+ * get_row_action_sets().
+ *
+ * The array is usually allocated by make_maze(), but may instead point into a
+ * file mapped into memory (see read_maze_file()), in which case the mapping and
+ * its length are also held, so that free_maze() can release the right one.
  */
 struct maze_t
 {
-    enum action_set_t* action_sets;
+    unsigned char* action_sets;
     struct maze_size_t size;
     struct location_t start;
     struct location_t end;
+    void* mapping;
+    size_t mapping_length;
 };
 
 /**
@@ -50,6 +62,20 @@ struct maze_t
  */
 int make_maze(struct maze_t* maze, struct maze_size_t size, struct location_t start, struct location_t end);
 
+/**
+ * Releases the memory held by a maze.
+ *
+ * This function frees the action set array of the given maze, or unmaps the
+ * file containing it if the maze was mapped from a file.
+ *
+ * \param [in,out] maze
+ *     A pointer to the maze to free.
+ *
+ * \pre
+ *     The pointer to the maze variable must not be NULL.
+ */
+void free_maze(struct maze_t* maze);
+
 /**
  * Sets the set of actions available at a given location in a maze.
  *
@@ -90,13 +116,105 @@ void set_action_set(struct maze_t maze, enum action_set_t action_set, struct loc
 enum action_set_t get_action_set(struct maze_t maze, struct location_t location);
 
 /**
- * Solves a given maze using A* search.
+ * Sets the set of actions available at the location with a given index in a
+ * maze.
+ *
+ * This function behaves in the same way as set_action_set(), but takes the
+ * index of the location (see location_index()), for searches which already
+ * work with indexes.
+ *
+ * \param [in,out] maze
+ *     The maze variable containing the pointer to the action set array in which
+ *     the set of actions is to be set.
+ * \param [in]     action_set
+ *     The set of actions to set.
+ * \param [in]     index
+ *     The index of the location in the maze that the set of actions relates to.
+ *
+ * \pre
+ *     The index must be less than the number of locations in the maze.
+ */
+void set_indexed_action_set(struct maze_t maze, enum action_set_t action_set, size_t index);
+
+/**
+ * Gets the set of actions available at the location with a given index in a
+ * maze.
+ *
+ * This function behaves in the same way as get_action_set(), but takes the
+ * index of the location (see location_index()), for searches which already
+ * work with indexes.
+ *
+ * \param [in] maze
+ *     The maze containing the action set array to get the specified action
+ *     from.
+ * \param [in] index
+ *     The index of the location of the specified action.
+ *
+ * \pre
+ *     The index must be less than the number of locations in the maze.
+ *
+ * \returns
+ *     The set of actions available at the location with the given index.
+ */
+enum action_set_t get_indexed_action_set(struct maze_t maze, size_t index);
+
+/**
+ * Gets the sets of actions available at every location in a row of a maze.
+ *
+ * This function unpacks the sets of actions for the given row of the maze into
+ * the given array, one byte per location, two locations at a time. This is
+ * faster than calling get_action_set() for each location when a whole row is
+ * needed at once.
+ *
+ * \param [in]  maze
+ *     The maze containing the action set array to get the row from.
+ * \param [in]  row
+ *     The row of the maze.
+ * \param [out] action_sets
+ *     A pointer to the array which will contain the set of actions for each
+ *     column of the row.
+ *
+ * \pre
+ *     The row must be within the maze.
+ * \pre
+ *     The pointer to the action set array must not be NULL, and the array must
+ *     have space for every column of the maze.
+ */
+void get_row_action_sets(struct maze_t maze, size_t row, unsigned char* action_sets);
+
+/**
+ * Sets the sets of actions available at every location in a row of a maze.
+ *
+ * This function packs the sets of actions in the given array, one byte per
+ * location, into the given row of the maze, two locations at a time. This is
+ * faster than calling set_action_set() for each location when a whole row is
+ * available at once.
+ *
+ * \param [in,out] maze
+ *     The maze variable containing the pointer to the action set array in which
+ *     the row is to be set.
+ * \param [in]     row
+ *     The row of the maze.
+ * \param [in]     action_sets
+ *     A pointer to the array containing the set of actions for each column of
+ *     the row.
+ *
+ * \pre
+ *     The row must be within the maze.
+ * \pre
+ *     The pointer to the action set array must not be NULL, and the array must
+ *     hold a set of actions for every column of the maze.
+ */
+void set_row_action_sets(struct maze_t maze, size_t row, const unsigned char* action_sets);
+
+/**
+ * Solves a given maze using greedy best-first search.
  *
  * This function attempts to find a path from the end of the given maze back to
- * the start, using A* search, which iteratively expands the next closest node
- * to the start location. Every expanded node is inserted into the given list in
- * order, such that the final node in the list will be the start of the maze, if
- * the search was successful.
+ * the start, using greedy best-first search, which iteratively expands the next
+ * closest node to the start location. Every expanded node is inserted into the
+ * given list in order, such that the final node in the list will be the start
+ * of the maze, if the search was successful.
  *
  * \see test_solve_maze()
  *
@@ -112,5 +230,155 @@ enum action_set_t get_action_set(struct maze_t maze, struct location_t location)
  */
 void solve_maze(struct node_list_t* list, struct maze_t maze);
 
+/**
+ * Solves a given maze using greedy best-first search, recording the work done.
+ *
+ * This function solves the maze in the same way as solve_maze(), which it is
+ * used to implement, and if the given pointer to the statistics variable is not
+ * NULL, records the number of nodes expanded, the number of nodes pushed onto
+ * the frontier and how many of those were merged with a node already queued,
+ * and the greatest number of nodes queued at once.
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the
+ *     explored nodes in the search, including the linked list of nodes that
+ *     form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ * \param [out] stats
+ *     A pointer to the search statistics variable, or NULL.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ */
+void solve_maze_measured(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats);
+
+/**
+ * Solves a given maze using A* search.
+ *
+ * This function attempts to find a shortest path from the end of the given maze
+ * back to the start, using A* search, which iteratively expands the node with
+ * the lowest sum of the number of actions taken to reach it from the end and
+ * the Manhattan distance from it to the start. The number of actions taken to
+ * reach each location is tracked, so that a location reached by a shorter path
+ * replaces the node already in the frontier. Every expanded node is inserted
+ * into the given list in order, such that the final node in the list will be
+ * the start of the maze, if the search was successful.
+ *
+ * \see test_solve_maze_a_star()
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the
+ *     explored nodes in the search, including the linked list of nodes that
+ *     form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ */
+void solve_maze_a_star(struct node_list_t* list, struct maze_t maze);
+
+/**
+ * Solves a given maze using A* search, recording the work done.
+ *
+ * This function solves the maze in the same way as solve_maze_a_star(), which
+ * it is used to implement, and records the same statistics as
+ * solve_maze_measured() if the given pointer is not NULL.
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the
+ *     explored nodes in the search, including the linked list of nodes that
+ *     form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ * \param [out] stats
+ *     A pointer to the search statistics variable, or NULL.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ */
+void solve_maze_a_star_measured(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats);
+
+/**
+ * Solves a given maze using bidirectional breadth-first search.
+ *
+ * This function attempts to find a path between the start and end of the given
+ * maze by expanding breadth-first from both locations at once, always expanding
+ * the whole next level of the side with the smaller frontier, and stops as soon
+ * as the two searches meet. The two halves of the path are then spliced
+ * together and appended to the given list using append_path(), such that the
+ * final node in the list will be the start of the maze, if the search was
+ * successful. Unlike solve_maze(), only the nodes that form the path are
+ * inserted into the list.
+ *
+ * \see test_solve_maze_bidirectional()
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ */
+void solve_maze_bidirectional(struct node_list_t* list, struct maze_t maze);
+
+/**
+ * Solves a given maze using bidirectional breadth-first search, recording the
+ * work done.
+ *
+ * This function behaves in the same way as solve_maze_bidirectional(), and also
+ * records the locations expanded and added to the frontiers of both searches
+ * in the given statistics, if the given pointer is not NULL. Each location is
+ * added to each frontier at most once, so no push is a duplicate, and the peak
+ * of the frontier is the greatest number of locations in both at once.
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ * \param [out] stats
+ *     A pointer to the statistics variable which will record the work done, or
+ *     NULL.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ */
+void solve_maze_bidirectional_measured(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats);
+
+/**
+ * Appends a path through a maze, described by the action to take at each
+ * location, to a node list.
+ *
+ * This function follows the given actions from the start of the maze until it
+ * reaches the end, then appends a node for every location on the way, starting
+ * with the end, such that each node's parent is the node for the next location
+ * on the path. The final node in the list will then be the start of the maze,
+ * in the same form produced by solve_maze(). This allows searches which record
+ * the action leading back to their origin in a per-location array to produce a
+ * path that can be used with write_path().
+ *
+ * \param [in,out] list
+ *     A pointer to the node list to append the path to.
+ * \param [in]     maze
+ *     The maze containing the path.
+ * \param [in]     actions
+ *     An array indexed by location (see location_index()), in which the lowest
+ *     two bits of the entry for each location on the path hold the action that
+ *     leads one step closer to the end of the maze.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ * \pre
+ *     The pointer to the actions array must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int append_path(struct node_list_t* list, struct maze_t maze, const unsigned char* actions);
+
 
 #endif // MAZE_H
@@ -38,5 +38,25 @@ struct maze_size_t
  */
 bool check_location(struct maze_size_t size, struct location_t location);
 
+/**
+ * Calculates the index of a given location within a maze of a given size.
+ *
+ * This function simply finds the position of the location when the locations
+ * of the maze are laid out row by row, which is the layout used for every
+ * per-location array associated with a maze.
+ *
+ * \param [in] size
+ *     The size of the maze containing the location.
+ * \param [in] location
+ *     The location to find the index of.
+ *
+ * \pre
+ *     The location must be within a maze of the given size.
+ *
+ * \returns
+ *     The index of the given location.
+ */
+size_t location_index(struct maze_size_t size, struct location_t location);
+
 
 #endif // MAZE_SIZE_H
@@ -0,0 +1,155 @@
+#ifndef MAZE_TREE_H
+#define MAZE_TREE_H
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "location.h"
+#include "maze.h"
+#include "direction_map.h"
+#include "compact_search.h"
+
+
+struct path_t;
+
+/**
+ * Represents the tree of shortest paths from a root location of a maze, kept
+ * to answer many queries between pairs of locations of the same maze.
+ *
+ * The tree is found by breadth-first search from the root. Every location
+ * reached holds the action leading to its parent in a direction map, and its
+ * depth, which is the number of actions taken to reach it from the root, or
+ * UINT32_MAX if it is not reached. Every location also holds a jump pointer to
+ * one of its ancestors, chosen from the depth of the location alone, such that
+ * any ancestor, and so the lowest common ancestor of two locations, can be
+ * found by following O(log n) jump pointers and parents, at a cost of four
+ * bytes per location rather than the four bytes per level of binary lifting.
+ *
+ * If the locations reached from the root have no loops, so the maze is a
+ * spanning tree of them, the path through the tree between any two locations
+ * is the only path between them. Otherwise, the path through the tree is only
+ * a shortest path if it begins or ends at the root, and other queries are
+ * answered by breadth-first search, reusing the buffers of a compact search
+ * which are kept for the purpose.
+ *
+ * The tree refers to the action sets of the maze it was made from, which must
+ * not be freed or changed while the tree is in use.
+ *
+ * \see test_maze_tree()
+ */
+struct maze_tree_t
+{
+    struct maze_t maze;
+    struct location_t root;
+    struct direction_map_t parents;
+    uint32_t* depths;
+    uint32_t* jumps;
+    bool acyclic;
+    struct compact_search_t search;
+};
+
+/**
+ * Creates the tree of shortest paths from a given root location of a maze.
+ *
+ * This function attempts to initialize all the properties of the given pointer
+ * by searching the maze from the root, taking time proportional to the number
+ * of locations in the maze, and memory for a direction map and eight bytes per
+ * location, plus the buffers of a compact search if the maze has loops.
+ *
+ * \param [out] tree
+ *     A pointer to the maze tree variable that will be initialized.
+ * \param [in]  maze
+ *     The maze to make the tree of.
+ * \param [in]  root
+ *     The location of the root of the tree.
+ *
+ * \pre
+ *     The pointer to the maze tree variable must not be NULL.
+ * \pre
+ *     The root must be within the maze.
+ *
+ * \returns
+ *     -1 on failure, including when the maze has too many locations for their
+ *     depths to be held in 32 bits, 0 on success.
+ */
+int make_maze_tree(struct maze_tree_t* tree, struct maze_t maze, struct location_t root);
+
+/**
+ * Releases the memory held by a maze tree.
+ *
+ * \param [in,out] tree
+ *     A pointer to the maze tree to free.
+ *
+ * \pre
+ *     The pointer to the maze tree variable must not be NULL.
+ */
+void free_maze_tree(struct maze_tree_t* tree);
+
+/**
+ * Finds the number of actions on a shortest path between two locations of the
+ * maze of a tree.
+ *
+ * This function finds the lowest common ancestor of the two locations in
+ * O(log n) time, where n is the number of locations, and adds their depths
+ * below it, if the path through the tree is a shortest path. Otherwise, it
+ * finds a path using solve_tree_path() and measures it.
+ *
+ * \param [in,out] tree
+ *     A pointer to the maze tree.
+ * \param [in]     start
+ *     The location the path begins at.
+ * \param [in]     end
+ *     The location the path ends at.
+ * \param [out]    length
+ *     A pointer to the variable which will contain the number of actions.
+ *
+ * \pre
+ *     The pointer to the maze tree variable must not be NULL.
+ * \pre
+ *     The pointer to the length variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, including when there is no path between the locations or
+ *     either is outside the maze, 0 on success.
+ */
+int tree_path_length(struct maze_tree_t* tree, struct location_t start, struct location_t end, size_t* length);
+
+/**
+ * Finds the actions taken along a shortest path between two locations of the
+ * maze of a tree.
+ *
+ * This function finds the lowest common ancestor of the two locations, then
+ * fills the path with the actions leading up the tree from the start to the
+ * ancestor, followed by the actions leading down the tree from the ancestor to
+ * the end, which are found backwards by following the parents from the end.
+ * This takes O(log n) time plus time proportional to the length of the path,
+ * without visiting any location off the path. If the maze has loops and
+ * neither location is the root, the path is found by breadth-first search
+ * instead.
+ *
+ * The path can be written using write_encoded_path().
+ *
+ * \param [out]    path
+ *     A pointer to the path variable that will be initialized.
+ * \param [in,out] tree
+ *     A pointer to the maze tree.
+ * \param [in]     start
+ *     The location the path begins at.
+ * \param [in]     end
+ *     The location the path ends at.
+ *
+ * \pre
+ *     The pointer to the path variable must not be NULL.
+ * \pre
+ *     The pointer to the maze tree variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, including when there is no path between the locations or
+ *     either is outside the maze, 0 on success.
+ */
+int solve_tree_path(struct path_t* path, struct maze_tree_t* tree, struct location_t start, struct location_t end);
+
+
+#endif // MAZE_TREE_H
@@ -0,0 +1,184 @@
+#ifndef NODE_QUEUE_H
+#define NODE_QUEUE_H
+
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "node.h"
+#include "maze_size.h"
+
+
+/**
+ * Represents a node waiting in a node queue.
+ *
+ * This struct pairs a node with the cost used to order it in the queue, along
+ * with the order in which it was first queued, so that nodes of equal cost are
+ * removed in the order they were added.
+ */
+struct queued_node_t
+{
+    struct node_t node;
+    size_t cost;
+    size_t order;
+};
+
+/**
+ * Represents a dynamically allocated priority queue of nodes.
+ *
+ * This struct contains a binary heap of queued nodes ordered by cost, along
+ * with an array indexed by location (see location_index()) which holds the
+ * position of each location in the heap, offset by one so that zero indicates
+ * that the location is not queued. This allows the node queued at a location to
+ * be found and updated without searching the heap. The queue also counts the
+ * pushes merged with a node already queued and the greatest number of nodes it
+ * has held, which along with the order of the last node queued describe the
+ * work done by a search using it.
+ *
+ * \see test_node_queue()
+ */
+struct node_queue_t
+{
+    struct queued_node_t* nodes;
+    size_t* positions;
+    struct maze_size_t size;
+    size_t length;
+    size_t capacity;
+    size_t order;
+    size_t merges;
+    size_t peak_length;
+};
+
+/**
+ * Creates a node queue for the locations of a maze of a given size.
+ *
+ * This function attempts to initialize all the properties of the given pointer
+ * after allocating a section of memory for the heap, big enough to store the
+ * given initial capacity, and a section of memory for the position of every
+ * location in a maze of the given size.
+ *
+ * \param [out] queue
+ *     A pointer to the node queue variable that will be initialized.
+ * \param [in]  size
+ *     The size of the maze containing the locations of the queued nodes.
+ * \param [in]  initial_capacity
+ *     The initial storage capacity of the node queue.
+ *
+ * \pre
+ *     The pointer to the node queue variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int make_queue(struct node_queue_t* queue, struct maze_size_t size, size_t initial_capacity);
+
+/**
+ * Releases the memory held by a node queue.
+ *
+ * This function frees the heap and position arrays of the given queue and
+ * resets its properties, such that the queue is empty with no capacity.
+ *
+ * \param [in,out] queue
+ *     A pointer to the node queue to free.
+ *
+ * \pre
+ *     The pointer to the node queue variable must not be NULL.
+ */
+void free_queue(struct node_queue_t* queue);
+
+/**
+ * Pushes a node onto a node queue with a given cost.
+ *
+ * This function attempts to add the given node to the queue, resizing the heap
+ * if necessary. If a node with the same location is already queued, the two are
+ * merged: the queued node is replaced by the given node only if the given cost
+ * is lower, in which case the node is moved up the heap to reflect its new
+ * cost.
+ *
+ * \param [in,out] queue
+ *     A pointer to the node queue to push the node onto.
+ * \param [in]     node
+ *     A pointer to the node to push.
+ * \param [in]     cost
+ *     The cost used to order the node in the queue.
+ *
+ * \pre
+ *     The pointer to the node queue variable must not be NULL.
+ * \pre
+ *     The pointer to the node variable must not be NULL.
+ * \pre
+ *     The location of the node must be within the maze of the queue.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int push_node(struct node_queue_t* queue, struct node_t* node, size_t cost);
+
+/**
+ * Pops the node with the lowest cost from a node queue.
+ *
+ * This function removes the node at the top of the heap, copying it to the
+ * given pointer, and restores the heap ordering. Of the nodes with the lowest
+ * cost, the one that was queued first is popped.
+ *
+ * \param [in,out] queue
+ *     A pointer to the node queue to pop the node from.
+ * \param [out]    node
+ *     A pointer to the node variable which will contain the popped node.
+ *
+ * \pre
+ *     The pointer to the node queue variable must not be NULL.
+ * \pre
+ *     The pointer to the node variable must not be NULL.
+ * \pre
+ *     The node queue must not be empty.
+ *
+ * \returns
+ *     The cost of the popped node.
+ */
+size_t pop_node(struct node_queue_t* queue, struct node_t* node);
+
+/**
+ * Removes the node with a given location from a node queue.
+ *
+ * This function finds the position of the given location in the heap, moves the
+ * bottom of the heap into its place and restores the heap ordering. Removing a
+ * node and pushing it again allows its cost to be raised as well as lowered.
+ *
+ * \param [in,out] queue
+ *     A pointer to the node queue to remove the node from.
+ * \param [in]     location
+ *     The location of the node to remove.
+ *
+ * \pre
+ *     The pointer to the node queue variable must not be NULL.
+ * \pre
+ *     The location must be within the maze of the queue.
+ *
+ * \returns
+ *     Whether there was a node with the given location in the queue.
+ */
+bool remove_queued_node(struct node_queue_t* queue, struct location_t location);
+
+/**
+ * Determines if there is a node with a given location in a queue.
+ *
+ * This function simply checks the position of the given location in the queue.
+ *
+ * \param [in] queue
+ *     A pointer to the node queue.
+ * \param [in] location
+ *     The location of the node to be found.
+ *
+ * \pre
+ *     The pointer to the node queue variable must not be NULL.
+ * \pre
+ *     The location must be within the maze of the queue.
+ *
+ * \returns
+ *     Whether there is a node with the given location in the queue.
+ */
+bool queued_node(struct node_queue_t* queue, struct location_t location);
+
+
+#endif // NODE_QUEUE_H
@@ -0,0 +1,79 @@
+#ifndef PARALLEL_SEARCH_H
+#define PARALLEL_SEARCH_H
+
+
+#include <stddef.h>
+
+
+struct maze_t;
+struct node_list_t;
+struct search_stats_t;
+
+/**
+ * Solves a given maze using breadth-first search across multiple threads.
+ *
+ * This function attempts to find a shortest path from the end of the given maze
+ * back to the start, expanding the search one level at a time. The frontier of
+ * each level is split evenly between the given number of threads, which claim
+ * the locations they reach by atomically setting their bits in a shared visited
+ * bitmap, and record the action leading back towards the end at each location
+ * they claim. The threads wait for each other at the end of every level, after
+ * which the locations they claimed are gathered into the frontier of the next
+ * level. Once the start has been reached, the path is appended to the given
+ * list using append_path(), such that the final node in the list will be the
+ * start of the maze. Only the nodes that form the path are inserted into the
+ * list.
+ *
+ * \see test_solve_maze_parallel()
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ * \param [in]  threads
+ *     The number of threads to search with, including the calling thread.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ * \pre
+ *     The number of threads must not be zero.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int solve_maze_parallel(struct node_list_t* list, struct maze_t maze, size_t threads);
+
+/**
+ * Solves a given maze using breadth-first search across multiple threads,
+ * recording the work done.
+ *
+ * This function behaves in the same way as solve_maze_parallel(), and also
+ * records the locations expanded and claimed in the given statistics, if the
+ * given pointer is not NULL. The counts are taken between levels, while the
+ * other threads are waiting, so recording them costs the threads nothing. Each
+ * location is claimed at most once, so no push is a duplicate.
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ * \param [in]  threads
+ *     The number of threads to search with, including the calling thread.
+ * \param [out] stats
+ *     A pointer to the statistics variable which will record the work done, or
+ *     NULL.
+ *
+ * \pre
+ *     The pointer to the node list variable must not be NULL.
+ * \pre
+ *     The number of threads must not be zero.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int solve_maze_parallel_measured(struct node_list_t* list, struct maze_t maze, size_t threads, struct search_stats_t* stats);
+
+
+#endif // PARALLEL_SEARCH_H
@@ -0,0 +1,82 @@
+#ifndef PATH_H
+#define PATH_H
+
+
+#include <stddef.h>
+
+
+struct node_t;
+
+/**
+ * Represents the sequence of actions taken along a path through a maze.
+ *
+ * This struct contains a pointer to a dynamically allocated array holding the
+ * action taken at each step of the path, one byte per step, along with the
+ * number of steps. Collecting the actions in memory means the length of the
+ * path is known before any of it is written.
+ *
+ * \see test_path()
+ */
+struct path_t
+{
+    unsigned char* actions;
+    size_t length;
+};
+
+/**
+ * Represents an encoding that a path can be written in.
+ *
+ * PATH_TEXT writes the number of actions on the first line, followed by a
+ * character for each action ('R', 'D', 'L' or 'U') on the second.
+ *
+ * PATH_RUN_LENGTH writes the number of actions on the first line, followed on
+ * the second by each run of repeated actions as the character for the action
+ * and the length of the run, such as "R4D4".
+ *
+ * PATH_BINARY writes the number of actions as an unsigned 64-bit integer in
+ * the byte order of the machine, followed by each action in two bits, four
+ * actions to a byte, with the first action in the lowest two bits.
+ */
+enum path_encoding_t
+{
+    PATH_TEXT,
+    PATH_RUN_LENGTH,
+    PATH_BINARY
+};
+
+/**
+ * Creates a path from the actions taken between a linked list of nodes.
+ *
+ * This function follows the parent nodes of the given start node once to count
+ * the steps, allocates an array big enough for every action, and then follows
+ * them again to determine the action taken at each step.
+ *
+ * \param [out] path
+ *     A pointer to the path variable that will be initialized.
+ * \param [in]  start
+ *     The start node of the solved path.
+ *
+ * \pre
+ *     The pointer to the path variable must not be NULL.
+ * \pre
+ *     The pointer to the start node must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, including when two consecutive nodes are not next to each
+ *     other, 0 on success.
+ */
+int make_path(struct path_t* path, struct node_t* start);
+
+/**
+ * Releases the memory held by a path.
+ *
+ * \param [in,out] path
+ *     A pointer to the path to free.
+ *
+ * \pre
+ *     The pointer to the path variable must not be NULL.
+ */
+void free_path(struct path_t* path);
+
+
+#endif // PATH_H
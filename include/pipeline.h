@@ -0,0 +1,61 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "path.h"
+
+
+struct batch_t;
+
+/**
+ * Represents the number of threads working on each stage of a pipeline, and
+ * the number of mazes which can wait between stages.
+ */
+struct pipeline_widths_t
+{
+    size_t parsers;
+    size_t solvers;
+    size_t writers;
+    size_t depth;
+};
+
+/**
+ * Solves every maze in a batch with a pipeline of threads.
+ *
+ * This function runs three stages at once: parser threads read each maze file,
+ * solver threads find a path through each maze, and writer threads write each
+ * path to its file, so reading and writing files overlaps with solving mazes.
+ * The stages are connected by bounded queues (see bounded_queue_t), each able
+ * to hold the given depth of mazes. A thread which finds the next queue full
+ * waits for it to drain, so a slow stage holds back the stages before it
+ * rather than letting mazes pile up in memory. Each solver thread keeps a node
+ * list and the buffers of a compact search for all of its mazes, as in
+ * solve_batch(). The result of each job is stored in the job, and a line
+ * reporting the result is written to the given status file as each job is
+ * completed.
+ *
+ * \see test_pipeline()
+ *
+ * \param [in,out] batch
+ *     A pointer to the batch to solve.
+ * \param [in]     widths
+ *     The number of threads in each stage, each of which must be at least 1,
+ *     and the depth of the queues, which must be a power of two and at least 2.
+ * \param [in]     encoding
+ *     The encoding to write each path in.
+ * \param [in]     status
+ *     The file handle to report the result of each job to, or NULL.
+ *
+ * \pre
+ *     The pointer to the batch variable must not be NULL.
+ *
+ * \returns
+ *     -1 if any job failed, 0 if every job succeeded.
+ */
+int run_pipeline(struct batch_t* batch, struct pipeline_widths_t widths, enum path_encoding_t encoding, FILE* status);
+
+
+#endif // PIPELINE_H
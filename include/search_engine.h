@@ -0,0 +1,73 @@
+#ifndef SEARCH_ENGINE_H
+#define SEARCH_ENGINE_H
+
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "maze.h"
+
+
+struct node_list_t;
+struct search_stats_t;
+
+/**
+ * Represents a search algorithm that can be selected by name to solve a maze.
+ *
+ * This struct pairs the name of a search with a function which solves a maze
+ * with it, and a function which also records the work done, or NULL if the
+ * search cannot record it. Both share the signature of solve_maze(), so that
+ * the searches can be run interchangeably by the program and the benchmarks.
+ * It also indicates whether the search shares its work between the number of
+ * threads set by set_search_threads().
+ *
+ * \see test_search_engines()
+ */
+struct search_engine_t
+{
+    const char* name;
+    void (*solve)(struct node_list_t* list, struct maze_t maze);
+    void (*measure)(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats);
+    bool threaded;
+};
+
+/**
+ * The search algorithms that can be selected by name, the first of which is
+ * used by default.
+ */
+extern const struct search_engine_t search_engines[];
+
+/**
+ * The number of search algorithms in search_engines.
+ */
+extern const size_t search_engine_count;
+
+/**
+ * Sets the number of threads used by the searches which share their work
+ * between threads, which is one until set.
+ *
+ * \param [in] threads
+ *     The number of threads to use, including the calling thread.
+ *
+ * \pre
+ *     The number of threads must not be zero.
+ */
+void set_search_threads(size_t threads);
+
+/**
+ * Finds the search algorithm with a given name.
+ *
+ * \param [in] name
+ *     The name of the search algorithm.
+ *
+ * \pre
+ *     The name must not be NULL.
+ *
+ * \returns
+ *     A pointer to the search algorithm, or NULL if there is none with the
+ *     given name.
+ */
+const struct search_engine_t* find_search_engine(const char* name);
+
+
+#endif // SEARCH_ENGINE_H
@@ -0,0 +1,255 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "maze.h"
+#include "node_list.h"
+#include "compact_search.h"
+
+
+/**
+ * Represents a maze held in a maze cache.
+ *
+ * This struct contains the name of the file the maze was read from, the maze
+ * itself and the number of bytes it occupies, along with the number of queries
+ * currently using it and its neighbours in the list of entries ordered from
+ * most to least recently used. An entry which has been unloaded while still in
+ * use is removed from the list, and freed once the last query releases it.
+ */
+struct maze_entry_t
+{
+    char* name;
+    struct maze_t maze;
+    size_t bytes;
+    size_t users;
+    bool unloaded;
+    struct maze_entry_t* newer;
+    struct maze_entry_t* older;
+};
+
+/**
+ * Represents a cache of mazes shared by many threads.
+ *
+ * This struct contains the list of cached entries ordered from most to least
+ * recently used, protected by a mutex, along with the total number of bytes
+ * occupied by the mazes and the number of bytes they may occupy before the
+ * least recently used mazes which are not in use are evicted. Mazes are never
+ * changed once loaded, so any number of threads can solve the same maze at
+ * once.
+ *
+ * \see test_maze_cache()
+ */
+struct maze_cache_t
+{
+    pthread_mutex_t mutex;
+    struct maze_entry_t* newest;
+    struct maze_entry_t* oldest;
+    size_t bytes;
+    size_t budget;
+};
+
+/**
+ * Creates an empty maze cache.
+ *
+ * \param [out] cache
+ *     A pointer to the maze cache variable that will be initialized.
+ * \param [in]  budget
+ *     The number of bytes the cached mazes may occupy.
+ *
+ * \pre
+ *     The pointer to the maze cache variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int make_maze_cache(struct maze_cache_t* cache, size_t budget);
+
+/**
+ * Releases the memory held by a maze cache, including every cached maze.
+ *
+ * \param [in,out] cache
+ *     A pointer to the maze cache to free.
+ *
+ * \pre
+ *     The pointer to the maze cache variable must not be NULL.
+ * \pre
+ *     No maze in the cache may be in use.
+ */
+void free_maze_cache(struct maze_cache_t* cache);
+
+/**
+ * Gets a maze from a cache for use by a query, reading it first if it is not
+ * already cached.
+ *
+ * This function finds the entry for the named file, reading the file with
+ * read_maze_file() if there is none, and marks it as the most recently used.
+ * The file is read without holding the lock, so that other queries are not
+ * held up. The entry cannot be evicted or freed until it is released with
+ * release_maze().
+ *
+ * \param [in,out] cache
+ *     A pointer to the maze cache.
+ * \param [in]     name
+ *     The name of the maze file.
+ * \param [out]    entry
+ *     A pointer to the variable which will contain the pointer to the entry.
+ *
+ * \pre
+ *     The pointer to the maze cache variable must not be NULL.
+ * \pre
+ *     The name must not be NULL.
+ * \pre
+ *     The pointer to the entry variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int acquire_maze(struct maze_cache_t* cache, const char* name, struct maze_entry_t** entry);
+
+/**
+ * Releases a maze acquired from a cache.
+ *
+ * This function marks the entry as no longer used by the query, freeing it if
+ * it has been unloaded, then evicts the least recently used entries which are
+ * not in use until the cache is within its budget.
+ *
+ * \param [in,out] cache
+ *     A pointer to the maze cache.
+ * \param [in,out] entry
+ *     A pointer to the entry to release.
+ *
+ * \pre
+ *     The pointer to the maze cache variable must not be NULL.
+ * \pre
+ *     The entry must have been acquired with acquire_maze().
+ */
+void release_maze(struct maze_cache_t* cache, struct maze_entry_t* entry);
+
+/**
+ * Removes a maze from a cache.
+ *
+ * \param [in,out] cache
+ *     A pointer to the maze cache.
+ * \param [in]     name
+ *     The name of the maze file.
+ *
+ * \pre
+ *     The pointer to the maze cache variable must not be NULL.
+ * \pre
+ *     The name must not be NULL.
+ *
+ * \returns
+ *     -1 if the maze is not cached, 0 on success.
+ */
+int unload_maze(struct maze_cache_t* cache, const char* name);
+
+/**
+ * Represents the state kept by a solver server for a single connection.
+ *
+ * This struct contains the shared maze cache, along with a node list and the
+ * buffers of a compact search reused by every query on the connection, so that
+ * a query against a cached maze does not allocate memory unless the maze is
+ * bigger than any solved before on the connection.
+ */
+struct solver_session_t
+{
+    struct maze_cache_t* cache;
+    struct node_list_t list;
+    struct compact_search_t search;
+};
+
+/**
+ * Creates the state for a connection to a solver server.
+ *
+ * \param [out] session
+ *     A pointer to the solver session variable that will be initialized.
+ * \param [in]  cache
+ *     A pointer to the maze cache shared by every connection.
+ *
+ * \pre
+ *     The pointer to the solver session variable must not be NULL.
+ * \pre
+ *     The pointer to the maze cache variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int make_solver_session(struct solver_session_t* session, struct maze_cache_t* cache);
+
+/**
+ * Releases the memory held by the state for a connection to a solver server.
+ *
+ * \param [in,out] session
+ *     A pointer to the solver session to free.
+ *
+ * \pre
+ *     The pointer to the solver session variable must not be NULL.
+ */
+void free_solver_session(struct solver_session_t* session);
+
+/**
+ * Answers a single request to a solver server.
+ *
+ * This function carries out the request on the given line, which must be one
+ * of the following, with values separated by whitespace:
+ *
+ * load file: caches the maze, answering "ok rows columns".
+ * solve file start_row start_column end_row end_column: finds a shortest path
+ * between the given locations of the cached maze, loading it if needed, and
+ * answers "ok length actions", with a character for each action as written by
+ * write_path().
+ * unload file: removes the maze from the cache, answering "ok".
+ *
+ * Any request which fails is answered with "error" followed by a reason. Each
+ * answer is written as a single line.
+ *
+ * \param [in,out] session
+ *     A pointer to the solver session of the connection.
+ * \param [in,out] line
+ *     The line holding the request, which is split in place.
+ * \param [in]     fp
+ *     The file handle to write the answer to.
+ *
+ * \pre
+ *     The pointer to the solver session variable must not be NULL.
+ * \pre
+ *     The line must not be NULL.
+ * \pre
+ *     The file pointer must not be NULL.
+ *
+ * \returns
+ *     -1 if the request failed, 0 on success.
+ */
+int answer_request(struct solver_session_t* session, char* line, FILE* fp);
+
+/**
+ * Runs a solver server on a Unix domain socket.
+ *
+ * This function listens on a socket at the given path, replacing any socket
+ * left there, and answers the requests on each connection with answer_request()
+ * on a thread of its own, one line at a time, until the connection is closed.
+ * Every connection shares a single maze cache. A client which goes away before
+ * reading its answers only ends its own connection, as SIGPIPE is ignored. It
+ * only returns if the server cannot be started, including when something other
+ * than a socket exists at the path, or stops accepting connections.
+ *
+ * \param [in] path
+ *     The path of the socket.
+ * \param [in] budget
+ *     The number of bytes the cached mazes may occupy.
+ *
+ * \pre
+ *     The path must not be NULL.
+ *
+ * \returns
+ *     -1.
+ */
+int run_server(const char* path, size_t budget);
+
+
+#endif // SERVER_H
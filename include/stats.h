@@ -0,0 +1,133 @@
+#ifndef STATS_H
+#define STATS_H
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "node_list.h"
+
+
+/**
+ * Represents the work done by a search while solving a maze.
+ *
+ * This struct contains the number of nodes expanded by the search, the number
+ * of nodes pushed onto its frontier, how many of those pushes were merged with
+ * a node already in the frontier, and the greatest number of nodes the
+ * frontier held at once. Searches which expand locations rather than nodes
+ * count locations instead, and searches which cannot record these leave them
+ * out, so the struct also indicates whether they were recorded.
+ *
+ * \see solve_maze_measured()
+ * \see solve_maze_a_star_measured()
+ */
+struct search_stats_t
+{
+    bool recorded;
+    size_t expansions;
+    size_t pushes;
+    size_t duplicate_pushes;
+    size_t frontier_peak;
+};
+
+/**
+ * Represents the statistics gathered while solving a single maze.
+ *
+ * This struct contains the work done by the search, the size of the maze, the
+ * number of actions in the path found, the greatest number of nodes held by the
+ * node list of the search, and the time in nanoseconds spent reading the
+ * maze, solving it and writing the path, as measured by monotonic_time().
+ *
+ * \see test_solve_stats()
+ */
+struct solve_stats_t
+{
+    struct search_stats_t search;
+    size_t rows;
+    size_t columns;
+    size_t path_length;
+    size_t list_peak_length;
+    uint64_t read_time;
+    uint64_t solve_time;
+    uint64_t write_time;
+};
+
+/**
+ * Represents a format that statistics can be written in.
+ */
+enum stats_format_t
+{
+    STATS_TEXT,
+    STATS_JSON
+};
+
+/**
+ * Creates an empty set of statistics.
+ *
+ * \param [out] stats
+ *     A pointer to the statistics variable that will be initialized.
+ *
+ * \pre
+ *     The pointer to the statistics variable must not be NULL.
+ */
+void make_solve_stats(struct solve_stats_t* stats);
+
+/**
+ * Gets the current time of the monotonic clock.
+ *
+ * \returns
+ *     The current time in nanoseconds, measured from an arbitrary point which
+ *     does not change while the program runs.
+ */
+uint64_t monotonic_time(void);
+
+/**
+ * Records the path and memory of a solved maze in a set of statistics.
+ *
+ * This function counts the actions of the path from the final node of the given
+ * list, which must be the start of the maze, and records the number of nodes
+ * in the list. No search removes nodes from the list, so this is its peak,
+ * unlike its capacity, which depends on how the list was created.
+ *
+ * \param [in,out] stats
+ *     A pointer to the statistics.
+ * \param [in]     list
+ *     A pointer to the node list filled by the search.
+ *
+ * \pre
+ *     The pointer to the statistics variable must not be NULL.
+ * \pre
+ *     The pointer to the node list variable must not be NULL, and the list must
+ *     not be empty.
+ */
+void measure_solution(struct solve_stats_t* stats, struct node_list_t* list);
+
+/**
+ * Writes a set of statistics to a file.
+ *
+ * This function writes the statistics either as lines of text, with a name and
+ * a value on each, or as a single JSON object. Counters of the search which
+ * were not recorded are left out of the text and written as null in JSON, and
+ * times are written in seconds.
+ *
+ * \param [in] stats
+ *     A pointer to the statistics.
+ * \param [in] format
+ *     The format to write the statistics in.
+ * \param [in] fp
+ *     The file handle to write the statistics to.
+ *
+ * \pre
+ *     The pointer to the statistics variable must not be NULL.
+ * \pre
+ *     The file pointer must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+int write_solve_stats(const struct solve_stats_t* stats, enum stats_format_t format, FILE* fp);
+
+
+#endif // STATS_H
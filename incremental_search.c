@@ -0,0 +1,380 @@
+#include "incremental_search.h"
+
+#include "action.h"
+#include "action_set.h"
+#include "maze_size.h"
+#include "node.h"
+#include "node_list.h"
+#include "stats.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/**
+ * \internal
+ *
+ * Gets the cost used to order a location in the frontier of an incremental
+ * search.
+ *
+ * \param [in] search
+ *     A pointer to the incremental search.
+ * \param [in] location
+ *     The location to get the cost of.
+ *
+ * \returns
+ *     The cost of the location, or SIZE_MAX if it is not reached.
+ */
+static size_t location_cost(const struct incremental_search_t* search, struct location_t location);
+
+/**
+ * \internal
+ *
+ * Finds the location leading to a given location which is nearest to the start
+ * of the maze of an incremental search.
+ *
+ * This helper function checks each location around the given location for an
+ * action leading back to it.
+ *
+ * \param [in]  search
+ *     A pointer to the incremental search.
+ * \param [in]  location
+ *     The location to find the nearest way into.
+ * \param [out] nearest
+ *     A pointer to the variable which will contain the nearest location, if
+ *     any location leads to the given location.
+ *
+ * \returns
+ *     The g distance of the nearest location, or UINT32_MAX if no location
+ *     leading to the given location has been reached.
+ */
+static uint32_t find_nearest(const struct incremental_search_t* search, struct location_t location, struct location_t* nearest);
+
+/**
+ * \internal
+ *
+ * Recalculates the rhs distance of a location of an incremental search and
+ * queues the location if it is left inconsistent.
+ *
+ * \param [in,out] search
+ *     A pointer to the incremental search.
+ * \param [in]     location
+ *     The location to update.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int update_location(struct incremental_search_t* search, struct location_t location);
+
+/**
+ * \internal
+ *
+ * Appends the path read back from the end of the maze of an incremental search
+ * to a node list.
+ *
+ * \param [out] list
+ *     A pointer to the node list.
+ * \param [in]  search
+ *     A pointer to the incremental search, whose end must be consistent.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int append_incremental_path(struct node_list_t* list, const struct incremental_search_t* search);
+
+// Define make_incremental_search (incremental_search.h).
+int make_incremental_search(struct incremental_search_t* search, struct maze_t maze)
+{
+    // Assert that the pointer to the incremental search variable is valid.
+    assert(search != NULL);
+
+    size_t length = maze.size.rows * maze.size.columns;
+
+    // Indicate failure if the distances cannot be held in 32 bits, leaving
+    // UINT32_MAX for locations which are not reached, or if the greatest cost
+    // of the frontier would overflow.
+    if (length >= UINT32_MAX) return -1;
+    if (length + maze.size.rows + maze.size.columns > SIZE_MAX / (length + 1)) return -1;
+
+    search->maze = maze;
+    search->scale = length + 1;
+    search->solved_order = 0;
+
+    search->distances = (uint32_t*) malloc(length * sizeof(uint32_t));
+    search->lookaheads = (uint32_t*) malloc(length * sizeof(uint32_t));
+
+    if (search->distances == NULL || search->lookaheads == NULL)
+    {
+        free(search->lookaheads);
+        free(search->distances);
+        return -1;
+    }
+
+    if (make_queue(&search->frontier, maze.size, 64) != 0)
+    {
+        free(search->lookaheads);
+        free(search->distances);
+        return -1;
+    }
+
+    memset(search->distances, 0xFF, length * sizeof(uint32_t));
+    memset(search->lookaheads, 0xFF, length * sizeof(uint32_t));
+
+    // The start is reached by taking no actions, but has not been expanded.
+    search->lookaheads[location_index(maze.size, maze.start)] = 0;
+
+    struct node_t node = { maze.start, NULL };
+    if (push_node(&search->frontier, &node, location_cost(search, maze.start)) != 0)
+    {
+        free_incremental_search(search);
+        return -1;
+    }
+
+    return 0;
+}
+
+// Define free_incremental_search (incremental_search.h).
+void free_incremental_search(struct incremental_search_t* search)
+{
+    // Assert that the pointer to the incremental search variable is valid.
+    assert(search != NULL);
+
+    free_queue(&search->frontier);
+    free(search->lookaheads);
+    free(search->distances);
+
+    search->distances = NULL;
+    search->lookaheads = NULL;
+}
+
+// Define update_incremental_search (incremental_search.h).
+int update_incremental_search(struct incremental_search_t* search, const struct location_t* locations, size_t count)
+{
+    // Assert that the pointer to the incremental search variable is valid.
+    assert(search != NULL);
+
+    for (size_t position = 0; position < count; position++)
+    {
+        struct location_t location = locations[position];
+
+        // Assert that the location is within the maze.
+        assert(check_location(search->maze.size, location));
+
+        // The actions leaving the location lead into the locations around it,
+        // so only their rhs distances can have changed, but the location itself
+        // is updated too in case the maze was changed on both sides of a wall.
+        if (update_location(search, location) != 0) return -1;
+
+        for (enum action_t action = EAST; action <= NORTH; action++)
+        {
+            struct location_t next = action_result(location, action);
+            if (!check_location(search->maze.size, next)) continue;
+
+            if (update_location(search, next) != 0) return -1;
+        }
+    }
+
+    return 0;
+}
+
+// Define solve_incremental_search (incremental_search.h).
+int solve_incremental_search(struct node_list_t* list, struct incremental_search_t* search, struct search_stats_t* stats)
+{
+    // Assert that the pointer to the node list variable is valid.
+    assert(list != NULL);
+    // Assert that the pointer to the incremental search variable is valid.
+    assert(search != NULL);
+
+    struct maze_t maze = search->maze;
+    size_t end_index = location_index(maze.size, maze.end);
+
+    size_t expansions = 0;
+    int result = 0;
+
+    while (result == 0 && search->frontier.length > 0)
+    {
+        // Stop once the end is consistent and no location waiting, the cheapest
+        // of which is at the top of the heap, could lead to it any sooner.
+        if (search->distances[end_index] == search->lookaheads[end_index]
+         && search->frontier.nodes[0].cost >= location_cost(search, maze.end))
+        {
+            break;
+        }
+
+        // Get the next location to expand.
+        struct node_t node;
+        pop_node(&search->frontier, &node);
+        size_t index = location_index(maze.size, node.location);
+        expansions++;
+
+        if (search->distances[index] > search->lookaheads[index])
+        {
+            // The location is reached sooner than before, so settle it at its
+            // new distance.
+            search->distances[index] = search->lookaheads[index];
+        }
+        else
+        {
+            // The location is reached later than before, so forget its distance
+            // and queue it again to find its new one.
+            search->distances[index] = UINT32_MAX;
+            result = update_location(search, node.location);
+        }
+
+        // Update every location the actions available from this one lead to.
+        enum action_set_t action_set = get_action_set(maze, node.location);
+
+        for (enum action_t action = EAST; result == 0 && action <= NORTH; action++)
+        {
+            // Check if the action is contained in the set of actions.
+            if (!(action_set & (1 << action))) continue;
+
+            struct location_t next = action_result(node.location, action);
+            if (!check_location(maze.size, next)) continue;
+
+            result = update_location(search, next);
+        }
+    }
+
+    // Record the work done since the maze was last solved.
+    if (stats != NULL)
+    {
+        stats->recorded = true;
+        stats->expansions = expansions;
+        stats->pushes = search->frontier.order - search->solved_order + search->frontier.merges;
+        stats->duplicate_pushes = search->frontier.merges;
+        stats->frontier_peak = search->frontier.peak_length;
+    }
+
+    search->solved_order = search->frontier.order;
+    search->frontier.merges = 0;
+    search->frontier.peak_length = search->frontier.length;
+
+    if (result != 0) return -1;
+
+    // Indicate failure if the end cannot be reached.
+    if (search->lookaheads[end_index] == UINT32_MAX) return -1;
+
+    return append_incremental_path(list, search);
+}
+
+// Define solve_maze_incremental (incremental_search.h).
+int solve_maze_incremental(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats)
+{
+    // Assert that the pointer to the node list variable is valid.
+    assert(list != NULL);
+
+    struct incremental_search_t search;
+    if (make_incremental_search(&search, maze) != 0) return -1;
+
+    int result = solve_incremental_search(list, &search, stats);
+
+    free_incremental_search(&search);
+
+    return result;
+}
+
+// Define location_cost (incremental_search.c).
+static size_t location_cost(const struct incremental_search_t* search, struct location_t location)
+{
+    size_t index = location_index(search->maze.size, location);
+
+    uint32_t distance = search->distances[index];
+    if (search->lookaheads[index] < distance) distance = search->lookaheads[index];
+
+    if (distance == UINT32_MAX) return SIZE_MAX;
+
+    // Order by the estimated length of a path through the location first, then
+    // prefer locations nearer the start, which are settled before those they
+    // lead to.
+    size_t estimate = distance + location_manhattan(location, search->maze.end);
+
+    return estimate * search->scale + distance;
+}
+
+// Define find_nearest (incremental_search.c).
+static uint32_t find_nearest(const struct incremental_search_t* search, struct location_t location, struct location_t* nearest)
+{
+    uint32_t best = UINT32_MAX;
+
+    for (enum action_t action = EAST; action <= NORTH; action++)
+    {
+        struct location_t previous = action_result(location, action);
+        if (!check_location(search->maze.size, previous)) continue;
+
+        // Check that the location around this one has an action leading back.
+        enum action_set_t action_set = get_action_set(search->maze, previous);
+        if (!(action_set & (1 << reverse_action(action)))) continue;
+
+        uint32_t distance = search->distances[location_index(search->maze.size, previous)];
+        if (distance >= best) continue;
+
+        best = distance;
+        *nearest = previous;
+    }
+
+    return best;
+}
+
+// Define update_location (incremental_search.c).
+static int update_location(struct incremental_search_t* search, struct location_t location)
+{
+    // The start is always reached by taking no actions.
+    if (location_equal(location, search->maze.start)) return 0;
+
+    size_t index = location_index(search->maze.size, location);
+
+    struct location_t nearest;
+    uint32_t distance = find_nearest(search, location, &nearest);
+    search->lookaheads[index] = (distance == UINT32_MAX) ? UINT32_MAX : distance + 1;
+
+    // Queue the location at its new cost only if it is inconsistent.
+    remove_queued_node(&search->frontier, location);
+    if (search->distances[index] == search->lookaheads[index]) return 0;
+
+    struct node_t node = { location, NULL };
+    return push_node(&search->frontier, &node, location_cost(search, location));
+}
+
+// Define append_incremental_path (incremental_search.c).
+static int append_incremental_path(struct node_list_t* list, const struct incremental_search_t* search)
+{
+    struct maze_t maze = search->maze;
+    uint32_t length = search->distances[location_index(maze.size, maze.end)];
+
+    // Make space for a node at every location on the path, so that the parents
+    // of the nodes are not moved as they are appended. The distances strictly
+    // decrease along the path, so it cannot be longer than the distance of the
+    // end.
+    if (list->capacity < list->length + length + 1)
+    {
+        if (resize_list(list, list->length + length + 1) != 0) return -1;
+    }
+
+    struct node_t node = { maze.end, NULL };
+    if (insert_node(list, &node, list->length) != 0) return -1;
+
+    struct location_t location = maze.end;
+    uint32_t distance = length;
+
+    // Walk back to the start, always taking the nearest location leading to
+    // the current one.
+    while (!location_equal(location, maze.start))
+    {
+        struct location_t nearest;
+        uint32_t nearest_distance = find_nearest(search, location, &nearest);
+
+        // Indicate failure if the distances do not lead back to the start.
+        if (nearest_distance >= distance) return -1;
+
+        location = nearest;
+        distance = nearest_distance;
+
+        node = (struct node_t) { location, get_node(list, list->length - 1) };
+        if (insert_node(list, &node, list->length) != 0) return -1;
+    }
+
+    return 0;
+}
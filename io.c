@@ -5,11 +5,87 @@
 #include "maze_size.h"
 #include "action_set.h"
 #include "maze.h"
+#include "node_list.h"
+#include "location_set.h"
 
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+/**
+ * \internal
+ *
+ * The bytes at the beginning of every binary maze file.
+ */
+static const char maze_file_magic[4] = { 'M', 'A', 'Z', 'E' };
+
+/**
+ * \internal
+ *
+ * The version of the binary maze format written by write_maze_binary().
+ */
+#define MAZE_FILE_VERSION 2
+
+/**
+ * \internal
+ *
+ * Represents the header of a binary maze file.
+ *
+ * This struct is written to the start of the file exactly as it is laid out in
+ * memory, taking 64 bytes, so that the action sets which follow it begin at an
+ * offset aligned for any access.
+ */
+struct maze_header_t
+{
+    char magic[4];
+    uint32_t version;
+    uint64_t rows;
+    uint64_t columns;
+    uint64_t start_row;
+    uint64_t start_column;
+    uint64_t end_row;
+    uint64_t end_column;
+    uint64_t checksum;
+};
+
+/**
+ * \internal
+ *
+ * The shades of gray used for each part of an image of a maze. The explored
+ * locations range from IMAGE_EXPLORED to IMAGE_EXPLORED + IMAGE_EXPLORED_RANGE.
+ */
+#define IMAGE_WALL 0
+#define IMAGE_PATH 48
+#define IMAGE_EXPLORED 96
+#define IMAGE_EXPLORED_RANGE 136
+#define IMAGE_OPEN 255
+
+/**
+ * \internal
+ *
+ * The approximate number of bytes of pixels rendered at once by
+ * write_maze_image().
+ */
+#define IMAGE_BAND_BYTES (1 << 20)
+
+/**
+ * \internal
+ *
+ * Represents the position of a scan through text in memory.
+ */
+struct scanner_t
+{
+    const char* position;
+    const char* end;
+};
+
 
 /**
  * \internal
@@ -69,15 +145,242 @@ static int read_action_sets(struct maze_t maze, FILE* fp);
 /**
  * \internal
  *
- * Convert the given action into a printable character.
+ * Scans the next number in some text.
+ *
+ * This helper function skips any whitespace, then converts the decimal digits
+ * which follow into a number, leaving the scanner after the final digit.
+ *
+ * \param [out]    value
+ *     A pointer to the variable which will contain the number.
+ * \param [in,out] scanner
+ *     A pointer to the scanner.
+ *
+ * \returns
+ *     -1 on failure, when there is no number, it is too big to hold, or it
+ *     does not end in whitespace, 0 on success.
+ */
+static int scan_number(size_t* value, struct scanner_t* scanner);
+
+/**
+ * \internal
+ *
+ * Scans the contents of a file in memory as a maze.
+ *
+ * \param [out]    maze
+ *     A pointer to the maze variable that will store the maze.
+ * \param [in,out] scanner
+ *     A pointer to the scanner over the contents of the file.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int scan_maze(struct maze_t* maze, struct scanner_t* scanner);
+
+/**
+ * \internal
+ *
+ * Calculates the checksum of the action sets of a binary maze file.
+ *
+ * This helper function hashes the given bytes one at a time using the 64 bit
+ * FNV-1a hash.
+ *
+ * \param [in] data
+ *     A pointer to the bytes to check.
+ * \param [in] length
+ *     The number of bytes to check.
+ *
+ * \returns
+ *     The checksum of the bytes.
+ */
+static uint64_t checksum_action_sets(const unsigned char* data, size_t length);
+
+/**
+ * \internal
+ *
+ * Reads the header of a binary maze file.
+ *
+ * This helper function copies the header out of the start of the file, then
+ * checks that it was written by this version of the format, that it describes a
+ * maze that can be indexed, and that the file holds every set of actions.
+ *
+ * \param [out] header
+ *     A pointer to the header variable that will store the header.
+ * \param [in]  ptr
+ *     A pointer to the start of the file, either mapped or read into memory.
+ * \param [in]  length
+ *     The length of the whole file, which must be at least the size of a
+ *     header.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int read_maze_header(struct maze_header_t* header, const void* ptr, size_t length);
+
+/**
+ * \internal
+ *
+ * Reads and checks the header of an open maze file before it is mapped.
+ *
+ * This helper function reads the start of the file, and if it begins with the
+ * magic number of the binary format, checks its header against the real length
+ * of the file using read_maze_header(), so that a file too short for the maze
+ * its header describes is rejected without being mapped.
+ *
+ * \param [in]  fd
+ *     The file descriptor of the open file.
+ * \param [in]  length
+ *     The length of the file.
+ * \param [out] header
+ *     A pointer to the header variable that will store the header of a binary
+ *     file.
+ * \param [out] binary
+ *     A pointer to the variable which will indicate whether the file is in the
+ *     binary format.
+ *
+ * \returns
+ *     -1 if the file is in the binary format and its header is invalid, 0
+ *     otherwise.
+ */
+static int check_file_header(int fd, size_t length, struct maze_header_t* header, bool* binary);
+
+/**
+ * \internal
+ *
+ * Uses a binary maze file mapped into memory as a maze.
+ *
+ * This helper function validates the header of the mapped file, then
+ * initializes the maze to use the action sets in place, taking ownership of
+ * the mapping. The action sets are not read, so they are not checked against
+ * the checksum in the header (see verify_maze_file()).
+ *
+ * \param [out] maze
+ *     A pointer to the maze variable that will store the maze.
+ * \param [in]  ptr
+ *     A pointer to the start of the mapping.
+ * \param [in]  length
+ *     The length of the mapping.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int map_maze(struct maze_t* maze, void* ptr, size_t length);
+
+/**
+ * \internal
+ *
+ * Writes an ascii character representation of a maze to a file, marking the
+ * locations in the given sets.
+ *
+ * This helper function builds each line of the representation described by
+ * write_maze() in a buffer, copying a block of four characters for each
+ * location, and writes each line to the file in one call. The locations in the
+ * path are marked with '*' and any other locations in the explored set are
+ * marked with '.', in the middle of their block.
+ *
+ * \param [in] maze
+ *     The maze to write to the file.
+ * \param [in] path
+ *     A pointer to the set of locations on the path, or NULL.
+ * \param [in] explored
+ *     A pointer to the set of locations explored, or NULL.
+ * \param [in] fp
+ *     The file handle to write the maze to.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int render_maze(struct maze_t maze, struct location_set_t* path, struct location_set_t* explored, FILE* fp);
+
+/**
+ * \internal
+ *
+ * Sorts the indexes of nodes in a list by the row of their locations.
+ *
+ * This helper function counts the nodes in each row, then places the index of
+ * each node after those of the nodes in earlier rows, keeping nodes in the same
+ * row in their original order. The indexes of the nodes in a row r are then
+ * found between (*items)[(*offsets)[r]] and (*items)[(*offsets)[r + 1]].
+ *
+ * \param [out] offsets
+ *     A pointer to the variable which will contain the array of offsets into
+ *     the sorted indexes for each row, with an extra offset for the end.
+ * \param [out] items
+ *     A pointer to the variable which will contain the array of sorted indexes.
+ * \param [in]  list
+ *     A pointer to the node list containing the nodes.
+ * \param [in]  rows
+ *     The number of rows in the maze.
+ * \param [in]  nodes
+ *     A pointer to the array of indexes of the nodes to sort, or NULL to sort
+ *     the first count nodes in the list.
+ * \param [in]  count
+ *     The number of nodes to sort.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int index_by_row(size_t** offsets, size_t** items, struct node_list_t* list, size_t rows, const size_t* nodes, size_t count);
+
+/**
+ * \internal
+ *
+ * Copies a line of pixels, one byte per pixel, into the encoding of the format
+ * of an image.
+ *
+ * \param [in]  image
+ *     A pointer to the image.
+ * \param [in]  pixels
+ *     A pointer to the shade of gray of each pixel in the line.
+ * \param [out] buffer
+ *     A pointer to the buffer which will contain the encoded line.
+ */
+static void encode_image_line(struct maze_image_t* image, const unsigned char* pixels, unsigned char* buffer);
+
+/**
+ * \internal
+ *
+ * Writes a path to a file as text, with a character for each action.
+ *
+ * \param [in] path
+ *     The path to write to the file.
+ * \param [in] fp
+ *     The file handle to write the path to.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int write_text_path(struct path_t path, FILE* fp);
+
+/**
+ * \internal
+ *
+ * Writes a path to a file as text, with a character and a length for each run
+ * of repeated actions.
+ *
+ * \param [in] path
+ *     The path to write to the file.
+ * \param [in] fp
+ *     The file handle to write the path to.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int write_run_length_path(struct path_t path, FILE* fp);
+
+/**
+ * \internal
+ *
+ * Writes a path to a file in binary, with two bits for each action.
  *
- * \param [in] action
- *     The given action.
+ * \param [in] path
+ *     The path to write to the file.
+ * \param [in] fp
+ *     The file handle to write the path to.
  *
  * \returns
- *     A printable character representing the given action.
+ *     -1 on failure, 0 on success.
  */
-static char action_char(enum action_t action);
+static int write_binary_path(struct path_t path, FILE* fp);
 
 // Define read_maze (io.h)
 int read_maze(struct maze_t* maze, FILE* fp)
@@ -111,124 +414,551 @@ int read_maze(struct maze_t* maze, FILE* fp)
     return 0;
 }
 
+// Define read_maze_file (io.h)
+int read_maze_file(struct maze_t* maze, const char* filename)
+{
+    // Assert that the pointer to the maze variable is valid.
+    assert(maze != NULL);
+    // Assert that the file name is valid.
+    assert(filename != NULL);
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return -1;
+
+    // Find the size of the file, as an empty file cannot be mapped.
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    size_t length = (size_t) info.st_size;
+
+    // Check the header of a binary file before mapping it.
+    struct maze_header_t header;
+    bool binary = false;
+
+    if (check_file_header(fd, length, &header, &binary) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    // Map the file into memory. The mapping remains valid once the file is
+    // closed. The mapping is private, so a mapped maze can be written to
+    // without changing the file.
+    void* ptr = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (ptr == MAP_FAILED) return -1;
+
+    // If the file is in the binary format, use it in place.
+    if (binary)
+    {
+        int map_maze_result = map_maze(maze, ptr, length);
+        if (map_maze_result != 0) munmap(ptr, length);
+
+        return map_maze_result;
+    }
+
+    // The text is read from start to end exactly once.
+    posix_madvise(ptr, length, POSIX_MADV_SEQUENTIAL);
+
+    struct scanner_t scanner = { (const char*) ptr, (const char*) ptr + length };
+    int scan_maze_result = scan_maze(maze, &scanner);
+
+    munmap(ptr, length);
+
+    return scan_maze_result;
+}
+
+// Define verify_maze_file (io.h)
+int verify_maze_file(const char* filename)
+{
+    // Assert that the file name is valid.
+    assert(filename != NULL);
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    size_t length = (size_t) info.st_size;
+
+    // Check the header of a binary file before mapping it.
+    struct maze_header_t header;
+    bool binary = false;
+
+    if (check_file_header(fd, length, &header, &binary) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    void* ptr = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (ptr == MAP_FAILED) return -1;
+
+    // The file is read from start to end exactly once.
+    posix_madvise(ptr, length, POSIX_MADV_SEQUENTIAL);
+
+    int result = 0;
+
+    if (binary)
+    {
+        // Check every set of actions in a binary file against its checksum.
+        size_t data_length = (header.rows * header.columns + 1) / 2;
+        const unsigned char* action_sets = (const unsigned char*) ptr + sizeof(header);
+
+        if (checksum_action_sets(action_sets, data_length) != header.checksum) result = -1;
+    }
+    else
+    {
+        // A text file has no checksum, so check that it scans as a maze.
+        struct scanner_t scanner = { (const char*) ptr, (const char*) ptr + length };
+        struct maze_t maze;
+
+        result = scan_maze(&maze, &scanner);
+        if (result == 0) free_maze(&maze);
+    }
+
+    munmap(ptr, length);
+
+    return result;
+}
+
+// Define write_maze_text (io.h)
+int write_maze_text(struct maze_t maze, FILE* fp)
+{
+    // Assert that the file handle is valid.
+    assert(fp != NULL);
+
+    size_t columns = maze.size.columns;
+
+    if (fprintf(fp, "%zu %zu\n%zu %zu\n%zu %zu\n", maze.size.rows, columns,
+                maze.start.row, maze.start.column, maze.end.row, maze.end.column) < 0)
+    {
+        return -1;
+    }
+
+    unsigned char* action_sets = (unsigned char*) malloc(columns * sizeof(unsigned char));
+    char* buffer = (char*) malloc(columns * 3 * sizeof(char));
+
+    if (action_sets == NULL || buffer == NULL)
+    {
+        free(buffer);
+        free(action_sets);
+        return -1;
+    }
+
+    int result = 0;
+
+    for (size_t row = 0; row < maze.size.rows && result == 0; row++)
+    {
+        get_row_action_sets(maze, row, action_sets);
+        result = write_maze_text_row(action_sets, columns, buffer, fp);
+    }
+
+    free(buffer);
+    free(action_sets);
+
+    return result;
+}
+
+// Define write_maze_text_row (io.h)
+int write_maze_text_row(const unsigned char* action_sets, size_t columns, char* buffer, FILE* fp)
+{
+    // Assert that the pointer to the action set array is valid.
+    assert(action_sets != NULL);
+    // Assert that the pointer to the buffer is valid.
+    assert(buffer != NULL);
+    // Assert that the file handle is valid.
+    assert(fp != NULL);
+
+    // Each set of walls takes at most two digits, followed by a separator.
+    size_t length = 0;
+    for (size_t column = 0; column < columns; column++)
+    {
+        unsigned int walls = ~action_sets[column] & 0x0Fu;
+
+        if (walls >= 10) buffer[length++] = '1';
+        buffer[length++] = (char) ('0' + walls % 10);
+        buffer[length++] = (column + 1 < columns) ? ' ' : '\n';
+    }
+
+    return (fwrite(buffer, sizeof(char), length, fp) == length) ? 0 : -1;
+}
+
+// Define write_maze_binary (io.h)
+int write_maze_binary(struct maze_t maze, FILE* fp)
+{
+    // Assert that the file handle is valid.
+    assert(fp != NULL);
+
+    size_t length = (maze.size.rows * maze.size.columns + 1) / 2;
+
+    struct maze_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, maze_file_magic, sizeof(maze_file_magic));
+    header.version = MAZE_FILE_VERSION;
+    header.rows = maze.size.rows;
+    header.columns = maze.size.columns;
+    header.start_row = maze.start.row;
+    header.start_column = maze.start.column;
+    header.end_row = maze.end.row;
+    header.end_column = maze.end.column;
+    header.checksum = checksum_action_sets(maze.action_sets, length);
+
+    // Write the header followed by the action sets, exactly as they are held in
+    // memory.
+    if (fwrite(&header, sizeof(header), 1, fp) != 1) return -1;
+    if (fwrite(maze.action_sets, sizeof(unsigned char), length, fp) != length) return -1;
+
+    return 0;
+}
+
 // Define write_maze (io.h)
 int write_maze(struct maze_t maze, FILE* fp)
 {
     // Assert that the file handle is valid.
     assert(fp != NULL);
 
+    return render_maze(maze, NULL, NULL, fp);
+}
+
+// Define write_solved_maze (io.h).
+int write_solved_maze(struct maze_t maze, struct node_list_t* list, bool show_explored, FILE* fp)
+{
+    // Assert that the pointer to the node list variable is valid.
+    assert(list != NULL);
+    // Assert that the file handle is valid.
+    assert(fp != NULL);
+
+    struct location_set_t path;
+    if (make_location_set(&path, maze.size) != 0) return -1;
+
+    // Mark every location on the path, if the final node in the list is the
+    // start of the maze.
+    if (list->length > 0 && location_equal(get_node(list, list->length - 1)->location, maze.start))
+    {
+        for (struct node_t* node = get_node(list, list->length - 1); node != NULL; node = node->parent)
+        {
+            add_location(&path, node->location);
+        }
+    }
+
+    // Mark the location of every node in the list as explored if requested.
+    struct location_set_t explored;
+    if (show_explored)
+    {
+        if (make_location_set(&explored, maze.size) != 0)
+        {
+            free_location_set(&path);
+            return -1;
+        }
+
+        for (size_t index = 0; index < list->length; index++)
+        {
+            add_location(&explored, get_node(list, index)->location);
+        }
+    }
+
+    int render_maze_result = render_maze(maze, &path, show_explored ? &explored : NULL, fp);
+
+    if (show_explored) free_location_set(&explored);
+    free_location_set(&path);
+
+    return render_maze_result;
+}
+
+// Define make_maze_image (io.h).
+int make_maze_image(struct maze_image_t* image, struct maze_t maze, struct node_list_t* list, enum image_format_t format)
+{
+    // Assert that the pointer to the image variable is valid.
+    assert(image != NULL);
+
+    // Initialize image properties.
+    image->maze = maze;
+    image->list = list;
+    image->format = format;
+    image->width = maze.size.columns * 2 + 1;
+    image->height = maze.size.rows * 2 + 1;
+    image->line_length = (format == IMAGE_PBM) ? (image->width + 7) / 8 : image->width;
+    image->explored_offsets = NULL;
+    image->explored = NULL;
+    image->path_offsets = NULL;
+    image->path = NULL;
+
+    // Only a graymap shows the nodes in the list.
+    if (format != IMAGE_PGM || list == NULL || list->length == 0) return 0;
+
+    if (index_by_row(&image->explored_offsets, &image->explored, list, maze.size.rows, NULL, list->length) != 0)
+    {
+        return -1;
+    }
+
+    // Find the path if the final node in the list is the start of the maze.
+    struct node_t* start = get_node(list, list->length - 1);
+    if (!location_equal(start->location, maze.start)) return 0;
+
+    size_t length = 0;
+    for (struct node_t* node = start; node != NULL; node = node->parent) length++;
+
+    size_t* nodes = (size_t*) malloc(length * sizeof(size_t));
+    if (nodes == NULL)
+    {
+        free_maze_image(image);
+        return -1;
+    }
+
+    // The nodes on the path are all in the list, so their indexes are their
+    // offsets from the first node.
+    size_t step = 0;
+    for (struct node_t* node = start; node != NULL; node = node->parent)
+    {
+        nodes[step++] = (size_t) (node - get_node(list, 0));
+    }
+
+    int result = index_by_row(&image->path_offsets, &image->path, list, maze.size.rows, nodes, length);
+
+    free(nodes);
+    if (result != 0) free_maze_image(image);
+
+    return result;
+}
+
+// Define free_maze_image (io.h).
+void free_maze_image(struct maze_image_t* image)
+{
+    // Assert that the pointer to the image variable is valid.
+    assert(image != NULL);
+
+    free(image->path);
+    free(image->path_offsets);
+    free(image->explored);
+    free(image->explored_offsets);
+
+    image->path = NULL;
+    image->path_offsets = NULL;
+    image->explored = NULL;
+    image->explored_offsets = NULL;
+}
+
+// Define image_band_size (io.h).
+size_t image_band_size(struct maze_image_t* image, size_t first_row, size_t last_row)
+{
+    // Assert that the pointer to the image variable is valid.
+    assert(image != NULL);
+
+    // Each row of the maze takes two lines, and the first row also takes the
+    // line for the wall along the top.
+    size_t lines = (last_row - first_row) * 2 + ((first_row == 0) ? 1 : 0);
+
+    return lines * image->line_length;
+}
+
+// Define render_image_band (io.h).
+int render_image_band(struct maze_image_t* image, size_t first_row, size_t last_row, unsigned char* buffer)
+{
+    // Assert that the pointer to the image variable is valid.
+    assert(image != NULL);
+    // Assert that the band is within the maze.
+    assert(first_row <= last_row && last_row <= image->maze.size.rows);
+
+    struct maze_t maze = image->maze;
     size_t rows = maze.size.rows;
     size_t columns = maze.size.columns;
 
-    unsigned char walls = 0;
-    int fprintf_result = 0;
+    // Create a buffer for the sets of actions of a single row, and one for a
+    // single line of pixels.
+    unsigned char* action_sets = (unsigned char*) malloc(columns * sizeof(unsigned char));
+    unsigned char* pixels = (unsigned char*) malloc(image->width * sizeof(unsigned char));
 
-    size_t row = 0;
-    size_t column = 0;
+    if (action_sets == NULL || pixels == NULL)
+    {
+        free(pixels);
+        free(action_sets);
+        return -1;
+    }
 
-    for (; row < rows; row++)
+    // Draw the wall along the top of the maze.
+    if (first_row == 0)
     {
-        // Write the north walls and north-east corners of this row to the file.
-        for (column = 0; column < columns; column++)
-        {
-            walls = ~get_action_set(maze, (struct location_t) { row, column })
-                  & 0x0F;
+        memset(pixels, IMAGE_WALL, image->width);
+        encode_image_line(image, pixels, buffer);
+        buffer += image->line_length;
+    }
 
-            fprintf_result = fprintf(fp,
-                walls & 0x08 ? "####" : (walls & 0x04 ? "#   " : "    "));
-            if (fprintf_result != 4) return -1;
+    for (size_t row = first_row; row < last_row; row++)
+    {
+        get_row_action_sets(maze, row, action_sets);
+
+        // Draw the locations in this row, and the walls between them.
+        pixels[0] = IMAGE_WALL;
+        for (size_t column = 0; column < columns; column++)
+        {
+            pixels[column * 2 + 1] = IMAGE_OPEN;
+            pixels[column * 2 + 2] = (action_sets[column] & EAST_FLAG) ? IMAGE_OPEN : IMAGE_WALL;
         }
 
-        // Write out any extra characters for the north-west corner of this row,
-        // followed by the end of the line.
-        fprintf_result = fprintf(fp, walls & 0x09 ? "#\n" : " \n");
-        if (fprintf_result != 2) return -1;
+        // Shade each explored location by when it was explored.
+        if (image->explored != NULL)
+        {
+            size_t explored_length = image->list->length;
+
+            for (size_t item = image->explored_offsets[row]; item < image->explored_offsets[row + 1]; item++)
+            {
+                size_t index = image->explored[item];
+                size_t column = get_node(image->list, index)->location.column;
 
-        // Write the east walls of this row to the file.
-        for (column = 0; column < columns; column++)
+                pixels[column * 2 + 1] = (unsigned char) (IMAGE_EXPLORED + IMAGE_EXPLORED_RANGE * index / explored_length);
+            }
+        }
+
+        // Draw each location on the path, and the step to its parent if it is
+        // in the same row.
+        if (image->path != NULL)
         {
-            walls = ~get_action_set(maze, (struct location_t) { row, column })
-                  & 0x0F;
+            for (size_t item = image->path_offsets[row]; item < image->path_offsets[row + 1]; item++)
+            {
+                struct node_t* node = get_node(image->list, image->path[item]);
 
-            fprintf_result = fprintf(fp, walls & 0x04 ? "#   " : "    ");
-            if (fprintf_result != 4) return -1;
+                pixels[node->location.column * 2 + 1] = IMAGE_PATH;
+
+                if (node->parent != NULL && node->parent->location.row == row)
+                {
+                    pixels[node->location.column + node->parent->location.column + 1] = IMAGE_PATH;
+                }
+            }
         }
 
-        // Write out any extra characters for the east wall of this row,
-        // followed by the end of the line.
-        fprintf_result = fprintf(fp, walls & 0x01 ? "#\n" : " \n");
-        if (fprintf_result != 2) return -1;
-    }
+        encode_image_line(image, pixels, buffer);
+        buffer += image->line_length;
 
-    // Write the south walls and south-east corners of the final row of the maze to the file.
-    for (column = 0; column < columns; column++)
-    {
-        walls = ~get_action_set(maze, (struct location_t) { row - 1, column })
-              & 0x0F;
+        // Draw the walls between this row and the next.
+        for (size_t column = 0; column < columns; column++)
+        {
+            pixels[column * 2] = IMAGE_WALL;
+            pixels[column * 2 + 1] = (action_sets[column] & SOUTH_FLAG) ? IMAGE_OPEN : IMAGE_WALL;
+        }
+
+        pixels[columns * 2] = IMAGE_WALL;
 
-        fprintf_result = fprintf(fp, walls & 0x02 ? "####"
-                                                  : (walls & 0x04 ? "#   "
-                                                                  : "    "));
-        if (fprintf_result != 4) return -1;
+        // Draw each step of the path between this row and the next, which may
+        // be taken from a location in either row.
+        if (image->path != NULL)
+        {
+            for (size_t item = image->path_offsets[row]; item < image->path_offsets[row + 1]; item++)
+            {
+                struct node_t* node = get_node(image->list, image->path[item]);
+
+                if (node->parent != NULL && node->parent->location.row == row + 1)
+                {
+                    pixels[node->location.column * 2 + 1] = IMAGE_PATH;
+                }
+            }
+
+            if (row + 1 < rows)
+            {
+                for (size_t item = image->path_offsets[row + 1]; item < image->path_offsets[row + 2]; item++)
+                {
+                    struct node_t* node = get_node(image->list, image->path[item]);
+
+                    if (node->parent != NULL && node->parent->location.row == row)
+                    {
+                        pixels[node->location.column * 2 + 1] = IMAGE_PATH;
+                    }
+                }
+            }
+        }
+
+        encode_image_line(image, pixels, buffer);
+        buffer += image->line_length;
     }
 
-    // Write out any extra characters for the south-east corner of the maze,
-    // followed by the end of the line.
-    fprintf_result = fprintf(fp, walls & 0x03 ? "#\n" : " \n");
-    if (fprintf_result != 2) return -1;
+    free(pixels);
+    free(action_sets);
 
     return 0;
 }
 
-// Define write_path (io.h).
-int write_path(struct node_t* start, FILE* fp)
+// Define write_maze_image (io.h).
+int write_maze_image(struct maze_image_t* image, FILE* fp)
 {
-    // Assert that the pointer to the node variable is valid.
-    assert(start != NULL);
+    // Assert that the pointer to the image variable is valid.
+    assert(image != NULL);
     // Assert that the file handle is valid.
     assert(fp != NULL);
 
-    struct node_t node = *start;
-    enum action_t action;
+    int fprintf_result = (image->format == IMAGE_PBM)
+                       ? fprintf(fp, "P4\n%zu %zu\n", image->width, image->height)
+                       : fprintf(fp, "P5\n%zu %zu\n255\n", image->width, image->height);
+    if (fprintf_result < 0) return -1;
 
-    int fputc_result = 0;
-    int action_taken_result = 0;
+    // Render enough rows of the maze at a time to fill the band buffer, but
+    // at least one.
+    size_t rows = image->maze.size.rows;
+    size_t band_rows = IMAGE_BAND_BYTES / (image->line_length * 2);
+    if (band_rows == 0) band_rows = 1;
 
-    for (;;)
-    {
-        if (node.parent == NULL) break;
+    unsigned char* buffer = (unsigned char*) malloc(image_band_size(image, 0, (band_rows < rows) ? band_rows : rows));
+    if (buffer == NULL) return -1;
 
-        action_taken_result = action_taken(&action, node.location, node.parent->location);
-        if (action_taken_result != 0) return action_taken_result;
+    int result = 0;
+    for (size_t first_row = 0; first_row < rows && result == 0; first_row += band_rows)
+    {
+        size_t last_row = (first_row + band_rows < rows) ? first_row + band_rows : rows;
+        size_t size = image_band_size(image, first_row, last_row);
 
-        fputc_result = fputc(action_char(action), fp);
-        if (fputc_result == EOF) return EOF;
+        result = render_image_band(image, first_row, last_row, buffer);
 
-        node = *node.parent;
+        if (result == 0 && fwrite(buffer, sizeof(unsigned char), size, fp) != size) result = -1;
     }
 
-    // Read the contents of the file back into memory.
-    long int endpos = ftell(fp);
-    if (endpos < 0) return (int) endpos;
+    free(buffer);
 
-    size_t length = (size_t) endpos;
+    return result;
+}
 
-    rewind(fp);
+// Define write_path (io.h).
+int write_path(struct node_t* start, FILE* fp)
+{
+    // Assert that the pointer to the node variable is valid.
+    assert(start != NULL);
+    // Assert that the file handle is valid.
+    assert(fp != NULL);
 
-    char* buf = (char*) malloc((length + 1) * sizeof(char));
-    if (buf == NULL) return -1;
+    struct path_t path;
+    if (make_path(&path, start) != 0) return -1;
 
-    if (fread((void*) buf, sizeof(char), length, fp) < length) return -1;
-    buf[length] = '\0';
+    int write_encoded_path_result = write_encoded_path(path, PATH_TEXT, fp);
 
-    // Rewrite the contents of the file including the number of actions taken.
+    free_path(&path);
 
-    rewind(fp);
+    return write_encoded_path_result;
+}
+
+// Define write_encoded_path (io.h).
+int write_encoded_path(struct path_t path, enum path_encoding_t encoding, FILE* fp)
+{
+    // Assert that the file handle is valid.
+    assert(fp != NULL);
 
-    fprintf(fp, "%ld\n", length);
-    fprintf(fp, "%s\n", buf);
+    switch (encoding)
+    {
+        case PATH_TEXT:       return write_text_path(path, fp);
+        case PATH_RUN_LENGTH: return write_run_length_path(path, fp);
+        case PATH_BINARY:     return write_binary_path(path, fp);
+    }
 
-    return 0;
+    return -1;
 }
 
 // Define read_size (io.c).
@@ -326,7 +1056,401 @@ static int read_action_sets(struct maze_t maze, FILE* fp)
     return 0;
 }
 
-// Define action_char (io.c).
+// Define scan_number (io.c).
+static int scan_number(size_t* value, struct scanner_t* scanner)
+{
+    const char* position = scanner->position;
+    const char* end = scanner->end;
+
+    // Skip any whitespace before the number.
+    while (position < end && (*position == ' ' || *position == '\n' || *position == '\r' || *position == '\t'))
+    {
+        position++;
+    }
+
+    // Indicate failure if there is no number.
+    if (position == end || *position < '0' || *position > '9') return -1;
+
+    // Convert each digit into the number, indicating failure if the number
+    // is too big to hold.
+    size_t number = 0;
+    for (; position < end && *position >= '0' && *position <= '9'; position++)
+    {
+        size_t digit = (size_t) (*position - '0');
+        if (number > (SIZE_MAX - digit) / 10) return -1;
+
+        number = number * 10 + digit;
+    }
+
+    // Indicate failure if the number is not followed by whitespace.
+    if (position < end && *position != ' ' && *position != '\n' && *position != '\r' && *position != '\t')
+    {
+        return -1;
+    }
+
+    scanner->position = position;
+    *value = number;
+
+    return 0;
+}
+
+// Define scan_maze (io.c).
+static int scan_maze(struct maze_t* maze, struct scanner_t* scanner)
+{
+    // Scan the size, start and end of the maze.
+    size_t numbers[6];
+    for (size_t index = 0; index < 6; index++)
+    {
+        if (scan_number(&numbers[index], scanner) != 0) return -1;
+    }
+
+    struct maze_size_t size = { numbers[0], numbers[1] };
+    struct location_t start = { numbers[2], numbers[3] };
+    struct location_t end = { numbers[4], numbers[5] };
+
+    // Indicate failure if the maze is empty, too big to index, or the
+    // locations are outside it. As for a binary file, the number of locations
+    // must be below SIZE_MAX, so that make_maze() cannot round it up to zero
+    // bytes of action sets.
+    if (size.rows == 0 || size.columns == 0 || size.rows > (SIZE_MAX - 1) / size.columns) return -1;
+    if (!check_location(size, start) || !check_location(size, end)) return -1;
+
+    // Construct the maze from the data scanned.
+    if (make_maze(maze, size, start, end) != 0) return -1;
+
+    // Create a buffer for the sets of actions of a single row.
+    unsigned char* action_sets = (unsigned char*) malloc(size.columns * sizeof(unsigned char));
+    if (action_sets == NULL)
+    {
+        free_maze(maze);
+        return -1;
+    }
+
+    // Scan the walls at every location, setting the sets of actions a row at a
+    // time.
+    int result = 0;
+    size_t walls = 0;
+    for (size_t row = 0; row < size.rows && result == 0; row++)
+    {
+        for (size_t column = 0; column < size.columns; column++)
+        {
+            if (scan_number(&walls, scanner) != 0 || walls > 15)
+            {
+                result = -1;
+                break;
+            }
+
+            action_sets[column] = (unsigned char) (~walls & 0xF);
+        }
+
+        if (result == 0) set_row_action_sets(*maze, row, action_sets);
+    }
+
+    free(action_sets);
+    if (result != 0) free_maze(maze);
+
+    return result;
+}
+
+// Define checksum_action_sets (io.c).
+static uint64_t checksum_action_sets(const unsigned char* data, size_t length)
+{
+    uint64_t hash = 0xCBF29CE484222325u;
+
+    for (size_t offset = 0; offset < length; offset++)
+    {
+        hash = (hash ^ data[offset]) * 0x100000001B3u;
+    }
+
+    return hash;
+}
+
+// Define read_maze_header (io.c).
+static int read_maze_header(struct maze_header_t* header, const void* ptr, size_t length)
+{
+    memcpy(header, ptr, sizeof(*header));
+
+    // Indicate failure if the file was written by another version, or by a
+    // machine with a different byte order.
+    if (header->version != MAZE_FILE_VERSION) return -1;
+
+    struct maze_size_t size = { header->rows, header->columns };
+    struct location_t start = { header->start_row, header->start_column };
+    struct location_t end = { header->end_row, header->end_column };
+
+    // Indicate failure if the maze is empty or too big to index. The number of
+    // locations must also be below SIZE_MAX, so that rounding it up to whole
+    // bytes of action sets cannot wrap around to zero.
+    if (size.rows == 0 || size.columns == 0 || size.rows > (SIZE_MAX - 1) / size.columns) return -1;
+    if (!check_location(size, start) || !check_location(size, end)) return -1;
+
+    // Indicate failure if the file does not hold every set of actions.
+    size_t data_length = (size.rows * size.columns + 1) / 2;
+    if (length - sizeof(*header) < data_length) return -1;
+
+    return 0;
+}
+
+// Define check_file_header (io.c).
+static int check_file_header(int fd, size_t length, struct maze_header_t* header, bool* binary)
+{
+    unsigned char prefix[sizeof(struct maze_header_t)];
+
+    *binary = length >= sizeof(prefix)
+           && pread(fd, prefix, sizeof(prefix), 0) == (ssize_t) sizeof(prefix)
+           && memcmp(prefix, maze_file_magic, sizeof(maze_file_magic)) == 0;
+
+    return *binary ? read_maze_header(header, prefix, length) : 0;
+}
+
+// Define map_maze (io.c).
+static int map_maze(struct maze_t* maze, void* ptr, size_t length)
+{
+    struct maze_header_t header;
+    if (read_maze_header(&header, ptr, length) != 0) return -1;
+
+    // Initialize maze properties, using the action sets in place.
+    maze->action_sets = (unsigned char*) ptr + sizeof(header);
+    maze->size = (struct maze_size_t) { header.rows, header.columns };
+    maze->start = (struct location_t) { header.start_row, header.start_column };
+    maze->end = (struct location_t) { header.end_row, header.end_column };
+    maze->mapping = ptr;
+    maze->mapping_length = length;
+
+    return 0;
+}
+
+// Define render_maze (io.c).
+static int render_maze(struct maze_t maze, struct location_set_t* path, struct location_set_t* explored, FILE* fp)
+{
+    size_t rows = maze.size.rows;
+    size_t columns = maze.size.columns;
+
+    // Create a buffer for the sets of actions of a single row, and one for a
+    // single line, with four characters per location followed by the corner or
+    // edge and the end of the line.
+    size_t line_length = columns * 4 + 2;
+    unsigned char* action_sets = (unsigned char*) malloc(columns * sizeof(unsigned char));
+    char* line = (char*) malloc(line_length * sizeof(char));
+
+    if (action_sets == NULL || line == NULL)
+    {
+        free(line);
+        free(action_sets);
+        return -1;
+    }
+
+    int result = 0;
+    unsigned int walls = 0;
+
+    for (size_t row = 0; row < rows && result == 0; row++)
+    {
+        get_row_action_sets(maze, row, action_sets);
+
+        // Build the north walls and north-east corners of this row, followed by
+        // any extra characters for the north-west corner of this row.
+        for (size_t column = 0; column < columns; column++)
+        {
+            walls = ~action_sets[column] & 0x0Fu;
+            memcpy(line + column * 4, walls & 0x08 ? "####" : (walls & 0x04 ? "#   " : "    "), 4);
+        }
+
+        line[columns * 4] = walls & 0x09 ? '#' : ' ';
+        line[columns * 4 + 1] = '\n';
+
+        if (fwrite(line, sizeof(char), line_length, fp) != line_length) result = -1;
+
+        // Build the east walls of this row, marking the locations in the given
+        // sets, followed by any extra characters for the east wall of this row.
+        for (size_t column = 0; column < columns; column++)
+        {
+            walls = ~action_sets[column] & 0x0Fu;
+            memcpy(line + column * 4, walls & 0x04 ? "#   " : "    ", 4);
+
+            struct location_t location = { row, column };
+            if (path != NULL && contains_location(path, location))
+            {
+                line[column * 4 + 2] = '*';
+            }
+            else if (explored != NULL && contains_location(explored, location))
+            {
+                line[column * 4 + 2] = '.';
+            }
+        }
+
+        line[columns * 4] = walls & 0x01 ? '#' : ' ';
+
+        if (fwrite(line, sizeof(char), line_length, fp) != line_length) result = -1;
+    }
+
+    // Build the south walls and south-east corners of the final row of the
+    // maze, followed by any extra characters for the south-east corner.
+    if (result == 0)
+    {
+        for (size_t column = 0; column < columns; column++)
+        {
+            walls = ~action_sets[column] & 0x0Fu;
+            memcpy(line + column * 4, walls & 0x02 ? "####" : (walls & 0x04 ? "#   " : "    "), 4);
+        }
+
+        line[columns * 4] = walls & 0x03 ? '#' : ' ';
+
+        if (fwrite(line, sizeof(char), line_length, fp) != line_length) result = -1;
+    }
+
+    free(line);
+    free(action_sets);
+
+    return result;
+}
+
+// Define index_by_row (io.c).
+static int index_by_row(size_t** offsets, size_t** items, struct node_list_t* list, size_t rows, const size_t* nodes, size_t count)
+{
+    size_t* row_offsets = (size_t*) calloc(rows + 1, sizeof(size_t));
+    size_t* sorted = (size_t*) malloc(((count > 0) ? count : 1) * sizeof(size_t));
+
+    if (row_offsets == NULL || sorted == NULL)
+    {
+        free(sorted);
+        free(row_offsets);
+        return -1;
+    }
+
+    // Count the nodes in each row, offset by one so that the running total
+    // gives the offset of the first node in each row.
+    for (size_t item = 0; item < count; item++)
+    {
+        size_t index = (nodes != NULL) ? nodes[item] : item;
+        row_offsets[get_node(list, index)->location.row + 1]++;
+    }
+
+    for (size_t row = 0; row < rows; row++) row_offsets[row + 1] += row_offsets[row];
+
+    // Place each node after the nodes before it in its row, using the offsets
+    // as cursors and then restoring them.
+    for (size_t item = 0; item < count; item++)
+    {
+        size_t index = (nodes != NULL) ? nodes[item] : item;
+        sorted[row_offsets[get_node(list, index)->location.row]++] = index;
+    }
+
+    for (size_t row = rows; row > 0; row--) row_offsets[row] = row_offsets[row - 1];
+    row_offsets[0] = 0;
+
+    *offsets = row_offsets;
+    *items = sorted;
+
+    return 0;
+}
+
+// Define encode_image_line (io.c).
+static void encode_image_line(struct maze_image_t* image, const unsigned char* pixels, unsigned char* buffer)
+{
+    if (image->format == IMAGE_PGM)
+    {
+        memcpy(buffer, pixels, image->width);
+        return;
+    }
+
+    // Pack eight pixels into each byte, from the highest bit, with set bits
+    // for walls.
+    memset(buffer, 0, image->line_length);
+    for (size_t x = 0; x < image->width; x++)
+    {
+        if (pixels[x] == IMAGE_WALL) buffer[x / 8] |= (unsigned char) (0x80u >> (x % 8));
+    }
+}
+
+// Define write_text_path (io.c).
+static int write_text_path(struct path_t path, FILE* fp)
+{
+    // Make space for the number of actions, a character for each action, and
+    // the end of each line.
+    size_t capacity = 32 + path.length;
+    char* buffer = (char*) malloc(capacity * sizeof(char));
+    if (buffer == NULL) return -1;
+
+    size_t size = (size_t) snprintf(buffer, 32, "%zu\n", path.length);
+
+    for (size_t step = 0; step < path.length; step++)
+    {
+        buffer[size++] = action_char((enum action_t) path.actions[step]);
+    }
+
+    buffer[size++] = '\n';
+
+    size_t written = fwrite(buffer, sizeof(char), size, fp);
+
+    free(buffer);
+
+    return (written == size) ? 0 : -1;
+}
+
+// Define write_run_length_path (io.c).
+static int write_run_length_path(struct path_t path, FILE* fp)
+{
+    // Count the runs of repeated actions.
+    size_t runs = 0;
+    for (size_t step = 0; step < path.length; step++)
+    {
+        if (step == 0 || path.actions[step] != path.actions[step - 1]) runs++;
+    }
+
+    // Make space for the number of actions, a character and up to 20 digits
+    // for each run, and the end of each line.
+    size_t capacity = 32 + runs * 21;
+    char* buffer = (char*) malloc(capacity * sizeof(char));
+    if (buffer == NULL) return -1;
+
+    size_t size = (size_t) snprintf(buffer, 32, "%zu\n", path.length);
+
+    for (size_t step = 0; step < path.length;)
+    {
+        // Find the end of the run beginning at this step.
+        size_t next = step + 1;
+        while (next < path.length && path.actions[next] == path.actions[step]) next++;
+
+        buffer[size++] = action_char((enum action_t) path.actions[step]);
+        size += (size_t) snprintf(buffer + size, 21, "%zu", next - step);
+
+        step = next;
+    }
+
+    buffer[size++] = '\n';
+
+    size_t written = fwrite(buffer, sizeof(char), size, fp);
+
+    free(buffer);
+
+    return (written == size) ? 0 : -1;
+}
+
+// Define write_binary_path (io.c).
+static int write_binary_path(struct path_t path, FILE* fp)
+{
+    // Make space for the number of actions, followed by four actions per byte.
+    size_t size = sizeof(uint64_t) + (path.length + 3) / 4;
+    unsigned char* buffer = (unsigned char*) calloc(size, sizeof(unsigned char));
+    if (buffer == NULL) return -1;
+
+    uint64_t length = path.length;
+    memcpy(buffer, &length, sizeof(length));
+
+    unsigned char* packed = buffer + sizeof(uint64_t);
+    for (size_t step = 0; step < path.length; step++)
+    {
+        packed[step / 4] |= (unsigned char) (path.actions[step] << ((step % 4) * 2));
+    }
+
+    size_t written = fwrite(buffer, sizeof(unsigned char), size, fp);
+
+    free(buffer);
+
+    return (written == size) ? 0 : -1;
+}
+
+// Define action_char (io.h).
 char action_char(enum action_t action)
 {
     switch (action)
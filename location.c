@@ -64,6 +64,12 @@ size_t location_distance(struct location_t a, struct location_t b)
     return estimate_sqrt(distance_squared, candidate);
 }
 
+// Define location_manhattan (location.h).
+size_t location_manhattan(struct location_t a, struct location_t b)
+{
+    return abs_difference(a.row, b.row) + abs_difference(a.column, b.column);
+}
+
 // Define location_equal (location.h).
 bool location_equal(struct location_t a, struct location_t b)
 {
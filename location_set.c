@@ -0,0 +1,89 @@
+#include "location_set.h"
+
+#include "location.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/**
+ * \internal
+ *
+ * Calculates the number of bytes needed by the bitmap of a location set.
+ *
+ * \param [in] size
+ *     The size of the maze containing the locations.
+ *
+ * \returns
+ *     The number of bytes needed to store a bit for every location.
+ */
+static size_t bitmap_length(struct maze_size_t size);
+
+// Define make_location_set (location_set.h).
+int make_location_set(struct location_set_t* set, struct maze_size_t size)
+{
+    // Assert that the pointer to the location set variable is valid.
+    assert(set != NULL);
+
+    // Allocate the memory required for the bitmap, which is initially zero as
+    // the set is empty.
+    void* ptr = calloc(bitmap_length(size), sizeof(unsigned char));
+
+    // Indicate failure if allocation failed.
+    if (ptr == NULL) return -1;
+
+    // Initialize location set properties.
+    set->bits = (unsigned char*) ptr;
+    set->size = size;
+
+    return 0;
+}
+
+// Define free_location_set (location_set.h).
+void free_location_set(struct location_set_t* set)
+{
+    // Assert that the pointer to the location set variable is valid.
+    assert(set != NULL);
+
+    free(set->bits);
+    set->bits = NULL;
+}
+
+// Define clear_location_set (location_set.h).
+void clear_location_set(struct location_set_t* set)
+{
+    // Assert that the pointer to the location set variable is valid.
+    assert(set != NULL);
+
+    memset(set->bits, 0, bitmap_length(set->size));
+}
+
+// Define add_location (location_set.h).
+void add_location(struct location_set_t* set, struct location_t location)
+{
+    // Assert that the pointer to the location set variable is valid.
+    assert(set != NULL);
+
+    size_t index = location_index(set->size, location);
+
+    set->bits[index / CHAR_BIT] |= (unsigned char) (1 << (index % CHAR_BIT));
+}
+
+// Define contains_location (location_set.h).
+bool contains_location(struct location_set_t* set, struct location_t location)
+{
+    // Assert that the pointer to the location set variable is valid.
+    assert(set != NULL);
+
+    size_t index = location_index(set->size, location);
+
+    return (set->bits[index / CHAR_BIT] >> (index % CHAR_BIT)) & 1;
+}
+
+// Define bitmap_length (location_set.c).
+static size_t bitmap_length(struct maze_size_t size)
+{
+    return (size.rows * size.columns + CHAR_BIT - 1) / CHAR_BIT;
+}
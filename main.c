@@ -1,51 +1,421 @@
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "location.h"
 #include "node.h"
 #include "node_list.h"
+#include "path.h"
 #include "maze.h"
+#include "compact_search.h"
+#include "search_engine.h"
+#include "maze_tree.h"
+#include "batch.h"
+#include "pipeline.h"
+#include "server.h"
+#include "stats.h"
+#include "generator.h"
 #include "io.h"
 
-#ifndef TEST
+#if !defined(TEST) && !defined(BENCH) && !defined(MICROBENCH)
+
+/**
+ * \internal
+ *
+ * The number of threads used by the parallel searches and batches, set by the
+ * -t option.
+ */
+static size_t thread_count = 1;
+
+/**
+ * \internal
+ *
+ * Represents a path encoding that can be selected to write the solution.
+ */
+struct encoding_t
+{
+    const char* name;
+    enum path_encoding_t encoding;
+};
+
+/**
+ * \internal
+ *
+ * The path encodings that can be selected with the -e option, the first of
+ * which is used by default.
+ */
+static const struct encoding_t encodings[] =
+{
+    { "text",   PATH_TEXT },
+    { "rle",    PATH_RUN_LENGTH },
+    { "binary", PATH_BINARY }
+};
+
+/**
+ * \internal
+ *
+ * Represents a maze generation algorithm that can be selected with the -g
+ * option.
+ */
+struct generator_name_t
+{
+    const char* name;
+    enum generator_t algorithm;
+};
+
+/**
+ * \internal
+ *
+ * The maze generation algorithms that can be selected with the -g option.
+ */
+static const struct generator_name_t generators[] =
+{
+    { "backtracker", GENERATOR_BACKTRACKER },
+    { "kruskal",     GENERATOR_KRUSKAL },
+    { "wilson",      GENERATOR_WILSON },
+    { "eller",       GENERATOR_ELLER }
+};
+
+/**
+ * \internal
+ *
+ * Generates a maze and writes it to a file, instead of solving a maze.
+ *
+ * This function writes the maze in the text format, streaming it a row at a
+ * time if the algorithm allows, or in the binary format if requested.
+ *
+ * \param [in] options
+ *     The options to generate the maze with.
+ * \param [in] binary
+ *     Whether to write the maze in the binary format.
+ * \param [in] filename
+ *     The name of the file to write the maze to.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int write_generated_maze(struct generator_options_t options, bool binary, const char* filename);
+
+/**
+ * \internal
+ *
+ * Answers a file of queries on a maze and writes a path for each to a file,
+ * instead of solving the maze from its start to its end.
+ *
+ * This function makes the tree of shortest paths from the start of the maze,
+ * then reads each line of the query file as the row and column of a start
+ * location followed by the row and column of an end location, and writes the
+ * path between them with the given encoding, in the order of the queries.
+ * Blank lines are skipped. A query which is malformed or has no path is
+ * reported with its line number and left out of the paths written, and the
+ * remaining queries are still answered.
+ *
+ * \param [in] maze
+ *     The maze to answer the queries on.
+ * \param [in] query_filename
+ *     The name of the file to read the queries from.
+ * \param [in] encoding
+ *     The encoding to write the paths with.
+ * \param [in] filename
+ *     The name of the file to write the paths to.
+ *
+ * \returns
+ *     -1 on failure, including when any query is malformed or has no path, 0
+ *     on success.
+ */
+static int write_tree_paths(struct maze_t maze, const char* query_filename, enum path_encoding_t encoding, const char* filename);
+
+/**
+ * \internal
+ *
+ * Prints the usage of the program.
+ */
+static void print_usage(void);
 
 int main(int argc, char** argv)
 {
-    if (argc == 1)
+    bool print = false;
+    bool view = false;
+    bool view_explored = false;
+    char* image_filename = NULL;
+    bool batch_mode = false;
+    bool pipelined = false;
+    struct pipeline_widths_t widths = { 1, 1, 1, 64 };
+    bool convert = false;
+    bool verify = false;
+    bool show_stats = false;
+    enum stats_format_t stats_format = STATS_TEXT;
+    char* socket_path = NULL;
+    char* query_filename = NULL;
+    bool generate = false;
+    struct generator_options_t generator_options = { .algorithm = GENERATOR_BACKTRACKER, .seed = 1, .braid = 0 };
+    size_t cache_megabytes = 1024;
+    const struct search_engine_t* search = &search_engines[0];
+    const struct encoding_t* encoding = &encodings[0];
+
+    // Use every available processor for the parallel search by default.
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    if (processors > 0) thread_count = (size_t) processors;
+
+    // Read the options preceding the file names.
+    int arg_index = 1;
+    for (; arg_index < argc && argv[arg_index][0] == '-'; arg_index++)
     {
-        printf("Usage: maze [-p] input_file output_file\n");
-        return -1;
+        char* arg = argv[arg_index];
+
+        if (strcmp(arg, "-p") == 0)
+        {
+            print = true;
+        }
+        else if (strcmp(arg, "-v") == 0)
+        {
+            view = true;
+        }
+        else if (strcmp(arg, "-x") == 0)
+        {
+            view = true;
+            view_explored = true;
+        }
+        else if (strcmp(arg, "-i") == 0 && arg_index + 1 < argc)
+        {
+            image_filename = argv[++arg_index];
+        }
+        else if (strcmp(arg, "-b") == 0)
+        {
+            batch_mode = true;
+        }
+        else if (strcmp(arg, "-w") == 0 && arg_index + 1 < argc)
+        {
+            // Read the widths of the stages, optionally followed by the depth
+            // of the queues between them.
+            char* value = argv[++arg_index];
+            int count = sscanf(value, "%zu:%zu:%zu:%zu", &widths.parsers, &widths.solvers, &widths.writers, &widths.depth);
+
+            if (count < 3 || widths.parsers == 0 || widths.solvers == 0 || widths.writers == 0
+             || widths.depth < 2 || (widths.depth & (widths.depth - 1)) != 0)
+            {
+                printf("Invalid pipeline widths: %s\n", value);
+                return -1;
+            }
+
+            batch_mode = true;
+            pipelined = true;
+        }
+        else if (strcmp(arg, "--stats") == 0 || strcmp(arg, "--stats=text") == 0)
+        {
+            show_stats = true;
+            stats_format = STATS_TEXT;
+        }
+        else if (strcmp(arg, "--verify") == 0)
+        {
+            verify = true;
+        }
+        else if (strcmp(arg, "--stats=json") == 0)
+        {
+            show_stats = true;
+            stats_format = STATS_JSON;
+        }
+        else if (strcmp(arg, "-g") == 0 && arg_index + 1 < argc)
+        {
+            char* name = argv[++arg_index];
+            size_t count = sizeof(generators) / sizeof(generators[0]);
+            size_t index = 0;
+
+            while (index < count && strcmp(name, generators[index].name) != 0) index++;
+
+            if (index == count)
+            {
+                printf("Unknown generator: %s\n", name);
+                return -1;
+            }
+
+            generate = true;
+            generator_options.algorithm = generators[index].algorithm;
+        }
+        else if (strcmp(arg, "-B") == 0 && arg_index + 1 < argc)
+        {
+            generator_options.braid = (unsigned int) strtoul(argv[++arg_index], NULL, 10);
+
+            if (generator_options.braid > 100)
+            {
+                printf("Invalid braid percentage: %s\n", argv[arg_index]);
+                return -1;
+            }
+        }
+        else if (strcmp(arg, "-r") == 0 && arg_index + 1 < argc)
+        {
+            generator_options.seed = strtoull(argv[++arg_index], NULL, 10);
+        }
+        else if (strcmp(arg, "-S") == 0 && arg_index + 1 < argc)
+        {
+            socket_path = argv[++arg_index];
+        }
+        else if (strcmp(arg, "-q") == 0 && arg_index + 1 < argc)
+        {
+            query_filename = argv[++arg_index];
+        }
+        else if (strcmp(arg, "-m") == 0 && arg_index + 1 < argc)
+        {
+            cache_megabytes = strtoul(argv[++arg_index], NULL, 10);
+
+            if (cache_megabytes == 0)
+            {
+                printf("Invalid cache size: %s\n", argv[arg_index]);
+                return -1;
+            }
+        }
+        else if (strcmp(arg, "-c") == 0)
+        {
+            convert = true;
+        }
+        else if (strcmp(arg, "-s") == 0 && arg_index + 1 < argc)
+        {
+            char* name = argv[++arg_index];
+
+            search = find_search_engine(name);
+
+            if (search == NULL)
+            {
+                printf("Unknown search: %s\n", name);
+                return -1;
+            }
+        }
+        else if (strcmp(arg, "-e") == 0 && arg_index + 1 < argc)
+        {
+            char* name = argv[++arg_index];
+
+            encoding = NULL;
+            for (size_t index = 0; index < sizeof(encodings) / sizeof(encodings[0]); index++)
+            {
+                if (strcmp(name, encodings[index].name) == 0) encoding = &encodings[index];
+            }
+
+            if (encoding == NULL)
+            {
+                printf("Unknown encoding: %s\n", name);
+                return -1;
+            }
+        }
+        else if (strcmp(arg, "-t") == 0 && arg_index + 1 < argc)
+        {
+            thread_count = strtoul(argv[++arg_index], NULL, 10);
+
+            if (thread_count == 0)
+            {
+                printf("Invalid number of threads: %s\n", argv[arg_index]);
+                return -1;
+            }
+        }
+        else
+        {
+            print_usage();
+            return -1;
+        }
     }
 
-    bool print = false;
-    size_t arg_offset = 0;
+    set_search_threads(thread_count);
+
+    // Generate a maze instead of solving one if requested.
+    if (generate)
+    {
+        if (argc - arg_index != 3)
+        {
+            print_usage();
+            return -1;
+        }
+
+        generator_options.size.rows = strtoul(argv[arg_index], NULL, 10);
+        generator_options.size.columns = strtoul(argv[arg_index + 1], NULL, 10);
+
+        if (generator_options.size.rows == 0 || generator_options.size.columns == 0)
+        {
+            printf("Invalid maze size: %s %s\n", argv[arg_index], argv[arg_index + 1]);
+            return -1;
+        }
 
-    char* arg = argv[1];
-    if (strncmp(arg, "-p", 2) != 0)
+        if (write_generated_maze(generator_options, convert, argv[arg_index + 2]) != 0)
+        {
+            printf("Failed to generate maze: %s\n", argv[arg_index + 2]);
+            return -1;
+        }
+
+        return 0;
+    }
+
+    // Answer requests on a socket until the server stops if requested.
+    if (socket_path != NULL)
     {
-        print = true;
-        arg_offset = 1;
+        if (argc - arg_index != 0)
+        {
+            print_usage();
+            return -1;
+        }
+
+        run_server(socket_path, cache_megabytes * 1024 * 1024);
+        printf("Failed to run server on %s\n", socket_path);
+
+        return -1;
     }
 
-    if ((size_t) argc < arg_offset + 3)
+    // Solve a batch of mazes, listed in a file or found in a directory, if
+    // requested.
+    if (batch_mode)
     {
-        printf("Usage: maze [-p] input_file output_file\n");
+        if (argc - arg_index != 1 && argc - arg_index != 2)
+        {
+            print_usage();
+            return -1;
+        }
+
+        struct batch_t batch;
+        make_batch(&batch);
+
+        int read_batch_result = (argc - arg_index == 1)
+                              ? read_batch_list(&batch, argv[arg_index])
+                              : read_batch_directory(&batch, argv[arg_index], argv[arg_index + 1]);
+
+        if (read_batch_result != 0)
+        {
+            printf("Failed to read batch: return code %d\n", read_batch_result);
+            free_batch(&batch);
+            return -1;
+        }
+
+        int solve_batch_result = pipelined
+                               ? run_pipeline(&batch, widths, encoding->encoding, stdout)
+                               : solve_batch(&batch, thread_count, encoding->encoding, stdout);
+        free_batch(&batch);
+
+        return solve_batch_result;
+    }
+
+    if (argc - arg_index != 2)
+    {
+        print_usage();
         return -1;
     }
 
-    char* filename = argv[arg_offset + 1];
+    char* filename = argv[arg_index];
 
-    FILE* fp = fopen(filename, "r");
+    struct solve_stats_t stats;
+    make_solve_stats(&stats);
 
-    if (fp == NULL)
+    uint64_t phase_start = monotonic_time();
+
+    // Check the whole file first if requested, as reading a binary maze does
+    // not check its sets of actions against its checksum.
+    if (verify && verify_maze_file(filename) != 0)
     {
-        printf("Failed to open %s\n", filename);
+        printf("Failed to verify maze: %s\n", filename);
         return -1;
     }
 
     struct maze_t maze;
-    int read_maze_result = read_maze(&maze, fp);
+    int read_maze_result = read_maze_file(&maze, filename);
+
+    stats.read_time = monotonic_time() - phase_start;
 
     if (read_maze_result != 0)
     {
@@ -53,9 +423,55 @@ int main(int argc, char** argv)
         return -1;
     }
 
-    size_t capacity = maze.size.rows * maze.size.columns;
+    if (print) write_maze(maze, stdout);
+
+    // Answer a file of queries on the maze instead of solving it if requested.
+    if (query_filename != NULL)
+    {
+        char* output_filename = argv[arg_index + 1];
+
+        int write_tree_paths_result = write_tree_paths(maze, query_filename, encoding->encoding, output_filename);
+        free_maze(&maze);
+
+        if (write_tree_paths_result != 0)
+        {
+            printf("Failed to answer queries: %s\n", query_filename);
+            return -1;
+        }
+
+        return 0;
+    }
+
+    // Write the maze in the binary format instead of solving it if requested.
+    if (convert)
+    {
+        char* binary_filename = argv[arg_index + 1];
+
+        FILE* fp = fopen(binary_filename, "wb");
+
+        if (fp == NULL)
+        {
+            printf("Failed to open %s\n", binary_filename);
+            return -1;
+        }
+
+        int write_maze_binary_result = write_maze_binary(maze, fp);
+
+        if (fclose(fp) != 0 || write_maze_binary_result != 0)
+        {
+            printf("Failed to write maze: %s\n", binary_filename);
+            return -1;
+        }
+
+        free_maze(&maze);
+
+        return 0;
+    }
+
+    // Each search reserves the space it needs in the list, which for most of
+    // them is only the path.
     struct node_list_t explored;
-    int make_list_result = make_list(&explored, capacity);
+    int make_list_result = make_list(&explored, 0);
 
     if (make_list_result != 0)
     {
@@ -63,28 +479,217 @@ int main(int argc, char** argv)
         return -1;
     }
 
-    solve_maze(&explored, maze);
+    phase_start = monotonic_time();
+
+    if (show_stats && search->measure != NULL) search->measure(&explored, maze, &stats.search);
+    else search->solve(&explored, maze);
+
+    stats.solve_time = monotonic_time() - phase_start;
+
+    // The final node explored is the start of the maze if a path was found.
+    if (explored.length == 0
+     || !location_equal(get_node(&explored, explored.length - 1)->location, maze.start))
+    {
+        printf("Failed to solve maze\n");
+        return -1;
+    }
+
+    stats.rows = maze.size.rows;
+    stats.columns = maze.size.columns;
+    measure_solution(&stats, &explored);
+
+    if (view) write_solved_maze(maze, &explored, view_explored, stdout);
+
+    // Write an image of the solved maze if requested, as a bitmap of the walls
+    // if the file name ends in ".pbm", or as a graymap otherwise.
+    if (image_filename != NULL)
+    {
+        size_t length = strlen(image_filename);
+        enum image_format_t format = (length >= 4 && strcmp(image_filename + length - 4, ".pbm") == 0)
+                                   ? IMAGE_PBM
+                                   : IMAGE_PGM;
+
+        FILE* fp = fopen(image_filename, "wb");
+
+        if (fp == NULL)
+        {
+            printf("Failed to open %s\n", image_filename);
+            return -1;
+        }
+
+        struct maze_image_t image;
+        int write_image_result = make_maze_image(&image, maze, &explored, format);
+
+        if (write_image_result == 0)
+        {
+            write_image_result = write_maze_image(&image, fp);
+            free_maze_image(&image);
+        }
+
+        if (fclose(fp) != 0 || write_image_result != 0)
+        {
+            printf("Failed to write image: %s\n", image_filename);
+            return -1;
+        }
+    }
+
+    phase_start = monotonic_time();
+
+    struct path_t path;
+    int make_path_result = make_path(&path, get_node(&explored, explored.length - 1));
+
+    if (make_path_result != 0)
+    {
+        printf("Failed to make path: return code %d\n", make_path_result);
+        return -1;
+    }
+
+    char* output_filename = argv[arg_index + 1];
 
-    size_t length = explored.length;
+    FILE* fp2 = fopen(output_filename, "wb");
 
-    struct node_t node;
-    for (size_t index = 0; index < length; node = *get_node(&explored, index++)) {}
+    if (fp2 == NULL)
+    {
+        printf("Failed to open %s\n", output_filename);
+        return -1;
+    }
 
-//     struct location_t location;
-//     for (;;)
-//     {
-//         location = node.location;
-//         printf("{ %ld, %ld }\n", location.row, location.column);
-//         if (node.parent == NULL) break;
-//         node = *node.parent;
-//     }
+    int write_path_result = write_encoded_path(path, encoding->encoding, fp2);
 
-    FILE* fp2 = fopen("out.txt", "w");
+    if (fclose(fp2) != 0 || write_path_result != 0)
+    {
+        printf("Failed to write path: %s\n", output_filename);
+        return -1;
+    }
+
+    stats.write_time = monotonic_time() - phase_start;
+
+    free_path(&path);
 
-    write_path(&node, fp2);
-    fclose(fp2);
+    if (show_stats) write_solve_stats(&stats, stats_format, stdout);
 
     return 0;
 }
 
-#endif // TEST
+// Define write_generated_maze (main.c).
+static int write_generated_maze(struct generator_options_t options, bool binary, const char* filename)
+{
+    FILE* fp = fopen(filename, "wb");
+    if (fp == NULL) return -1;
+
+    int result = 0;
+
+    if (options.algorithm == GENERATOR_ELLER && !binary)
+    {
+        result = stream_maze(options, fp);
+    }
+    else
+    {
+        struct maze_t maze;
+        result = generate_maze(&maze, options);
+
+        if (result == 0)
+        {
+            result = binary ? write_maze_binary(maze, fp) : write_maze_text(maze, fp);
+            free_maze(&maze);
+        }
+    }
+
+    if (fclose(fp) != 0) result = -1;
+
+    return result;
+}
+
+// Define write_tree_paths (main.c).
+static int write_tree_paths(struct maze_t maze, const char* query_filename, enum path_encoding_t encoding, const char* filename)
+{
+    FILE* queries = fopen(query_filename, "r");
+    if (queries == NULL) return -1;
+
+    FILE* fp = fopen(filename, "wb");
+    if (fp == NULL)
+    {
+        fclose(queries);
+        return -1;
+    }
+
+    struct maze_tree_t tree;
+    int result = make_maze_tree(&tree, maze, maze.start);
+
+    if (result == 0)
+    {
+        // Read a line for each query, each of which should be a maximum of 80
+        // characters.
+        char line[128] = "";
+        size_t line_number = 0;
+        bool failed = false;
+
+        while (result == 0 && fgets(line, sizeof(line), queries) != NULL)
+        {
+            line_number++;
+
+            // Skip the rest of a line which is too long, so that the next line
+            // is read from its start.
+            bool complete = strchr(line, '\n') != NULL || feof(queries);
+            if (!complete)
+            {
+                int c;
+                do c = fgetc(queries); while (c != EOF && c != '\n');
+            }
+
+            // Skip blank lines.
+            if (strspn(line, " \t\r\n") == strlen(line)) continue;
+
+            struct location_t start;
+            struct location_t end;
+            int length = 0;
+
+            // Report a malformed query, including one with anything other than
+            // whitespace after the locations, and carry on with the next.
+            if (!complete
+             || sscanf(line, "%zu %zu %zu %zu %n", &start.row, &start.column, &end.row, &end.column, &length) != 4
+             || line[length] != '\0' || strchr(line, '-') != NULL)
+            {
+                printf("%s:%zu: malformed query\n", query_filename, line_number);
+                failed = true;
+                continue;
+            }
+
+            struct path_t path;
+            if (solve_tree_path(&path, &tree, start, end) != 0)
+            {
+                printf("%s:%zu: no path between %zu %zu and %zu %zu\n", query_filename, line_number,
+                       start.row, start.column, end.row, end.column);
+                failed = true;
+                continue;
+            }
+
+            // Indicate failure if the path cannot be written, as the paths
+            // after it could not be either.
+            result = write_encoded_path(path, encoding, fp);
+            free_path(&path);
+        }
+
+        if (failed) result = -1;
+
+        free_maze_tree(&tree);
+    }
+
+    fclose(queries);
+    if (fclose(fp) != 0) result = -1;
+
+    return result;
+}
+
+// Define print_usage (main.c).
+static void print_usage(void)
+{
+    printf("Usage: maze [-p] [-v] [-x] [-i image_file] [-c] [-s greedy|astar|bidirectional|parallel|bitboard|compact|corridor|deadend|hierarchical|incremental] [-e text|rle|binary] [-t threads] [--stats[=text|json]] [--verify] input_file output_file\n");
+    printf("       maze -b [-e text|rle|binary] [-t threads | -w parsers:solvers:writers[:depth]] list_file\n");
+    printf("       maze -b [-e text|rle|binary] [-t threads | -w parsers:solvers:writers[:depth]] input_directory output_directory\n");
+    printf("       maze -g backtracker|kruskal|wilson|eller [-B braid_percent] [-r seed] [-c] rows columns output_file\n");
+    printf("       maze -S socket_file [-m cache_megabytes]\n");
+    printf("       maze -q query_file [-e text|rle|binary] input_file output_file\n");
+}
+
+#endif // !TEST && !BENCH && !MICROBENCH
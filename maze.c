@@ -3,10 +3,15 @@
 #include "action.h"
 #include "node.h"
 #include "node_list.h"
+#include "node_queue.h"
+#include "location_set.h"
+#include "stats.h"
 
 #include <assert.h>
 #include <stdlib.h>
 
+#include <sys/mman.h>
+
 
 /**
  * \internal
@@ -16,58 +21,155 @@
  * This helper function generates the nodes reachable from the given node by
  * finding the locations resulting from the set of actions available at the
  * node's location and constructing the child nodes from the results. Each child
- * node is appended to the given list, unless the child node is among those
- * already present in the given list of explored nodes.
+ * node is pushed onto the given queue, ordered by its estimated distance to the
+ * start of the maze, unless the child node is among those already present in
+ * the given set of explored locations.
  *
- * \param [in,out] list
- *     A pointer to the node list to which the child nodes are appended.
+ * \param [in,out] frontier
+ *     A pointer to the node queue onto which the child nodes are pushed.
  * \param [in]     node
  *     A pointer to the parent node.
  * \param [in]     explored
- *     A pointer to the list of currently explored nodes.
+ *     A pointer to the set of currently explored locations.
  * \param [in]     maze
  *     The maze that the nodes are contained within.
  *
  * \pre
- *     The pointer to the node list variable must not be NULL.
+ *     The pointer to the node queue variable must not be NULL.
  * \pre
  *     The pointer to the node variable must not be NULL.
  * \pre
- *     The pointer to the explored node list variable must not be NULL.
+ *     The pointer to the explored location set variable must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
  */
-static void get_children(struct node_list_t* list, struct node_t* node, struct node_list_t* explored, struct maze_t maze);
+static int get_children(struct node_queue_t* frontier, struct node_t* node, struct location_set_t* explored, struct maze_t maze);
 
 /**
  * \internal
  *
- * Get the index of the estimated best node in a list to expand for a given
- * maze start location.
+ * Gets all the children reachable from a given node in a maze, for A* search.
  *
- * This helper function finds the best node in the given list by calculating the
- * estimated cost of choosing each node, with the given maze start location. The
- * index of this node is returned, and its contents are copied to the given
- * pointer so that the node can be accessed and removed from the list if
- * necessary.
+ * This helper function generates the child nodes of the given node in the same
+ * way as get_children(), but only pushes a child node onto the given queue if
+ * it reaches its location in fewer actions than any node before it. The number
+ * of actions taken to reach each location is tracked in the given array, offset
+ * by one so that zero indicates that the location has not been reached. Each
+ * child node is ordered by the sum of the number of actions taken to reach it
+ * and its Manhattan distance to the start of the maze.
  *
- * \param [out] best
- *     The pointer to the node variable which will contain the best node.
- * \param [in]  frontier
- *     A pointer to the list of possible candidate nodes.
- * \param [in]  start
- *     The start location of the maze that the nodes are contained within.
+ * \param [in,out] frontier
+ *     A pointer to the node queue onto which the child nodes are pushed.
+ * \param [in]     node
+ *     A pointer to the parent node.
+ * \param [in]     explored
+ *     A pointer to the set of currently explored locations.
+ * \param [in,out] costs
+ *     A pointer to the array of actions taken to reach each location.
+ * \param [in]     maze
+ *     The maze that the nodes are contained within.
  *
  * \pre
+ *     The pointer to the node queue variable must not be NULL.
+ * \pre
  *     The pointer to the node variable must not be NULL.
  * \pre
- *     The pointer to the node list variable must not be NULL.
+ *     The pointer to the explored location set variable must not be NULL.
  * \pre
- *     The given list must not be empty.
+ *     The pointer to the costs array must not be NULL.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int get_a_star_children(struct node_queue_t* frontier, struct node_t* node, struct location_set_t* explored, size_t* costs, struct maze_t maze);
+
+
+/**
+ * \internal
+ *
+ * Represents the flags marking which of the two searches in a bidirectional
+ * search reached a location.
+ *
+ * These flags are stored above the lowest two bits of the per-location states
+ * used by solve_maze_bidirectional(), which hold the action leading back to the
+ * origin of the search that reached the location.
+ */
+enum reached_t
+{
+    REACHED_FROM_END   = 0x04,
+    REACHED_FROM_START = 0x08
+};
+
+/**
+ * \internal
+ *
+ * Represents one of the two searches in a bidirectional search.
+ *
+ * This struct contains a first-in, first-out queue of location indexes making
+ * up the frontier of the search, along with the flag marking the locations it
+ * has reached.
+ */
+struct search_side_t
+{
+    size_t* queue;
+    size_t head;
+    size_t tail;
+    enum reached_t reached;
+};
+
+/**
+ * \internal
+ *
+ * Expands every node in the current level of one side of a bidirectional
+ * search.
+ *
+ * This helper function removes each location in the frontier of the given side
+ * that was present when the level began, marking the unreached locations
+ * resulting from its set of actions as reached by the side and adding them to
+ * its frontier. If a location already reached by the other side is found, the
+ * expansion stops and the location and action that joined the two searches are
+ * returned through the given pointers.
+ *
+ * \param [in,out] side
+ *     A pointer to the side of the search to expand.
+ * \param [in,out] states
+ *     A pointer to the array of per-location states.
+ * \param [out]    meeting
+ *     A pointer to the location variable which will contain the location from
+ *     which the other side was reached.
+ * \param [out]    action
+ *     A pointer to the action variable which will contain the action which
+ *     reached the other side.
+ * \param [in]     maze
+ *     The maze being searched.
  *
  * \returns
- *     The index of the estimated best node in the list.
+ *     Whether the two sides of the search have met.
  */
-static size_t get_best_node(struct node_t* best, struct node_list_t* frontier, struct location_t start);
+static bool expand_level(struct search_side_t* side, unsigned char* states, struct location_t* meeting, enum action_t* action, struct maze_t maze);
 
+/**
+ * \internal
+ *
+ * Splices the two halves of a path found by bidirectional search.
+ *
+ * This helper function reverses the actions along the half of the path reached
+ * from the start of the maze, so that the lowest two bits of the state of every
+ * location on the path hold the action leading towards the end of the maze, as
+ * expected by append_path().
+ *
+ * \param [in,out] states
+ *     A pointer to the array of per-location states.
+ * \param [in]     location
+ *     The last location on the path reached from the start of the maze.
+ * \param [in]     action
+ *     The action leading from the given location to the first location on the
+ *     path reached from the end of the maze.
+ * \param [in]     maze
+ *     The maze being searched.
+ */
+static void splice_path(unsigned char* states, struct location_t location, enum action_t action, struct maze_t maze);
 
 // Define make_maze (maze.h).
 int make_maze(struct maze_t* maze, struct maze_size_t size, struct location_t start, struct location_t end)
@@ -78,24 +180,47 @@ int make_maze(struct maze_t* maze, struct maze_size_t size, struct location_t st
     assert(check_location(size, start));
     assert(check_location(size, end));
 
-    // Find the length of the array needed to store action sets for each node.
-    size_t length = size.rows * size.columns;
+    // Find the length of the array needed to store action sets for each node,
+    // packing the action sets of two nodes into each byte.
+    size_t length = (size.rows * size.columns + 1) / 2;
 
     // Allocate the memory required for the array.
-    void* ptr = calloc(length, sizeof(enum action_set_t));
+    void* ptr = calloc(length, sizeof(unsigned char));
 
     // Indicate failure if allocation failed.
     if (ptr == NULL) return -1;
 
     // Initialize maze properties.
-    maze->action_sets = (enum action_set_t*) ptr;
+    maze->action_sets = (unsigned char*) ptr;
     maze->size = size;
     maze->start = start;
     maze->end = end;
+    maze->mapping = NULL;
+    maze->mapping_length = 0;
 
     return 0;
 }
 
+// Define free_maze (maze.h).
+void free_maze(struct maze_t* maze)
+{
+    // Assert that the pointer to the maze variable is valid.
+    assert(maze != NULL);
+
+    if (maze->mapping != NULL)
+    {
+        munmap(maze->mapping, maze->mapping_length);
+    }
+    else
+    {
+        free(maze->action_sets);
+    }
+
+    maze->action_sets = NULL;
+    maze->mapping = NULL;
+    maze->mapping_length = 0;
+}
+
 // Define set_action_set (maze.h).
 void set_action_set(struct maze_t maze, enum action_set_t action_set, struct location_t location)
 {
@@ -103,9 +228,7 @@ void set_action_set(struct maze_t maze, enum action_set_t action_set, struct loc
     assert(check_location(maze.size, location));
 
     // Find the index to the action set based on the location.
-    size_t index = location.row * maze.size.columns + location.column;
-
-    maze.action_sets[index] = action_set;
+    set_indexed_action_set(maze, action_set, location_index(maze.size, location));
 }
 
 // Define get_action_set (maze.h).
@@ -115,66 +238,410 @@ enum action_set_t get_action_set(struct maze_t maze, struct location_t location)
     assert(check_location(maze.size, location));
 
     // Find the index to the action set based on the location.
-    size_t index = location.row * maze.size.columns + location.column;
+    return get_indexed_action_set(maze, location_index(maze.size, location));
+}
 
-    // Get the correct action set.
-    return maze.action_sets[index];
+// Define set_indexed_action_set (maze.h).
+void set_indexed_action_set(struct maze_t maze, enum action_set_t action_set, size_t index)
+{
+    // Assert that the given index is within the maze.
+    assert(index < maze.size.rows * maze.size.columns);
+
+    // Replace the half of the byte holding the action set, leaving the other.
+    unsigned int shift = (index & 1) * 4;
+    unsigned char* byte = &maze.action_sets[index / 2];
+
+    *byte = (unsigned char) ((*byte & ~(0xFu << shift)) | ((action_set & 0xFu) << shift));
+}
+
+// Define get_indexed_action_set (maze.h).
+enum action_set_t get_indexed_action_set(struct maze_t maze, size_t index)
+{
+    // Assert that the given index is within the maze.
+    assert(index < maze.size.rows * maze.size.columns);
+
+    // Get the correct half of the byte holding the action set.
+    return (enum action_set_t) ((maze.action_sets[index / 2] >> ((index & 1) * 4)) & 0xF);
+}
+
+// Define get_row_action_sets (maze.h).
+void get_row_action_sets(struct maze_t maze, size_t row, unsigned char* action_sets)
+{
+    // Assert that the given row is within the maze.
+    assert(row < maze.size.rows);
+    // Assert that the pointer to the action set array is valid.
+    assert(action_sets != NULL);
+
+    size_t columns = maze.size.columns;
+    size_t index = row * columns;
+    size_t column = 0;
+
+    // If the row begins in the upper half of a byte, unpack it on its own.
+    if (index & 1)
+    {
+        action_sets[column++] = maze.action_sets[index / 2] >> 4;
+    }
+
+    // Unpack two action sets from each whole byte in the row.
+    const unsigned char* bytes = &maze.action_sets[(index + column) / 2];
+    for (; column + 1 < columns; column += 2)
+    {
+        unsigned char byte = *bytes++;
+        action_sets[column] = byte & 0xF;
+        action_sets[column + 1] = byte >> 4;
+    }
+
+    // If the row ends in the lower half of a byte, unpack it on its own.
+    if (column < columns)
+    {
+        action_sets[column] = *bytes & 0xF;
+    }
+}
+
+// Define set_row_action_sets (maze.h).
+void set_row_action_sets(struct maze_t maze, size_t row, const unsigned char* action_sets)
+{
+    // Assert that the given row is within the maze.
+    assert(row < maze.size.rows);
+    // Assert that the pointer to the action set array is valid.
+    assert(action_sets != NULL);
+
+    size_t columns = maze.size.columns;
+    size_t index = row * columns;
+    size_t column = 0;
+
+    // If the row begins in the upper half of a byte, pack it on its own.
+    if (index & 1)
+    {
+        unsigned char* byte = &maze.action_sets[index / 2];
+        *byte = (unsigned char) ((*byte & 0x0F) | ((action_sets[column++] & 0xF) << 4));
+    }
+
+    // Pack two action sets into each whole byte in the row.
+    unsigned char* bytes = &maze.action_sets[(index + column) / 2];
+    for (; column + 1 < columns; column += 2)
+    {
+        *bytes++ = (unsigned char) ((action_sets[column] & 0xF) | ((action_sets[column + 1] & 0xF) << 4));
+    }
+
+    // If the row ends in the lower half of a byte, pack it on its own.
+    if (column < columns)
+    {
+        *bytes = (unsigned char) ((*bytes & 0xF0) | (action_sets[column] & 0xF));
+    }
 }
 
 // Define solve_maze (maze.h).
 void solve_maze(struct node_list_t* list, struct maze_t maze)
+{
+    solve_maze_measured(list, maze, NULL);
+}
+
+// Define solve_maze_measured (maze.h).
+void solve_maze_measured(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats)
 {
     // Assert that the pointer to the node list variable is valid.
     assert(list != NULL);
 
-    // Define the maximum length for the frontier of nodes in the maze. Based on
-    // the maximum proportion of the area that discovered but unexpanded nodes
-    // can take up.
-    size_t max_length = 2 * maze.size.rows * maze.size.columns / 3;
+    size_t first = list->length;
+
+    // Every location is explored at most once, so reserve enough space in the
+    // list to avoid moving the parents of nodes in the frontier.
+    size_t length = maze.size.rows * maze.size.columns;
+    if (list->capacity < list->length + length)
+    {
+        if (resize_list(list, list->length + length) != 0) return;
+    }
+
+    // Define the initial capacity for the frontier of nodes in the maze. The
+    // frontier grows as necessary, so this only needs to cover typical mazes.
+    size_t initial_capacity = maze.size.rows + maze.size.columns;
 
-    // Create the list that will contain all nodes in the frontier.
-    struct node_list_t frontier;
-    if (make_list(&frontier, max_length) != 0) return;
+    // Create the queue that will contain all nodes in the frontier.
+    struct node_queue_t frontier;
+    if (make_queue(&frontier, maze.size, initial_capacity) != 0) return;
+
+    // Create the set that will contain the locations of all explored nodes,
+    // so that children can be checked against it in constant time.
+    struct location_set_t explored;
+    if (make_location_set(&explored, maze.size) != 0)
+    {
+        free_queue(&frontier);
+        return;
+    }
 
     // Create the node that will represent the current node being explored.
     // Initially this is the end node, as this implementation works backwards.
     struct node_t node = { maze.end, NULL };
 
-    // Insert the end node of the maze into the frontier.
-    insert_node(&frontier, &node, 0);
-
-    // Store the index of the next node to expand.
-    size_t node_index = 0;
+    // Push the end node of the maze onto the frontier.
+    int push_result = push_node(&frontier, &node, location_distance(maze.end, maze.start));
 
     // Search for the start node, using the given list to store explored nodes.
-    while (frontier.length > 0)
+    while (push_result == 0 && frontier.length > 0)
     {
         // Get the next node to expand.
-        node_index = get_best_node(&node, &frontier, maze.start);
+        pop_node(&frontier, &node);
 
         // Add the node to the list of explored nodes.
-        insert_node(list, &node, list->length);
+        if (insert_node(list, &node, list->length) != 0) break;
+        add_location(&explored, node.location);
 
         // If the node is the start node, the search is complete.
-        if (location_equal(node.location, maze.start)) return;
+        if (location_equal(node.location, maze.start)) break;
+
+        // Generate the child nodes of the current node, pushing them onto the
+        // frontier.
+        push_result = get_children(&frontier, get_node(list, list->length - 1), &explored, maze);
+    }
+
+    // Record the work done, where every expanded node is in the list.
+    if (stats != NULL)
+    {
+        stats->recorded = true;
+        stats->expansions = list->length - first;
+        stats->pushes = frontier.order + frontier.merges;
+        stats->duplicate_pushes = frontier.merges;
+        stats->frontier_peak = frontier.peak_length;
+    }
+
+    free_location_set(&explored);
+    free_queue(&frontier);
+}
+
+// Define solve_maze_a_star (maze.h).
+void solve_maze_a_star(struct node_list_t* list, struct maze_t maze)
+{
+    solve_maze_a_star_measured(list, maze, NULL);
+}
+
+// Define solve_maze_a_star_measured (maze.h).
+void solve_maze_a_star_measured(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats)
+{
+    // Assert that the pointer to the node list variable is valid.
+    assert(list != NULL);
+
+    size_t first = list->length;
+    size_t length = maze.size.rows * maze.size.columns;
+
+    // Every location is explored at most once, so reserve enough space in the
+    // list to avoid moving the parents of nodes in the frontier.
+    if (list->capacity < list->length + length)
+    {
+        if (resize_list(list, list->length + length) != 0) return;
+    }
+
+    // Create the queue that will contain all nodes in the frontier.
+    struct node_queue_t frontier;
+    if (make_queue(&frontier, maze.size, maze.size.rows + maze.size.columns) != 0) return;
+
+    // Create the set that will contain the locations of all explored nodes.
+    struct location_set_t explored;
+    if (make_location_set(&explored, maze.size) != 0)
+    {
+        free_queue(&frontier);
+        return;
+    }
 
-        // Remove the node from the frontier.
-        remove_node(&frontier, node_index);
+    // Create the array that will contain the number of actions taken to reach
+    // each location, which is initially zero as no locations are reached.
+    size_t* costs = (size_t*) calloc(length, sizeof(size_t));
+    if (costs == NULL)
+    {
+        free_location_set(&explored);
+        free_queue(&frontier);
+        return;
+    }
 
-        // Generate the child nodes of the current node, appending them to the
+    // Create the node that will represent the current node being explored.
+    // Initially this is the end node, as this implementation works backwards.
+    struct node_t node = { maze.end, NULL };
+
+    // Push the end node of the maze onto the frontier, which is reached by
+    // taking no actions.
+    costs[location_index(maze.size, maze.end)] = 1;
+    int push_result = push_node(&frontier, &node, location_manhattan(maze.end, maze.start));
+
+    // Search for the start node, using the given list to store explored nodes.
+    while (push_result == 0 && frontier.length > 0)
+    {
+        // Get the next node to expand.
+        pop_node(&frontier, &node);
+
+        // Add the node to the list of explored nodes.
+        if (insert_node(list, &node, list->length) != 0) break;
+        add_location(&explored, node.location);
+
+        // If the node is the start node, the search is complete.
+        if (location_equal(node.location, maze.start)) break;
+
+        // Generate the child nodes of the current node, pushing them onto the
         // frontier.
-        get_children(&frontier, get_node(list, list->length - 1), list, maze);
+        push_result = get_a_star_children(&frontier, get_node(list, list->length - 1), &explored, costs, maze);
+    }
+
+    // Record the work done, where every expanded node is in the list.
+    if (stats != NULL)
+    {
+        stats->recorded = true;
+        stats->expansions = list->length - first;
+        stats->pushes = frontier.order + frontier.merges;
+        stats->duplicate_pushes = frontier.merges;
+        stats->frontier_peak = frontier.peak_length;
     }
+
+    free(costs);
+    free_location_set(&explored);
+    free_queue(&frontier);
 }
 
-// Define get_children (maze.c).
-static void get_children(struct node_list_t* list, struct node_t* node, struct node_list_t* explored, struct maze_t maze)
+// Define solve_maze_bidirectional (maze.h).
+void solve_maze_bidirectional(struct node_list_t* list, struct maze_t maze)
+{
+    solve_maze_bidirectional_measured(list, maze, NULL);
+}
+
+// Define solve_maze_bidirectional_measured (maze.h).
+void solve_maze_bidirectional_measured(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats)
 {
     // Assert that the pointer to the node list variable is valid.
     assert(list != NULL);
+
+    size_t length = maze.size.rows * maze.size.columns;
+
+    // Create the array that will contain the state of every location, which is
+    // initially zero as no locations are reached.
+    unsigned char* states = (unsigned char*) calloc(length, sizeof(unsigned char));
+
+    // Create the frontiers of the two searches. Each location is added to a
+    // frontier at most once, so neither can hold more locations than the maze.
+    size_t* start_queue = (size_t*) malloc(length * sizeof(size_t));
+    size_t* end_queue = (size_t*) malloc(length * sizeof(size_t));
+
+    if (states != NULL && start_queue != NULL && end_queue != NULL)
+    {
+        struct search_side_t from_start = { start_queue, 0, 0, REACHED_FROM_START };
+        struct search_side_t from_end = { end_queue, 0, 0, REACHED_FROM_END };
+
+        // Begin each search at its origin.
+        size_t start_index = location_index(maze.size, maze.start);
+        size_t end_index = location_index(maze.size, maze.end);
+
+        states[start_index] |= REACHED_FROM_START;
+        from_start.queue[from_start.tail++] = start_index;
+        states[end_index] |= REACHED_FROM_END;
+        from_end.queue[from_end.tail++] = end_index;
+
+        // Expand the side with the smaller frontier until the searches meet.
+        struct location_t meeting = maze.start;
+        enum action_t action = EAST;
+        bool met = start_index == end_index;
+        size_t frontier_peak = 2;
+
+        while (!met && from_start.head < from_start.tail && from_end.head < from_end.tail)
+        {
+            size_t frontier_length = from_start.tail - from_start.head + from_end.tail - from_end.head;
+            if (frontier_length > frontier_peak) frontier_peak = frontier_length;
+
+            if (from_start.tail - from_start.head <= from_end.tail - from_end.head)
+            {
+                met = expand_level(&from_start, states, &meeting, &action, maze);
+            }
+            else
+            {
+                met = expand_level(&from_end, states, &meeting, &action, maze);
+
+                // Describe the meeting from the side of the start search.
+                if (met)
+                {
+                    meeting = action_result(meeting, action);
+                    action = reverse_action(action);
+                }
+            }
+        }
+
+        // Record the work done, where every location removed from a frontier
+        // was expanded.
+        if (stats != NULL)
+        {
+            stats->recorded = true;
+            stats->expansions = from_start.head + from_end.head;
+            stats->pushes = from_start.tail + from_end.tail;
+            stats->duplicate_pushes = 0;
+            stats->frontier_peak = frontier_peak;
+        }
+
+        // Join the two halves of the path and append it to the list.
+        if (met)
+        {
+            if (start_index != end_index) splice_path(states, meeting, action, maze);
+            append_path(list, maze, states);
+        }
+    }
+
+    free(end_queue);
+    free(start_queue);
+    free(states);
+}
+
+// Define append_path (maze.h).
+int append_path(struct node_list_t* list, struct maze_t maze, const unsigned char* actions)
+{
+    // Assert that the pointer to the node list variable is valid.
+    assert(list != NULL);
+    // Assert that the pointer to the actions array is valid.
+    assert(actions != NULL);
+
+    size_t limit = maze.size.rows * maze.size.columns;
+
+    // Follow the actions from the start to find the length of the path,
+    // indicating failure if the path leaves the maze or revisits a location.
+    struct location_t location = maze.start;
+    size_t length = 0;
+
+    while (!location_equal(location, maze.end))
+    {
+        enum action_t action = (enum action_t) (actions[location_index(maze.size, location)] & 0x3);
+        location = action_result(location, action);
+
+        if (!check_location(maze.size, location) || ++length >= limit) return -1;
+    }
+
+    // Make space for a node at every location on the path, so that the parents
+    // of the nodes are not moved as they are appended.
+    size_t base = list->length;
+    if (list->capacity < base + length + 1)
+    {
+        if (resize_list(list, base + length + 1) != 0) return -1;
+    }
+
+    list->length = base + length + 1;
+
+    // Follow the actions again, placing the nodes in reverse order, so that the
+    // end is appended first and the start last.
+    location = maze.start;
+    for (size_t step = 0; step <= length; step++)
+    {
+        struct node_t* node = get_node(list, base + length - step);
+
+        node->location = location;
+        node->parent = (step == length) ? NULL : get_node(list, base + length - step - 1);
+
+        enum action_t action = (enum action_t) (actions[location_index(maze.size, location)] & 0x3);
+        if (step < length) location = action_result(location, action);
+    }
+
+    return 0;
+}
+
+// Define get_children (maze.c).
+static int get_children(struct node_queue_t* frontier, struct node_t* node, struct location_set_t* explored, struct maze_t maze)
+{
+    // Assert that the pointer to the node queue variable is valid.
+    assert(frontier != NULL);
     // Assert that the pointer to the node variable is valid.
     assert(node != NULL);
-    // Assert that the pointer to the explored node list variable is valid.
+    // Assert that the pointer to the explored location set variable is valid.
     assert(explored != NULL);
 
     struct location_t location = node->location;
@@ -186,7 +653,7 @@ static void get_children(struct node_list_t* list, struct node_t* node, struct n
     struct node_t child;
     child.parent = node;
 
-    // Insert the child nodes reachable by each action to the list.
+    // Push the child nodes reachable by each action onto the frontier.
     for (enum action_t action = EAST; action <= NORTH; action++)
     {
         // Check if the action is contained in the set of actions.
@@ -195,46 +662,128 @@ static void get_children(struct node_list_t* list, struct node_t* node, struct n
         // Get the location reachable by the action.
         child.location = action_result(location, action);
         // Check that there is not already an explored node with this location.
-        if (contains_node(explored, child.location)) continue;
+        if (contains_location(explored, child.location)) continue;
 
-        // Insert the child node into the list.
-        insert_node(list, &child, list->length);
+        // Push the child node onto the frontier, merging it with any node
+        // already queued at the same location.
+        size_t cost = location_distance(child.location, maze.start);
+        if (push_node(frontier, &child, cost) != 0) return -1;
     }
+
+    return 0;
 }
 
-// Define get_best_node (maze.c).
-static size_t get_best_node(struct node_t* best, struct node_list_t* frontier, struct location_t start)
+// Define get_a_star_children (maze.c).
+static int get_a_star_children(struct node_queue_t* frontier, struct node_t* node, struct location_set_t* explored, size_t* costs, struct maze_t maze)
 {
-    // Assert that the pointer to the node variable is valid.
-    assert(best != NULL);
-    // Assert that the pointer to the node list variable is valid.
+    // Assert that the pointer to the node queue variable is valid.
     assert(frontier != NULL);
-    // Assert that the frontier is not empty.
-    assert(frontier->length > 0);
+    // Assert that the pointer to the node variable is valid.
+    assert(node != NULL);
+    // Assert that the pointer to the explored location set variable is valid.
+    assert(explored != NULL);
+    // Assert that the pointer to the costs array is valid.
+    assert(costs != NULL);
 
-    size_t length = frontier->length;
+    struct location_t location = node->location;
 
-    // Store the best estimated cost and the index of the best node.
-    size_t best_cost = (size_t) -1;
-    size_t best_index = 0;
+    // Get the set of actions available for the location.
+    enum action_set_t action_set = get_action_set(maze, location);
+
+    // Every child is reached by taking one more action than the parent.
+    size_t cost = costs[location_index(maze.size, location)] + 1;
 
-    // Search the nodes for the best node.
-    struct node_t node;
-    size_t cost = 0;
-    for (size_t index = 0; index < length; index++)
+    // Create a generic child node variable for reuse in each action.
+    struct node_t child;
+    child.parent = node;
+
+    // Push the child nodes reachable by each action onto the frontier.
+    for (enum action_t action = EAST; action <= NORTH; action++)
+    {
+        // Check if the action is contained in the set of actions.
+        if (!(action_set & (1 << action))) continue;
+
+        // Get the location reachable by the action.
+        child.location = action_result(location, action);
+        // Check that there is not already an explored node with this location.
+        if (contains_location(explored, child.location)) continue;
+
+        // Check that the location has not already been reached by taking the
+        // same number of actions or fewer.
+        size_t index = location_index(maze.size, child.location);
+        if (costs[index] != 0 && costs[index] <= cost) continue;
+        costs[index] = cost;
+
+        // Push the child node onto the frontier, replacing any node already
+        // queued at the same location.
+        size_t estimate = cost - 1 + location_manhattan(child.location, maze.start);
+        if (push_node(frontier, &child, estimate) != 0) return -1;
+    }
+
+    return 0;
+}
+
+// Define expand_level (maze.c).
+static bool expand_level(struct search_side_t* side, unsigned char* states, struct location_t* meeting, enum action_t* action, struct maze_t maze)
+{
+    // Any location reached by the other side marks the meeting of the two.
+    unsigned char other = (side->reached == REACHED_FROM_START) ? REACHED_FROM_END : REACHED_FROM_START;
+
+    // Expand only the locations which were in the frontier at the start of the
+    // level.
+    size_t level_end = side->tail;
+
+    for (; side->head < level_end; side->head++)
     {
-        // Calculate the estimated cost of choosing the node at this index.
-        node = *get_node(frontier, index);
-        cost = location_distance(node.location, start);
+        size_t index = side->queue[side->head];
+        struct location_t location = { index / maze.size.columns, index % maze.size.columns };
+
+        // Get the set of actions available for the location.
+        enum action_set_t action_set = get_action_set(maze, location);
 
-        // If necessary, update the best node, cost and index.
-        if (cost < best_cost)
+        for (enum action_t child_action = EAST; child_action <= NORTH; child_action++)
         {
-            *best = node;
-            best_cost = cost;
-            best_index = index;
+            // Check if the action is contained in the set of actions.
+            if (!(action_set & (1 << child_action))) continue;
+
+            struct location_t child = action_result(location, child_action);
+            size_t child_index = location_index(maze.size, child);
+
+            // If the other side has reached this location, the searches meet.
+            if (states[child_index] & other)
+            {
+                *meeting = location;
+                *action = child_action;
+                return true;
+            }
+
+            // Check that this side has not already reached the location.
+            if (states[child_index] & side->reached) continue;
+
+            // Mark the location as reached, recording the way back.
+            states[child_index] = (unsigned char) (side->reached | reverse_action(child_action));
+            side->queue[side->tail++] = child_index;
         }
     }
 
-    return best_index;
+    return false;
+}
+
+// Define splice_path (maze.c).
+static void splice_path(unsigned char* states, struct location_t location, enum action_t action, struct maze_t maze)
+{
+    // Walk back to the start of the maze, replacing the action leading towards
+    // the start at each location with the action leading towards the end.
+    for (;;)
+    {
+        size_t index = location_index(maze.size, location);
+        enum action_t parent_action = (enum action_t) (states[index] & 0x3);
+
+        states[index] = (unsigned char) ((states[index] & (REACHED_FROM_END | REACHED_FROM_START)) | action);
+
+        if (location_equal(location, maze.start)) break;
+
+        location = action_result(location, parent_action);
+        action = reverse_action(parent_action);
+    }
 }
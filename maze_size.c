@@ -2,9 +2,20 @@
 
 #include "location.h"
 
+#include <assert.h>
+
 
 // Define check_location (maze_size.h).
 bool check_location(struct maze_size_t size, struct location_t location)
 {
     return location.row < size.rows && location.column < size.columns;
 }
+
+// Define location_index (maze_size.h).
+size_t location_index(struct maze_size_t size, struct location_t location)
+{
+    // Assert that the given location is within the maze.
+    assert(check_location(size, location));
+
+    return location.row * size.columns + location.column;
+}
@@ -0,0 +1,391 @@
+#include "maze_tree.h"
+
+#include "action.h"
+#include "action_set.h"
+#include "maze_size.h"
+#include "node.h"
+#include "node_list.h"
+#include "path.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/**
+ * \internal
+ *
+ * Gets the index of the parent of a location in a maze tree.
+ *
+ * \param [in] tree
+ *     A pointer to the maze tree.
+ * \param [in] index
+ *     The index of the location (see location_index()), which must be reached
+ *     and must not be the root.
+ *
+ * \returns
+ *     The index of the parent of the location.
+ */
+static size_t parent_index(const struct maze_tree_t* tree, size_t index);
+
+/**
+ * \internal
+ *
+ * Finds the ancestor of a location in a maze tree at a given depth.
+ *
+ * This helper function follows the jump pointer of each location whenever it
+ * does not lead above the given depth, and the parent otherwise.
+ *
+ * \param [in] tree
+ *     A pointer to the maze tree.
+ * \param [in] index
+ *     The index of the location.
+ * \param [in] depth
+ *     The depth of the ancestor, which must not be greater than the depth of
+ *     the location.
+ *
+ * \returns
+ *     The index of the ancestor.
+ */
+static size_t find_ancestor(const struct maze_tree_t* tree, size_t index, uint32_t depth);
+
+/**
+ * \internal
+ *
+ * Finds the lowest common ancestor of two locations in a maze tree.
+ *
+ * This helper function finds the ancestor of the deeper location at the depth
+ * of the other, then moves both up the tree together. The jump pointer of a
+ * location depends only on its depth, so the jump pointers of the two lead to
+ * the same depth, and are followed whenever they lead to different locations,
+ * which must both be below the common ancestor.
+ *
+ * \param [in] tree
+ *     A pointer to the maze tree.
+ * \param [in] a
+ *     The index of the first location, which must be reached.
+ * \param [in] b
+ *     The index of the second location, which must be reached.
+ *
+ * \returns
+ *     The index of the lowest common ancestor.
+ */
+static size_t find_common_ancestor(const struct maze_tree_t* tree, size_t a, size_t b);
+
+/**
+ * \internal
+ *
+ * Determines if the path through a maze tree between two locations is a
+ * shortest path.
+ *
+ * \param [in] tree
+ *     A pointer to the maze tree.
+ * \param [in] start
+ *     The location the path begins at.
+ * \param [in] end
+ *     The location the path ends at.
+ *
+ * \returns
+ *     Whether the path through the tree is a shortest path.
+ */
+static bool tree_path_exact(const struct maze_tree_t* tree, struct location_t start, struct location_t end);
+
+/**
+ * \internal
+ *
+ * Finds a shortest path between two locations of the maze of a tree using
+ * breadth-first search, reusing the buffers of the tree.
+ *
+ * \param [out]    path
+ *     A pointer to the path variable that will be initialized.
+ * \param [in,out] tree
+ *     A pointer to the maze tree.
+ * \param [in]     start
+ *     The location the path begins at.
+ * \param [in]     end
+ *     The location the path ends at.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int search_tree_path(struct path_t* path, struct maze_tree_t* tree, struct location_t start, struct location_t end);
+
+// Define make_maze_tree (maze_tree.h).
+int make_maze_tree(struct maze_tree_t* tree, struct maze_t maze, struct location_t root)
+{
+    // Assert that the pointer to the maze tree variable is valid.
+    assert(tree != NULL);
+    // Assert that the root is within the maze.
+    assert(check_location(maze.size, root));
+
+    size_t length = maze.size.rows * maze.size.columns;
+
+    // Indicate failure if the depths cannot be held in 32 bits, leaving
+    // UINT32_MAX for locations which are not reached.
+    if (length >= UINT32_MAX) return -1;
+
+    *tree = (struct maze_tree_t) { .maze = maze, .root = root, .acyclic = true };
+
+    if (make_direction_map(&tree->parents, maze.size) != 0) return -1;
+
+    tree->depths = (uint32_t*) malloc(length * sizeof(uint32_t));
+    tree->jumps = (uint32_t*) malloc(length * sizeof(uint32_t));
+
+    // Create the queue of the search. Each location is added at most once, so
+    // the queue can never hold more locations than the maze.
+    uint32_t* queue = (uint32_t*) malloc(length * sizeof(uint32_t));
+
+    if (tree->depths == NULL || tree->jumps == NULL || queue == NULL)
+    {
+        free(queue);
+        free_maze_tree(tree);
+        return -1;
+    }
+
+    memset(tree->depths, 0xFF, length * sizeof(uint32_t));
+
+    // Begin the search at the root, whose jump pointer leads to itself.
+    size_t head = 0;
+    size_t tail = 0;
+    size_t root_index = location_index(maze.size, root);
+
+    tree->depths[root_index] = 0;
+    tree->jumps[root_index] = (uint32_t) root_index;
+    queue[tail++] = (uint32_t) root_index;
+
+    // Count the actions between locations reached, so that loops can be found.
+    size_t actions = 0;
+
+    while (head < tail)
+    {
+        uint32_t index = queue[head++];
+        struct location_t location = { index / maze.size.columns, index % maze.size.columns };
+
+        // Get the set of actions available for the location.
+        enum action_set_t action_set = get_action_set(maze, location);
+
+        for (enum action_t action = EAST; action <= NORTH; action++)
+        {
+            // Check if the action is contained in the set of actions.
+            if (!(action_set & (1 << action))) continue;
+
+            struct location_t child = action_result(location, action);
+            if (!check_location(maze.size, child)) continue;
+
+            actions++;
+
+            // Check that the location reachable by the action has not already
+            // been reached.
+            size_t child_index = location_index(maze.size, child);
+            if (tree->depths[child_index] != UINT32_MAX) continue;
+
+            tree->depths[child_index] = tree->depths[index] + 1;
+            set_direction(&tree->parents, child_index, reverse_action(action));
+
+            // Jump from the child to the jump of the jump of its parent if the
+            // parent's jump covers the same number of levels as that jump, and
+            // to the parent otherwise, so that the jumps double in length.
+            uint32_t jump = tree->jumps[index];
+            uint32_t jump_jump = tree->jumps[jump];
+
+            bool doubled = tree->depths[index] - tree->depths[jump] == tree->depths[jump] - tree->depths[jump_jump];
+            tree->jumps[child_index] = doubled ? jump_jump : index;
+
+            queue[tail++] = (uint32_t) child_index;
+        }
+    }
+
+    free(queue);
+
+    // Every passage between locations reached is counted from both ends, so a
+    // tree of them has two actions for each location apart from the root.
+    tree->acyclic = actions == 2 * (tail - 1);
+
+    // Keep the buffers to search for paths which the tree cannot answer.
+    if (!tree->acyclic && make_compact_search(&tree->search, maze.size) != 0)
+    {
+        free_maze_tree(tree);
+        return -1;
+    }
+
+    return 0;
+}
+
+// Define free_maze_tree (maze_tree.h).
+void free_maze_tree(struct maze_tree_t* tree)
+{
+    // Assert that the pointer to the maze tree variable is valid.
+    assert(tree != NULL);
+
+    if (!tree->acyclic) free_compact_search(&tree->search);
+
+    free(tree->jumps);
+    free(tree->depths);
+    free_direction_map(&tree->parents);
+
+    tree->depths = NULL;
+    tree->jumps = NULL;
+    tree->acyclic = true;
+}
+
+// Define tree_path_length (maze_tree.h).
+int tree_path_length(struct maze_tree_t* tree, struct location_t start, struct location_t end, size_t* length)
+{
+    // Assert that the pointer to the maze tree variable is valid.
+    assert(tree != NULL);
+    // Assert that the pointer to the length variable is valid.
+    assert(length != NULL);
+
+    struct maze_size_t size = tree->maze.size;
+    if (!check_location(size, start) || !check_location(size, end)) return -1;
+
+    size_t start_index = location_index(size, start);
+    size_t end_index = location_index(size, end);
+
+    if (tree->depths[start_index] == UINT32_MAX || tree->depths[end_index] == UINT32_MAX) return -1;
+
+    if (!tree_path_exact(tree, start, end))
+    {
+        struct path_t path;
+        if (search_tree_path(&path, tree, start, end) != 0) return -1;
+
+        *length = path.length;
+        free_path(&path);
+
+        return 0;
+    }
+
+    uint32_t ancestor_depth = tree->depths[find_common_ancestor(tree, start_index, end_index)];
+    *length = (size_t) (tree->depths[start_index] - ancestor_depth) + (size_t) (tree->depths[end_index] - ancestor_depth);
+
+    return 0;
+}
+
+// Define solve_tree_path (maze_tree.h).
+int solve_tree_path(struct path_t* path, struct maze_tree_t* tree, struct location_t start, struct location_t end)
+{
+    // Assert that the pointer to the path variable is valid.
+    assert(path != NULL);
+    // Assert that the pointer to the maze tree variable is valid.
+    assert(tree != NULL);
+
+    struct maze_size_t size = tree->maze.size;
+    if (!check_location(size, start) || !check_location(size, end)) return -1;
+
+    size_t start_index = location_index(size, start);
+    size_t end_index = location_index(size, end);
+
+    if (tree->depths[start_index] == UINT32_MAX || tree->depths[end_index] == UINT32_MAX) return -1;
+
+    if (!tree_path_exact(tree, start, end)) return search_tree_path(path, tree, start, end);
+
+    uint32_t ancestor_depth = tree->depths[find_common_ancestor(tree, start_index, end_index)];
+    size_t up = tree->depths[start_index] - ancestor_depth;
+    size_t down = tree->depths[end_index] - ancestor_depth;
+
+    // Allocate the memory required for the actions, with at least one byte so
+    // that an empty path is not mistaken for a failed allocation.
+    unsigned char* actions = (unsigned char*) malloc(up + down > 0 ? up + down : 1);
+    if (actions == NULL) return -1;
+
+    // Follow the parents up from the start, taking the action to each parent.
+    size_t index = start_index;
+    for (size_t step = 0; step < up; step++)
+    {
+        actions[step] = (unsigned char) get_direction(&tree->parents, index);
+        index = parent_index(tree, index);
+    }
+
+    // Follow the parents up from the end, filling the actions back to front
+    // with the action leading down from each parent.
+    index = end_index;
+    for (size_t step = 0; step < down; step++)
+    {
+        actions[up + down - 1 - step] = (unsigned char) reverse_action(get_direction(&tree->parents, index));
+        index = parent_index(tree, index);
+    }
+
+    path->actions = actions;
+    path->length = up + down;
+
+    return 0;
+}
+
+// Define parent_index (maze_tree.c).
+static size_t parent_index(const struct maze_tree_t* tree, size_t index)
+{
+    // Cast away the constness, as the direction map is only read.
+    enum action_t action = get_direction((struct direction_map_t*) &tree->parents, index);
+
+    switch (action)
+    {
+        case EAST:
+            return index + 1;
+        case SOUTH:
+            return index + tree->maze.size.columns;
+        case WEST:
+            return index - 1;
+        case NORTH:
+            return index - tree->maze.size.columns;
+    }
+}
+
+// Define find_ancestor (maze_tree.c).
+static size_t find_ancestor(const struct maze_tree_t* tree, size_t index, uint32_t depth)
+{
+    while (tree->depths[index] > depth)
+    {
+        uint32_t jump = tree->jumps[index];
+        index = (tree->depths[jump] >= depth) ? jump : parent_index(tree, index);
+    }
+
+    return index;
+}
+
+// Define find_common_ancestor (maze_tree.c).
+static size_t find_common_ancestor(const struct maze_tree_t* tree, size_t a, size_t b)
+{
+    // Bring the deeper location up to the depth of the other.
+    if (tree->depths[a] > tree->depths[b]) a = find_ancestor(tree, a, tree->depths[b]);
+    else b = find_ancestor(tree, b, tree->depths[a]);
+
+    while (a != b)
+    {
+        if (tree->jumps[a] != tree->jumps[b])
+        {
+            a = tree->jumps[a];
+            b = tree->jumps[b];
+        }
+        else
+        {
+            a = parent_index(tree, a);
+            b = parent_index(tree, b);
+        }
+    }
+
+    return a;
+}
+
+// Define tree_path_exact (maze_tree.c).
+static bool tree_path_exact(const struct maze_tree_t* tree, struct location_t start, struct location_t end)
+{
+    return tree->acyclic || location_equal(start, tree->root) || location_equal(end, tree->root);
+}
+
+// Define search_tree_path (maze_tree.c).
+static int search_tree_path(struct path_t* path, struct maze_tree_t* tree, struct location_t start, struct location_t end)
+{
+    struct maze_t maze = tree->maze;
+    maze.start = start;
+    maze.end = end;
+
+    struct node_list_t list;
+    if (make_list(&list, 0) != 0) return -1;
+
+    int result = solve_maze_compact_buffered(&list, maze, &tree->search);
+    if (result == 0) result = make_path(path, get_node(&list, list.length - 1));
+
+    resize_list(&list, 0);
+
+    return result;
+}
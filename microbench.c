@@ -0,0 +1,831 @@
+#include "location.h"
+#include "maze_size.h"
+#include "action.h"
+#include "node.h"
+#include "node_list.h"
+#include "node_queue.h"
+#include "location_set.h"
+#include "stats.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifdef MICROBENCH
+
+/**
+ * \internal
+ *
+ * The number of rows and columns of the maze that the locations used by the
+ * benchmarks lie within.
+ */
+#define MICRO_MAZE_SIZE 1024
+
+/**
+ * \internal
+ *
+ * The number of pseudo-random locations and actions used by the benchmarks,
+ * which is enough for the searched lists to hold distinct locations while
+ * staying in the cache, and a power of two so that the benchmarks can cycle
+ * through them with a mask.
+ */
+#define MICRO_INPUTS 65536
+
+/**
+ * \internal
+ *
+ * Represents the data used by the micro-benchmarks.
+ *
+ * This struct contains the pseudo-random inputs shared by every benchmark,
+ * along with the data structures exercised by them, which are prepared before
+ * each timed run so that only the primitive under test is measured.
+ */
+struct fixture_t
+{
+    struct location_t* locations;
+    enum action_t* actions;
+    struct node_list_t list;
+    struct location_set_t set;
+    struct node_queue_t queue;
+};
+
+/**
+ * \internal
+ *
+ * Represents a micro-benchmark of a single primitive.
+ *
+ * This struct contains the name of the benchmark, the size of the data
+ * structure it exercises, the number of operations in each timed run, a
+ * function which prepares the fixture before each run without being timed,
+ * which may be NULL, and a function which performs the operations, returning a
+ * value computed from their results so that they cannot be optimised away.
+ */
+struct micro_benchmark_t
+{
+    const char* name;
+    size_t size;
+    size_t operations;
+    void (*prepare)(struct fixture_t* fixture, size_t size);
+    size_t (*run)(struct fixture_t* fixture, size_t size, size_t operations);
+};
+
+/**
+ * \internal
+ *
+ * The variable that the result of every run is written to. As it is volatile,
+ * the compiler must compute each result, and so every operation of the run.
+ */
+static volatile size_t sink;
+
+/**
+ * \internal
+ *
+ * Gets the current value of the time stamp counter, which counts cycles at a
+ * constant reference rate, or zero if the processor has no such counter.
+ *
+ * \returns
+ *     The value of the time stamp counter.
+ */
+static uint64_t read_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    // Wait for earlier instructions to finish, so that they are not counted
+    // in the next run.
+    _mm_lfence();
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * \internal
+ *
+ * Compares two measurements for sorting in ascending order with qsort().
+ *
+ * \param [in] a
+ *     A pointer to the first of the measurements.
+ * \param [in] b
+ *     A pointer to the second of the measurements.
+ *
+ * \returns
+ *     A negative number, zero or a positive number if the first measurement is
+ *     less than, equal to or greater than the second.
+ */
+static int compare_measurements(const void* a, const void* b)
+{
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * \internal
+ *
+ * Gets the node with a given pseudo-random location of the fixture.
+ *
+ * \param [in] fixture
+ *     A pointer to the fixture.
+ * \param [in] index
+ *     The index of the location, which wraps around the inputs.
+ *
+ * \returns
+ *     A node with the location and no parent.
+ */
+static struct node_t input_node(struct fixture_t* fixture, size_t index)
+{
+    return (struct node_t) { fixture->locations[index & (MICRO_INPUTS - 1)], NULL };
+}
+
+/**
+ * \internal
+ *
+ * Empties the node list of the fixture, keeping its capacity, so that nodes can
+ * be inserted into it.
+ *
+ * \param [in,out] fixture
+ *     A pointer to the fixture.
+ * \param [in]     size
+ *     The size of the benchmark, which is unused.
+ */
+static void prepare_empty_list(struct fixture_t* fixture, size_t size);
+
+/**
+ * \internal
+ *
+ * Fills the node list of the fixture with nodes at the first of the
+ * pseudo-random locations.
+ *
+ * \param [in,out] fixture
+ *     A pointer to the fixture.
+ * \param [in]     size
+ *     The number of nodes to fill the list with.
+ */
+static void prepare_full_list(struct fixture_t* fixture, size_t size);
+
+/**
+ * \internal
+ *
+ * Clears the location set of the fixture, so that locations can be added to it.
+ *
+ * \param [in,out] fixture
+ *     A pointer to the fixture.
+ * \param [in]     size
+ *     The size of the benchmark, which is unused.
+ */
+static void prepare_empty_set(struct fixture_t* fixture, size_t size);
+
+/**
+ * \internal
+ *
+ * Fills the location set of the fixture with the first of the pseudo-random
+ * locations.
+ *
+ * \param [in,out] fixture
+ *     A pointer to the fixture.
+ * \param [in]     size
+ *     The number of locations to add to the set.
+ */
+static void prepare_full_set(struct fixture_t* fixture, size_t size);
+
+/**
+ * \internal
+ *
+ * Finds the distance between pairs of consecutive pseudo-random locations with
+ * location_distance().
+ *
+ * \param [in] fixture
+ *     A pointer to the fixture.
+ * \param [in] size
+ *     The size of the benchmark, which is unused.
+ * \param [in] operations
+ *     The number of operations to perform.
+ *
+ * \returns
+ *     A value computed from the results of the operations.
+ */
+static size_t run_location_distance(struct fixture_t* fixture, size_t size, size_t operations);
+
+/**
+ * \internal
+ *
+ * Finds the Manhattan distance between pairs of consecutive pseudo-random
+ * locations with location_manhattan().
+ *
+ * \param [in] fixture
+ *     A pointer to the fixture.
+ * \param [in] size
+ *     The size of the benchmark, which is unused.
+ * \param [in] operations
+ *     The number of operations to perform.
+ *
+ * \returns
+ *     A value computed from the results of the operations.
+ */
+static size_t run_location_manhattan(struct fixture_t* fixture, size_t size, size_t operations);
+
+/**
+ * \internal
+ *
+ * Compares pairs of pseudo-random locations with location_equal().
+ *
+ * \param [in] fixture
+ *     A pointer to the fixture.
+ * \param [in] size
+ *     The size of the benchmark, which is unused.
+ * \param [in] operations
+ *     The number of operations to perform.
+ *
+ * \returns
+ *     A value computed from the results of the operations.
+ */
+static size_t run_location_equal(struct fixture_t* fixture, size_t size, size_t operations);
+
+/**
+ * \internal
+ *
+ * Takes a pseudo-random action from each pseudo-random location with
+ * action_result().
+ *
+ * \param [in] fixture
+ *     A pointer to the fixture.
+ * \param [in] size
+ *     The size of the benchmark, which is unused.
+ * \param [in] operations
+ *     The number of operations to perform.
+ *
+ * \returns
+ *     A value computed from the results of the operations.
+ */
+static size_t run_action_result(struct fixture_t* fixture, size_t size, size_t operations);
+
+/**
+ * \internal
+ *
+ * Takes a pseudo-random action from each pseudo-random location, then finds the
+ * action taken with action_taken().
+ *
+ * \param [in] fixture
+ *     A pointer to the fixture.
+ * \param [in] size
+ *     The size of the benchmark, which is unused.
+ * \param [in] operations
+ *     The number of operations to perform.
+ *
+ * \returns
+ *     A value computed from the results of the operations.
+ */
+static size_t run_action_taken(struct fixture_t* fixture, size_t size, size_t operations);
+
+/**
+ * \internal
+ *
+ * Inserts nodes at the back of the node list of the fixture with insert_node().
+ *
+ * \param [in,out] fixture
+ *     A pointer to the fixture.
+ * \param [in]     size
+ *     The size of the benchmark, which is unused.
+ * \param [in]     operations
+ *     The number of operations to perform.
+ *
+ * \returns
+ *     A value computed from the results of the operations.
+ */
+static size_t run_insert_node_back(struct fixture_t* fixture, size_t size, size_t operations);
+
+/**
+ * \internal
+ *
+ * Inserts nodes at the front of the node list of the fixture with
+ * insert_node(), moving every node already in the list.
+ *
+ * \param [in,out] fixture
+ *     A pointer to the fixture.
+ * \param [in]     size
+ *     The size of the benchmark, which is unused.
+ * \param [in]     operations
+ *     The number of operations to perform.
+ *
+ * \returns
+ *     A value computed from the results of the operations.
+ */
+static size_t run_insert_node_front(struct fixture_t* fixture, size_t size, size_t operations);
+
+/**
+ * \internal
+ *
+ * Removes nodes from the back of the node list of the fixture with
+ * remove_node().
+ *
+ * \param [in,out] fixture
+ *     A pointer to the fixture.
+ * \param [in]     size
+ *     The size of the benchmark, which is unused.
+ * \param [in]     operations
+ *     The number of operations to perform.
+ *
+ * \returns
+ *     A value computed from the results of the operations.
+ */
+static size_t run_remove_node_back(struct fixture_t* fixture, size_t size, size_t operations);
+
+/**
+ * \internal
+ *
+ * Removes nodes from the front of the node list of the fixture with
+ * remove_node(), moving every node left in the list.
+ *
+ * \param [in,out] fixture
+ *     A pointer to the fixture.
+ * \param [in]     size
+ *     The size of the benchmark, which is unused.
+ * \param [in]     operations
+ *     The number of operations to perform.
+ *
+ * \returns
+ *     A value computed from the results of the operations.
+ */
+static size_t run_remove_node_front(struct fixture_t* fixture, size_t size, size_t operations);
+
+/**
+ * \internal
+ *
+ * Searches the node list of the fixture with contains_node() for locations of
+ * which half are in the list and half are missing.
+ *
+ * \param [in] fixture
+ *     A pointer to the fixture.
+ * \param [in] size
+ *     The number of nodes in the list.
+ * \param [in] operations
+ *     The number of operations to perform.
+ *
+ * \returns
+ *     A value computed from the results of the operations.
+ */
+static size_t run_contains_node(struct fixture_t* fixture, size_t size, size_t operations);
+
+/**
+ * \internal
+ *
+ * Gets nodes spread across the node list of the fixture with get_node().
+ *
+ * \param [in] fixture
+ *     A pointer to the fixture.
+ * \param [in] size
+ *     The number of nodes in the list.
+ * \param [in] operations
+ *     The number of operations to perform.
+ *
+ * \returns
+ *     A value computed from the results of the operations.
+ */
+static size_t run_get_node(struct fixture_t* fixture, size_t size, size_t operations);
+
+/**
+ * \internal
+ *
+ * Adds pseudo-random locations to the location set of the fixture with
+ * add_location().
+ *
+ * \param [in,out] fixture
+ *     A pointer to the fixture.
+ * \param [in]     size
+ *     The size of the benchmark, which is unused.
+ * \param [in]     operations
+ *     The number of operations to perform.
+ *
+ * \returns
+ *     A value computed from the results of the operations.
+ */
+static size_t run_add_location(struct fixture_t* fixture, size_t size, size_t operations);
+
+/**
+ * \internal
+ *
+ * Checks the location set of the fixture for pseudo-random locations with
+ * contains_location().
+ *
+ * \param [in] fixture
+ *     A pointer to the fixture.
+ * \param [in] size
+ *     The size of the benchmark, which is unused.
+ * \param [in] operations
+ *     The number of operations to perform.
+ *
+ * \returns
+ *     A value computed from the results of the operations.
+ */
+static size_t run_contains_location(struct fixture_t* fixture, size_t size, size_t operations);
+
+/**
+ * \internal
+ *
+ * Pushes nodes onto the queue of the fixture with push_node(), then pops them
+ * all with pop_node(), as a search does.
+ *
+ * \param [in,out] fixture
+ *     A pointer to the fixture.
+ * \param [in]     size
+ *     The size of the benchmark, which is unused.
+ * \param [in]     operations
+ *     The number of operations to perform.
+ *
+ * \returns
+ *     A value computed from the results of the operations.
+ */
+static size_t run_push_pop_node(struct fixture_t* fixture, size_t size, size_t operations);
+
+// Define prepare_empty_list (microbench.c).
+static void prepare_empty_list(struct fixture_t* fixture, size_t size)
+{
+    (void) size;
+    fixture->list.length = 0;
+}
+
+// Define prepare_full_list (microbench.c).
+static void prepare_full_list(struct fixture_t* fixture, size_t size)
+{
+    fixture->list.length = 0;
+
+    for (size_t index = 0; index < size; index++)
+    {
+        struct node_t node = input_node(fixture, index);
+        insert_node(&fixture->list, &node, index);
+    }
+}
+
+// Define prepare_empty_set (microbench.c).
+static void prepare_empty_set(struct fixture_t* fixture, size_t size)
+{
+    (void) size;
+    clear_location_set(&fixture->set);
+}
+
+// Define prepare_full_set (microbench.c).
+static void prepare_full_set(struct fixture_t* fixture, size_t size)
+{
+    clear_location_set(&fixture->set);
+
+    for (size_t index = 0; index < size; index++)
+    {
+        add_location(&fixture->set, fixture->locations[index & (MICRO_INPUTS - 1)]);
+    }
+}
+
+// Define run_location_distance (microbench.c).
+static size_t run_location_distance(struct fixture_t* fixture, size_t size, size_t operations)
+{
+    (void) size;
+    size_t result = 0;
+
+    for (size_t index = 0; index < operations; index++)
+    {
+        result += location_distance(fixture->locations[index & (MICRO_INPUTS - 1)],
+                                    fixture->locations[(index + 1) & (MICRO_INPUTS - 1)]);
+    }
+
+    return result;
+}
+
+// Define run_location_manhattan (microbench.c).
+static size_t run_location_manhattan(struct fixture_t* fixture, size_t size, size_t operations)
+{
+    (void) size;
+    size_t result = 0;
+
+    for (size_t index = 0; index < operations; index++)
+    {
+        result += location_manhattan(fixture->locations[index & (MICRO_INPUTS - 1)],
+                                     fixture->locations[(index + 1) & (MICRO_INPUTS - 1)]);
+    }
+
+    return result;
+}
+
+// Define run_location_equal (microbench.c).
+static size_t run_location_equal(struct fixture_t* fixture, size_t size, size_t operations)
+{
+    (void) size;
+    size_t result = 0;
+
+    for (size_t index = 0; index < operations; index++)
+    {
+        result += location_equal(fixture->locations[index & (MICRO_INPUTS - 1)],
+                                 fixture->locations[(index * 7) & (MICRO_INPUTS - 1)]);
+    }
+
+    return result;
+}
+
+// Define run_action_result (microbench.c).
+static size_t run_action_result(struct fixture_t* fixture, size_t size, size_t operations)
+{
+    (void) size;
+    size_t result = 0;
+
+    for (size_t index = 0; index < operations; index++)
+    {
+        struct location_t location = action_result(fixture->locations[index & (MICRO_INPUTS - 1)],
+                                                   fixture->actions[index & (MICRO_INPUTS - 1)]);
+        result += location.row ^ location.column;
+    }
+
+    return result;
+}
+
+// Define run_action_taken (microbench.c).
+static size_t run_action_taken(struct fixture_t* fixture, size_t size, size_t operations)
+{
+    (void) size;
+    size_t result = 0;
+
+    for (size_t index = 0; index < operations; index++)
+    {
+        // Take the action from each location, then find which action it was.
+        struct location_t location = fixture->locations[index & (MICRO_INPUTS - 1)];
+        struct location_t next = action_result(location, fixture->actions[index & (MICRO_INPUTS - 1)]);
+        enum action_t action = EAST;
+
+        result += (size_t) action_taken(&action, location, next) + (size_t) action;
+    }
+
+    return result;
+}
+
+// Define run_insert_node_back (microbench.c).
+static size_t run_insert_node_back(struct fixture_t* fixture, size_t size, size_t operations)
+{
+    (void) size;
+
+    for (size_t index = 0; index < operations; index++)
+    {
+        struct node_t node = input_node(fixture, index);
+        insert_node(&fixture->list, &node, fixture->list.length);
+    }
+
+    return fixture->list.length + get_node(&fixture->list, operations / 2)->location.row;
+}
+
+// Define run_insert_node_front (microbench.c).
+static size_t run_insert_node_front(struct fixture_t* fixture, size_t size, size_t operations)
+{
+    (void) size;
+
+    for (size_t index = 0; index < operations; index++)
+    {
+        struct node_t node = input_node(fixture, index);
+        insert_node(&fixture->list, &node, 0);
+    }
+
+    return fixture->list.length + get_node(&fixture->list, operations / 2)->location.row;
+}
+
+// Define run_remove_node_back (microbench.c).
+static size_t run_remove_node_back(struct fixture_t* fixture, size_t size, size_t operations)
+{
+    (void) size;
+
+    for (size_t index = 0; index < operations; index++)
+    {
+        remove_node(&fixture->list, fixture->list.length - 1);
+    }
+
+    return fixture->list.length;
+}
+
+// Define run_remove_node_front (microbench.c).
+static size_t run_remove_node_front(struct fixture_t* fixture, size_t size, size_t operations)
+{
+    (void) size;
+    size_t result = 0;
+
+    for (size_t index = 0; index < operations; index++)
+    {
+        result += get_node(&fixture->list, 0)->location.column;
+        remove_node(&fixture->list, 0);
+    }
+
+    return result + fixture->list.length;
+}
+
+// Define run_contains_node (microbench.c).
+static size_t run_contains_node(struct fixture_t* fixture, size_t size, size_t operations)
+{
+    size_t result = 0;
+
+    // Search for locations of which half are in the list, and the other half
+    // of which lie below the maze, so are missing and scan the whole list.
+    for (size_t index = 0; index < operations; index++)
+    {
+        struct location_t location = fixture->locations[index % size];
+        if (index & 1) location.row += MICRO_MAZE_SIZE;
+
+        result += contains_node(&fixture->list, location);
+    }
+
+    return result;
+}
+
+// Define run_get_node (microbench.c).
+static size_t run_get_node(struct fixture_t* fixture, size_t size, size_t operations)
+{
+    size_t result = 0;
+
+    for (size_t index = 0; index < operations; index++)
+    {
+        result += get_node(&fixture->list, (index * 7919) % size)->location.row;
+    }
+
+    return result;
+}
+
+// Define run_add_location (microbench.c).
+static size_t run_add_location(struct fixture_t* fixture, size_t size, size_t operations)
+{
+    (void) size;
+
+    for (size_t index = 0; index < operations; index++)
+    {
+        add_location(&fixture->set, fixture->locations[index & (MICRO_INPUTS - 1)]);
+    }
+
+    return contains_location(&fixture->set, fixture->locations[0]);
+}
+
+// Define run_contains_location (microbench.c).
+static size_t run_contains_location(struct fixture_t* fixture, size_t size, size_t operations)
+{
+    (void) size;
+    size_t result = 0;
+
+    for (size_t index = 0; index < operations; index++)
+    {
+        result += contains_location(&fixture->set, fixture->locations[(index * 3) & (MICRO_INPUTS - 1)]);
+    }
+
+    return result;
+}
+
+// Define run_push_pop_node (microbench.c).
+static size_t run_push_pop_node(struct fixture_t* fixture, size_t size, size_t operations)
+{
+    (void) size;
+    size_t result = 0;
+
+    // Push half of the operations, then pop them all, as a search does.
+    for (size_t index = 0; index < operations / 2; index++)
+    {
+        struct node_t node = { { index / MICRO_MAZE_SIZE, index % MICRO_MAZE_SIZE }, NULL };
+        push_node(&fixture->queue, &node, fixture->locations[index & (MICRO_INPUTS - 1)].row);
+    }
+
+    struct node_t node;
+    while (fixture->queue.length > 0) result += pop_node(&fixture->queue, &node);
+
+    return result;
+}
+
+/**
+ * \internal
+ *
+ * The micro-benchmarks, in the order they are run. The sizes of the node lists
+ * cover the lengths seen when solving small and large mazes, and each run of a
+ * benchmark whose cost grows with the size does a similar amount of work.
+ */
+static const struct micro_benchmark_t benchmarks[] =
+{
+    { "location_distance",      0,       1 << 22, NULL,               run_location_distance },
+    { "location_manhattan",     0,       1 << 22, NULL,               run_location_manhattan },
+    { "location_equal",         0,       1 << 22, NULL,               run_location_equal },
+    { "action_result",          0,       1 << 22, NULL,               run_action_result },
+    { "action_taken",           0,       1 << 22, NULL,               run_action_taken },
+    { "insert_node_back",       1 << 10, 1 << 10, prepare_empty_list, run_insert_node_back },
+    { "insert_node_back",       1 << 20, 1 << 20, prepare_empty_list, run_insert_node_back },
+    { "insert_node_front",      1 << 10, 1 << 10, prepare_empty_list, run_insert_node_front },
+    { "insert_node_front",      1 << 14, 1 << 14, prepare_empty_list, run_insert_node_front },
+    { "remove_node_back",       1 << 20, 1 << 20, prepare_full_list,  run_remove_node_back },
+    { "remove_node_front",      1 << 10, 1 << 10, prepare_full_list,  run_remove_node_front },
+    { "remove_node_front",      1 << 14, 1 << 14, prepare_full_list,  run_remove_node_front },
+    { "contains_node",          1 << 6,  1 << 16, prepare_full_list,  run_contains_node },
+    { "contains_node",          1 << 10, 1 << 12, prepare_full_list,  run_contains_node },
+    { "contains_node",          1 << 14, 1 << 8,  prepare_full_list,  run_contains_node },
+    { "get_node",               1 << 20, 1 << 22, prepare_full_list,  run_get_node },
+    { "add_location",           0,       1 << 22, prepare_empty_set,  run_add_location },
+    { "contains_location",      1 << 12, 1 << 22, prepare_full_set,   run_contains_location },
+    { "push_pop_node",          1 << 10, 1 << 11, NULL,               run_push_pop_node },
+    { "push_pop_node",          1 << 18, 1 << 19, NULL,               run_push_pop_node }
+};
+
+int main(int argc, char** argv)
+{
+    if (argc > 3)
+    {
+        printf("Usage: maze [repetitions] [filter]\n");
+        return -1;
+    }
+
+    size_t repetitions = (argc > 1) ? strtoul(argv[1], NULL, 10) : 15;
+    const char* filter = (argc > 2) ? argv[2] : NULL;
+
+    if (repetitions == 0)
+    {
+        printf("The number of repetitions must not be zero\n");
+        return -1;
+    }
+
+    // Create the pseudo-random inputs, which lie within a maze of the given
+    // size, along with the data structures, which are big enough for every
+    // benchmark so that they never grow while timed.
+    struct maze_size_t size = { MICRO_MAZE_SIZE, MICRO_MAZE_SIZE };
+    struct fixture_t fixture;
+    fixture.locations = (struct location_t*) malloc(MICRO_INPUTS * sizeof(struct location_t));
+    fixture.actions = (enum action_t*) malloc(MICRO_INPUTS * sizeof(enum action_t));
+    double* nanoseconds = (double*) malloc(repetitions * sizeof(double));
+    double* cycles = (double*) malloc(repetitions * sizeof(double));
+
+    if (fixture.locations == NULL || fixture.actions == NULL || nanoseconds == NULL || cycles == NULL
+     || make_list(&fixture.list, 1 << 20) != 0)
+    {
+        printf("Failed to allocate the benchmark data\n");
+        return -1;
+    }
+
+    if (make_location_set(&fixture.set, size) != 0 || make_queue(&fixture.queue, size, 1 << 18) != 0)
+    {
+        printf("Failed to allocate the benchmark data\n");
+        return -1;
+    }
+
+    uint64_t state = 0x2545F4914F6CDD1DULL;
+    for (size_t index = 0; index < MICRO_INPUTS; index++)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        fixture.locations[index] = (struct location_t) { (size_t) (state % MICRO_MAZE_SIZE), (size_t) ((state >> 20) % MICRO_MAZE_SIZE) };
+        fixture.actions[index] = (enum action_t) ((state >> 40) & 3);
+    }
+
+    // Keep the actions within the maze, so that every action is realistic.
+    for (size_t index = 0; index < MICRO_INPUTS; index++)
+    {
+        struct location_t location = fixture.locations[index];
+        if (location.row == 0 && fixture.actions[index] == NORTH) fixture.actions[index] = SOUTH;
+        if (location.column == 0 && fixture.actions[index] == WEST) fixture.actions[index] = EAST;
+    }
+
+    printf("%-20s %10s %10s %10s %10s %10s\n", "benchmark", "size", "ops", "ns/op", "cycles/op", "min_ns/op");
+
+    for (size_t index = 0; index < sizeof(benchmarks) / sizeof(benchmarks[0]); index++)
+    {
+        const struct micro_benchmark_t* benchmark = &benchmarks[index];
+        if (filter != NULL && strstr(benchmark->name, filter) == NULL) continue;
+
+        // Time each run separately, preparing the fixture beforehand.
+        for (size_t repetition = 0; repetition < repetitions; repetition++)
+        {
+            if (benchmark->prepare != NULL) benchmark->prepare(&fixture, benchmark->size);
+
+            uint64_t begin_cycles = read_cycles();
+            uint64_t begin = monotonic_time();
+
+            sink = benchmark->run(&fixture, benchmark->size, benchmark->operations);
+
+            uint64_t end = monotonic_time();
+            uint64_t end_cycles = read_cycles();
+
+            nanoseconds[repetition] = (double) (end - begin) / (double) benchmark->operations;
+            cycles[repetition] = (double) (end_cycles - begin_cycles) / (double) benchmark->operations;
+        }
+
+        // Report the median of the runs, along with the fastest run, which is
+        // the least disturbed by the rest of the system.
+        qsort(nanoseconds, repetitions, sizeof(double), compare_measurements);
+        qsort(cycles, repetitions, sizeof(double), compare_measurements);
+
+        printf("%-20s %10zu %10zu %10.2f %10.2f %10.2f\n", benchmark->name, benchmark->size, benchmark->operations,
+               nanoseconds[repetitions / 2], cycles[repetitions / 2], nanoseconds[0]);
+    }
+
+    free_queue(&fixture.queue);
+    free_location_set(&fixture.set);
+    resize_list(&fixture.list, 0);
+    free(cycles);
+    free(nanoseconds);
+    free(fixture.actions);
+    free(fixture.locations);
+
+    return 0;
+}
+
+#endif // MICROBENCH
@@ -0,0 +1,294 @@
+#include "node_queue.h"
+
+#include "location.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+
+/**
+ * \internal
+ *
+ * Determines if one queued node should be popped before another.
+ *
+ * This helper function orders queued nodes by cost, then by the order in which
+ * they were queued, so that nodes of equal cost are popped first in, first out.
+ *
+ * \param [in] a
+ *     A pointer to the first of the queued nodes.
+ * \param [in] b
+ *     A pointer to the second of the queued nodes.
+ *
+ * \returns
+ *     Whether the first queued node should be popped before the second.
+ */
+static bool precedes(struct queued_node_t* a, struct queued_node_t* b);
+
+/**
+ * \internal
+ *
+ * Places a queued node at a given position in the heap of a queue.
+ *
+ * This helper function copies the queued node into the heap and records the
+ * new position of its location.
+ *
+ * \param [in,out] queue
+ *     A pointer to the node queue.
+ * \param [in]     queued
+ *     The queued node to place.
+ * \param [in]     position
+ *     The position in the heap to place the queued node at.
+ */
+static void place_node(struct node_queue_t* queue, struct queued_node_t queued, size_t position);
+
+/**
+ * \internal
+ *
+ * Moves the queued node at a given position up the heap of a queue until the
+ * heap is ordered.
+ *
+ * \param [in,out] queue
+ *     A pointer to the node queue.
+ * \param [in]     position
+ *     The position in the heap of the queued node to move.
+ */
+static void sift_up(struct node_queue_t* queue, size_t position);
+
+/**
+ * \internal
+ *
+ * Moves the queued node at a given position down the heap of a queue until the
+ * heap is ordered.
+ *
+ * \param [in,out] queue
+ *     A pointer to the node queue.
+ * \param [in]     position
+ *     The position in the heap of the queued node to move.
+ */
+static void sift_down(struct node_queue_t* queue, size_t position);
+
+// Define make_queue (node_queue.h).
+int make_queue(struct node_queue_t* queue, struct maze_size_t size, size_t initial_capacity)
+{
+    // Assert that the pointer to the node queue variable is valid.
+    assert(queue != NULL);
+
+    // Allocate the memory required for the heap.
+    void* nodes = malloc(initial_capacity * sizeof(struct queued_node_t));
+
+    // Indicate failure if allocation failed, if allocation was required.
+    if (nodes == NULL && initial_capacity != 0) return -1;
+
+    // Allocate the memory required for the positions, which are initially zero
+    // as no locations are queued.
+    void* positions = calloc(size.rows * size.columns, sizeof(size_t));
+
+    // Indicate failure if allocation failed.
+    if (positions == NULL)
+    {
+        free(nodes);
+        return -1;
+    }
+
+    // Initialize queue properties.
+    queue->nodes = (struct queued_node_t*) nodes;
+    queue->positions = (size_t*) positions;
+    queue->size = size;
+    queue->length = 0;
+    queue->capacity = initial_capacity;
+    queue->order = 0;
+    queue->merges = 0;
+    queue->peak_length = 0;
+
+    return 0;
+}
+
+// Define free_queue (node_queue.h).
+void free_queue(struct node_queue_t* queue)
+{
+    // Assert that the pointer to the node queue variable is valid.
+    assert(queue != NULL);
+
+    free(queue->nodes);
+    free(queue->positions);
+
+    queue->nodes = NULL;
+    queue->positions = NULL;
+    queue->length = 0;
+    queue->capacity = 0;
+}
+
+// Define push_node (node_queue.h).
+int push_node(struct node_queue_t* queue, struct node_t* node, size_t cost)
+{
+    // Assert that the pointer to the node queue variable is valid.
+    assert(queue != NULL);
+    // Assert that the pointer to the node variable is valid.
+    assert(node != NULL);
+
+    size_t index = location_index(queue->size, node->location);
+
+    // If the location is already queued, merge the nodes by keeping the
+    // cheaper of the two.
+    if (queue->positions[index] != 0)
+    {
+        size_t position = queue->positions[index] - 1;
+        struct queued_node_t* queued = &queue->nodes[position];
+
+        queue->merges++;
+        if (cost >= queued->cost) return 0;
+
+        queued->node = *node;
+        queued->cost = cost;
+        sift_up(queue, position);
+
+        return 0;
+    }
+
+    // If the capacity has been reached, resize the heap.
+    if (queue->length >= queue->capacity)
+    {
+        // Resize according to 2 * previous capacity.
+        size_t new_capacity = (queue->capacity == 0) ? 1 : queue->capacity * 2;
+        void* ptr = realloc((void*) queue->nodes, new_capacity * sizeof(struct queued_node_t));
+
+        // Indicate failure if resize failed.
+        if (ptr == NULL) return -1;
+
+        queue->nodes = (struct queued_node_t*) ptr;
+        queue->capacity = new_capacity;
+    }
+
+    // Add the node to the bottom of the heap, then move it up into place.
+    struct queued_node_t queued = { *node, cost, queue->order++ };
+    place_node(queue, queued, queue->length++);
+    sift_up(queue, queue->length - 1);
+
+    if (queue->length > queue->peak_length) queue->peak_length = queue->length;
+
+    return 0;
+}
+
+// Define pop_node (node_queue.h).
+size_t pop_node(struct node_queue_t* queue, struct node_t* node)
+{
+    // Assert that the pointer to the node queue variable is valid.
+    assert(queue != NULL);
+    // Assert that the pointer to the node variable is valid.
+    assert(node != NULL);
+    // Assert that the queue is not empty.
+    assert(queue->length > 0);
+
+    struct queued_node_t top = queue->nodes[0];
+
+    // The location of the popped node is no longer queued.
+    queue->positions[location_index(queue->size, top.node.location)] = 0;
+
+    // Move the bottom of the heap to the top, then move it down into place.
+    queue->length--;
+    if (queue->length > 0)
+    {
+        place_node(queue, queue->nodes[queue->length], 0);
+        sift_down(queue, 0);
+    }
+
+    *node = top.node;
+
+    return top.cost;
+}
+
+// Define remove_queued_node (node_queue.h).
+bool remove_queued_node(struct node_queue_t* queue, struct location_t location)
+{
+    // Assert that the pointer to the node queue variable is valid.
+    assert(queue != NULL);
+
+    size_t index = location_index(queue->size, location);
+    if (queue->positions[index] == 0) return false;
+
+    size_t position = queue->positions[index] - 1;
+    queue->positions[index] = 0;
+
+    // Move the bottom of the heap into the gap, then move it up into place, or
+    // down if it did not move up, as it may belong on either side of the gap.
+    queue->length--;
+    if (position < queue->length)
+    {
+        struct queued_node_t moved = queue->nodes[queue->length];
+        place_node(queue, moved, position);
+        sift_up(queue, position);
+
+        if (queue->positions[location_index(queue->size, moved.node.location)] - 1 == position) sift_down(queue, position);
+    }
+
+    return true;
+}
+
+// Define queued_node (node_queue.h).
+bool queued_node(struct node_queue_t* queue, struct location_t location)
+{
+    // Assert that the pointer to the node queue variable is valid.
+    assert(queue != NULL);
+
+    return queue->positions[location_index(queue->size, location)] != 0;
+}
+
+// Define precedes (node_queue.c).
+static bool precedes(struct queued_node_t* a, struct queued_node_t* b)
+{
+    if (a->cost != b->cost) return a->cost < b->cost;
+
+    return a->order < b->order;
+}
+
+// Define place_node (node_queue.c).
+static void place_node(struct node_queue_t* queue, struct queued_node_t queued, size_t position)
+{
+    queue->nodes[position] = queued;
+    queue->positions[location_index(queue->size, queued.node.location)] = position + 1;
+}
+
+// Define sift_up (node_queue.c).
+static void sift_up(struct node_queue_t* queue, size_t position)
+{
+    struct queued_node_t queued = queue->nodes[position];
+
+    // Move parents down until the position of the queued node is found.
+    while (position > 0)
+    {
+        size_t parent = (position - 1) / 2;
+        if (!precedes(&queued, &queue->nodes[parent])) break;
+
+        place_node(queue, queue->nodes[parent], position);
+        position = parent;
+    }
+
+    place_node(queue, queued, position);
+}
+
+// Define sift_down (node_queue.c).
+static void sift_down(struct node_queue_t* queue, size_t position)
+{
+    struct queued_node_t queued = queue->nodes[position];
+    size_t length = queue->length;
+
+    // Move children up until the position of the queued node is found.
+    for (;;)
+    {
+        size_t child = 2 * position + 1;
+        if (child >= length) break;
+
+        // Choose the child that should be popped first.
+        if (child + 1 < length && precedes(&queue->nodes[child + 1], &queue->nodes[child]))
+        {
+            child++;
+        }
+
+        if (!precedes(&queue->nodes[child], &queued)) break;
+
+        place_node(queue, queue->nodes[child], position);
+        position = child;
+    }
+
+    place_node(queue, queued, position);
+}
@@ -0,0 +1,366 @@
+#include "parallel_search.h"
+
+#include "action.h"
+#include "location.h"
+#include "maze.h"
+#include "node_list.h"
+#include "stats.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+struct parallel_search_t;
+
+/**
+ * \internal
+ *
+ * Represents one of the threads taking part in a parallel search.
+ *
+ * This struct contains the buffer of locations claimed by the thread during the
+ * current level, which become part of the frontier of the next level.
+ */
+struct search_worker_t
+{
+    struct parallel_search_t* search;
+    pthread_t thread;
+    size_t id;
+    size_t* claimed;
+    size_t length;
+    size_t capacity;
+    bool failed;
+};
+
+/**
+ * \internal
+ *
+ * Represents the state shared by every thread taking part in a parallel search.
+ *
+ * This struct contains the visited bitmap, which is updated atomically, along
+ * with the per-location actions leading back towards the end of the maze,
+ * which are written only by the thread that claimed the location. The frontier
+ * of the current level is read by every thread, but only replaced by the first
+ * thread while the others are waiting at the barrier, which also counts the
+ * locations expanded and claimed so far and the largest frontier.
+ */
+struct parallel_search_t
+{
+    struct maze_t maze;
+    _Atomic(uint64_t)* visited;
+    unsigned char* actions;
+    size_t* frontier;
+    size_t frontier_length;
+    size_t expansions;
+    size_t pushes;
+    size_t frontier_peak;
+    struct search_worker_t* workers;
+    size_t threads;
+    pthread_mutex_t mutex;
+    pthread_cond_t ready_cond;
+    bool ready;
+    bool running;
+    pthread_barrier_t barrier;
+    bool done;
+};
+
+/**
+ * \internal
+ *
+ * Runs the levels of a parallel search on a single thread.
+ *
+ * This helper function waits until every thread has been started, then
+ * repeatedly waits for every thread to begin the next level, expands its share
+ * of the frontier, then waits for every thread to finish the level. The first
+ * thread then gathers the claimed locations into the next frontier and decides
+ * whether the search is complete.
+ *
+ * \param [in,out] arg
+ *     A pointer to the search worker variable for the thread.
+ *
+ * \returns
+ *     NULL.
+ */
+static void* run_worker(void* arg);
+
+/**
+ * \internal
+ *
+ * Expands a share of the frontier of the current level of a parallel search.
+ *
+ * \param [in,out] worker
+ *     A pointer to the search worker which is expanding its share.
+ */
+static void expand_share(struct search_worker_t* worker);
+
+/**
+ * \internal
+ *
+ * Gathers the locations claimed by every thread into the next frontier of a
+ * parallel search, and determines whether the search is complete.
+ *
+ * \param [in,out] search
+ *     A pointer to the parallel search.
+ */
+static void gather_frontier(struct parallel_search_t* search);
+
+// Define solve_maze_parallel (parallel_search.h).
+int solve_maze_parallel(struct node_list_t* list, struct maze_t maze, size_t threads)
+{
+    return solve_maze_parallel_measured(list, maze, threads, NULL);
+}
+
+// Define solve_maze_parallel_measured (parallel_search.h).
+int solve_maze_parallel_measured(struct node_list_t* list, struct maze_t maze, size_t threads, struct search_stats_t* stats)
+{
+    // Assert that the pointer to the node list variable is valid.
+    assert(list != NULL);
+    // Assert that there is at least one thread.
+    assert(threads > 0);
+
+    size_t length = maze.size.rows * maze.size.columns;
+    size_t words = (length + 63) / 64;
+
+    struct parallel_search_t search;
+    search.maze = maze;
+    search.frontier_length = 0;
+    search.expansions = 0;
+    search.pushes = 0;
+    search.frontier_peak = 0;
+    search.threads = threads;
+    search.ready = false;
+    search.running = false;
+    search.done = false;
+
+    // Allocate the shared state. Each location enters the frontier at most
+    // once, so the frontier can never hold more locations than the maze.
+    search.visited = (_Atomic(uint64_t)*) calloc(words, sizeof(_Atomic(uint64_t)));
+    search.actions = (unsigned char*) malloc(length * sizeof(unsigned char));
+    search.frontier = (size_t*) malloc(length * sizeof(size_t));
+    search.workers = (struct search_worker_t*) calloc(threads, sizeof(struct search_worker_t));
+
+    int result = -1;
+
+    // Create the mutex and the condition variable, destroying the mutex again
+    // if the condition variable cannot be created.
+    bool synchronized = search.visited != NULL && search.actions != NULL && search.frontier != NULL
+                     && search.workers != NULL && pthread_mutex_init(&search.mutex, NULL) == 0;
+
+    if (synchronized && pthread_cond_init(&search.ready_cond, NULL) != 0)
+    {
+        pthread_mutex_destroy(&search.mutex);
+        synchronized = false;
+    }
+
+    if (synchronized)
+    {
+        // Begin the search at the end of the maze, as this implementation works
+        // backwards.
+        size_t end_index = location_index(maze.size, maze.end);
+        atomic_store(&search.visited[end_index / 64], (uint64_t) 1 << (end_index % 64));
+        search.frontier[search.frontier_length++] = end_index;
+        search.pushes = 1;
+        search.frontier_peak = 1;
+        search.done = location_equal(maze.start, maze.end);
+
+        for (size_t id = 0; id < threads; id++)
+        {
+            search.workers[id].search = &search;
+            search.workers[id].id = id;
+        }
+
+        // Start every thread but the first, which is the calling thread.
+        size_t started = 1;
+        for (; started < threads; started++)
+        {
+            struct search_worker_t* worker = &search.workers[started];
+            if (pthread_create(&worker->thread, NULL, run_worker, (void*) worker) != 0) break;
+        }
+
+        // If a thread could not be started, search with the threads that were,
+        // which is only known once every thread has been started.
+        search.threads = started;
+        search.running = pthread_barrier_init(&search.barrier, NULL, (unsigned int) started) == 0;
+
+        // Let the started threads begin the search.
+        pthread_mutex_lock(&search.mutex);
+        search.ready = true;
+        pthread_cond_broadcast(&search.ready_cond);
+        pthread_mutex_unlock(&search.mutex);
+
+        run_worker((void*) &search.workers[0]);
+
+        for (size_t id = 1; id < started; id++)
+        {
+            pthread_join(search.workers[id].thread, NULL);
+        }
+
+        if (search.running) pthread_barrier_destroy(&search.barrier);
+        pthread_cond_destroy(&search.ready_cond);
+        pthread_mutex_destroy(&search.mutex);
+
+        // Record the work done, where every location in the frontier of a
+        // finished level was expanded.
+        if (stats != NULL)
+        {
+            stats->recorded = true;
+            stats->expansions = search.expansions;
+            stats->pushes = search.pushes;
+            stats->duplicate_pushes = 0;
+            stats->frontier_peak = search.frontier_peak;
+        }
+
+        // If the start of the maze was reached, follow the actions to build the
+        // path.
+        size_t start_index = location_index(maze.size, maze.start);
+        if ((atomic_load(&search.visited[start_index / 64]) >> (start_index % 64)) & 1)
+        {
+            result = append_path(list, maze, search.actions);
+        }
+    }
+
+    if (search.workers != NULL)
+    {
+        for (size_t id = 0; id < threads; id++) free(search.workers[id].claimed);
+    }
+
+    free(search.workers);
+    free(search.frontier);
+    free(search.actions);
+    free((void*) search.visited);
+
+    return result;
+}
+
+// Define run_worker (parallel_search.c).
+static void* run_worker(void* arg)
+{
+    struct search_worker_t* worker = (struct search_worker_t*) arg;
+    struct parallel_search_t* search = worker->search;
+
+    // Wait until every thread has been started.
+    pthread_mutex_lock(&search->mutex);
+    while (!search->ready) pthread_cond_wait(&search->ready_cond, &search->mutex);
+    pthread_mutex_unlock(&search->mutex);
+
+    // If the barrier could not be created, the threads cannot search together.
+    if (!search->running) return NULL;
+
+    for (;;)
+    {
+        // Wait for every thread to begin the level.
+        pthread_barrier_wait(&search->barrier);
+        if (search->done) break;
+
+        expand_share(worker);
+
+        // Wait for every thread to finish the level, then let the first thread
+        // prepare the next one while the others wait to begin it.
+        pthread_barrier_wait(&search->barrier);
+        if (worker->id == 0) gather_frontier(search);
+    }
+
+    return NULL;
+}
+
+// Define expand_share (parallel_search.c).
+static void expand_share(struct search_worker_t* worker)
+{
+    struct parallel_search_t* search = worker->search;
+    struct maze_t maze = search->maze;
+
+    // Find this thread's share of the frontier.
+    size_t first = search->frontier_length * worker->id / search->threads;
+    size_t last = search->frontier_length * (worker->id + 1) / search->threads;
+
+    worker->length = 0;
+
+    for (size_t position = first; position < last; position++)
+    {
+        size_t index = search->frontier[position];
+        struct location_t location = { index / maze.size.columns, index % maze.size.columns };
+
+        // Get the set of actions available for the location.
+        enum action_set_t action_set = get_action_set(maze, location);
+
+        for (enum action_t action = EAST; action <= NORTH; action++)
+        {
+            // Check if the action is contained in the set of actions.
+            if (!(action_set & (1 << action))) continue;
+
+            size_t child_index = location_index(maze.size, action_result(location, action));
+
+            // Attempt to claim the location, skipping it if any thread has
+            // already done so.
+            uint64_t bit = (uint64_t) 1 << (child_index % 64);
+            uint64_t previous = atomic_fetch_or_explicit(&search->visited[child_index / 64], bit,
+                                                         memory_order_relaxed);
+            if (previous & bit) continue;
+
+            // Record the way back towards the end of the maze.
+            search->actions[child_index] = (unsigned char) reverse_action(action);
+
+            // If the capacity has been reached, resize the buffer of claimed
+            // locations.
+            if (worker->length >= worker->capacity)
+            {
+                size_t new_capacity = (worker->capacity == 0) ? 64 : worker->capacity * 2;
+                void* ptr = realloc((void*) worker->claimed, new_capacity * sizeof(size_t));
+
+                // On failure, the location stays claimed without being
+                // expanded, so the search as a whole is marked as failed.
+                if (ptr == NULL)
+                {
+                    worker->failed = true;
+                    continue;
+                }
+
+                worker->claimed = (size_t*) ptr;
+                worker->capacity = new_capacity;
+            }
+
+            worker->claimed[worker->length++] = child_index;
+        }
+    }
+}
+
+// Define gather_frontier (parallel_search.c).
+static void gather_frontier(struct parallel_search_t* search)
+{
+    struct maze_t maze = search->maze;
+
+    // Every location in the frontier of the level just finished was expanded.
+    search->expansions += search->frontier_length;
+
+    // Copy the locations claimed by each thread into the next frontier.
+    search->frontier_length = 0;
+    bool failed = false;
+
+    for (size_t id = 0; id < search->threads; id++)
+    {
+        struct search_worker_t* worker = &search->workers[id];
+
+        // A worker which has never claimed a location has no array to copy.
+        if (worker->length > 0)
+        {
+            memcpy(search->frontier + search->frontier_length, worker->claimed, worker->length * sizeof(size_t));
+            search->frontier_length += worker->length;
+        }
+        failed = failed || worker->failed;
+    }
+
+    search->pushes += search->frontier_length;
+    if (search->frontier_length > search->frontier_peak) search->frontier_peak = search->frontier_length;
+
+    // The search is complete once the start has been reached, or there is
+    // nothing left to expand.
+    size_t start_index = location_index(maze.size, maze.start);
+    bool found = (atomic_load_explicit(&search->visited[start_index / 64], memory_order_relaxed)
+                  >> (start_index % 64)) & 1;
+
+    search->done = found || failed || search->frontier_length == 0;
+}
@@ -0,0 +1,64 @@
+#include "path.h"
+
+#include "action.h"
+#include "node.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+
+// Define make_path (path.h).
+int make_path(struct path_t* path, struct node_t* start)
+{
+    // Assert that the pointer to the path variable is valid.
+    assert(path != NULL);
+    // Assert that the pointer to the node variable is valid.
+    assert(start != NULL);
+
+    // Count the steps along the path.
+    size_t length = 0;
+    for (struct node_t* node = start; node->parent != NULL; node = node->parent)
+    {
+        length++;
+    }
+
+    // Allocate the memory required for the actions, with at least one byte so
+    // that an empty path is not mistaken for a failed allocation.
+    void* ptr = malloc(length > 0 ? length : 1);
+
+    // Indicate failure if allocation failed.
+    if (ptr == NULL) return -1;
+
+    unsigned char* actions = (unsigned char*) ptr;
+
+    // Find the action taken at each step.
+    size_t step = 0;
+    for (struct node_t* node = start; node->parent != NULL; node = node->parent)
+    {
+        enum action_t action;
+        if (action_taken(&action, node->location, node->parent->location) != 0)
+        {
+            free(ptr);
+            return -1;
+        }
+
+        actions[step++] = (unsigned char) action;
+    }
+
+    // Initialize path properties.
+    path->actions = actions;
+    path->length = length;
+
+    return 0;
+}
+
+// Define free_path (path.h).
+void free_path(struct path_t* path)
+{
+    // Assert that the pointer to the path variable is valid.
+    assert(path != NULL);
+
+    free(path->actions);
+    path->actions = NULL;
+    path->length = 0;
+}
@@ -0,0 +1,563 @@
+#include "pipeline.h"
+
+#include "location.h"
+#include "node.h"
+#include "node_list.h"
+#include "maze.h"
+#include "compact_search.h"
+#include "bounded_queue.h"
+#include "batch.h"
+#include "io.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+
+/**
+ * \internal
+ *
+ * The number of times a thread retries a queue of a pipeline, yielding between
+ * attempts, before it sleeps until the queue changes.
+ */
+#define PIPELINE_SPINS 64
+
+/**
+ * \internal
+ *
+ * Represents a queue between two stages of a pipeline.
+ *
+ * This struct contains the bounded queue itself, which is used without the
+ * lock, along with a lock and condition used by threads which find the queue
+ * full or empty for too long to sleep until it changes, and the number of
+ * threads sleeping, so that the queue is only signalled when a thread is
+ * waiting for it.
+ */
+struct pipeline_queue_t
+{
+    struct bounded_queue_t queue;
+    pthread_mutex_t mutex;
+    pthread_cond_t changed_cond;
+    atomic_size_t sleepers;
+};
+
+/**
+ * \internal
+ *
+ * Represents a maze passing through a pipeline.
+ *
+ * This struct contains the job the maze belongs to, along with the maze once
+ * it has been read and the path through it once it has been solved.
+ */
+struct pipeline_item_t
+{
+    struct batch_job_t* job;
+    struct maze_t maze;
+    struct path_t path;
+};
+
+/**
+ * \internal
+ *
+ * Represents the state shared by every thread of a pipeline.
+ *
+ * This struct contains the queue of mazes waiting to be solved and the queue of
+ * paths waiting to be written, along with the index of the next job to read and
+ * the number of threads still running in each of the first two stages, so that
+ * the threads of the next stage know when no more items will arrive.
+ */
+struct pipeline_t
+{
+    struct batch_t* batch;
+    struct pipeline_item_t* items;
+    enum path_encoding_t encoding;
+    FILE* status;
+    struct pipeline_queue_t parsed;
+    struct pipeline_queue_t solved;
+    atomic_size_t next_job;
+    atomic_size_t parsers_running;
+    atomic_size_t solvers_running;
+    atomic_bool aborted;
+};
+
+/**
+ * \internal
+ *
+ * Creates a queue between two stages of a pipeline.
+ *
+ * \param [out] queue
+ *     A pointer to the queue variable that will be initialized.
+ * \param [in]  depth
+ *     The number of items the queue can hold, which must be a power of two and
+ *     at least 2.
+ *
+ * \returns
+ *     -1 on failure, 0 on success.
+ */
+static int make_pipeline_queue(struct pipeline_queue_t* queue, size_t depth);
+
+/**
+ * \internal
+ *
+ * Releases the memory held by a queue between two stages of a pipeline.
+ *
+ * \param [in,out] queue
+ *     A pointer to the queue to free.
+ */
+static void free_pipeline_queue(struct pipeline_queue_t* queue);
+
+/**
+ * \internal
+ *
+ * Wakes every thread sleeping on a queue of a pipeline, after an item has been
+ * added to or removed from it, or after it has been closed by the last of the
+ * threads which add to it finishing or the pipeline being aborted.
+ *
+ * \param [in,out] queue
+ *     A pointer to the queue.
+ */
+static void wake_pipeline_queue(struct pipeline_queue_t* queue);
+
+/**
+ * \internal
+ *
+ * Adds an item to a queue of a pipeline, waiting while the queue is full.
+ *
+ * The queue is retried a few times before the thread sleeps until an item is
+ * removed from the queue or the pipeline is aborted.
+ *
+ * \param [in,out] pipeline
+ *     A pointer to the pipeline.
+ * \param [in,out] queue
+ *     A pointer to the queue.
+ * \param [in]     item
+ *     A pointer to the item to add.
+ *
+ * \returns
+ *     Whether the item was added, which is only false if the pipeline was
+ *     aborted while waiting.
+ */
+static bool push_item(struct pipeline_t* pipeline, struct pipeline_queue_t* queue, struct pipeline_item_t* item);
+
+/**
+ * \internal
+ *
+ * Removes an item from a queue of a pipeline, waiting while the queue is empty
+ * and any thread which adds to it is still running.
+ *
+ * The queue is retried a few times before the thread sleeps until an item is
+ * added to the queue or the last thread which adds to it finishes.
+ *
+ * \param [in,out] queue
+ *     A pointer to the queue.
+ * \param [in]     producers
+ *     A pointer to the number of threads still running which add to the queue.
+ * \param [out]    item
+ *     A pointer to the variable which will contain the pointer to the item.
+ *
+ * \returns
+ *     Whether an item was removed, which is only false once the queue is empty
+ *     and will stay empty.
+ */
+static bool pop_item(struct pipeline_queue_t* queue, atomic_size_t* producers, struct pipeline_item_t** item);
+
+/**
+ * \internal
+ *
+ * Reads the maze of each job not yet taken by another thread, adding it to the
+ * queue of mazes waiting to be solved.
+ *
+ * \param [in,out] arg
+ *     A pointer to the pipeline.
+ *
+ * \returns
+ *     NULL.
+ */
+static void* run_parser(void* arg);
+
+/**
+ * \internal
+ *
+ * Solves each maze taken from the queue of mazes waiting to be solved, adding
+ * its path to the queue of paths waiting to be written.
+ *
+ * \param [in,out] arg
+ *     A pointer to the pipeline.
+ *
+ * \returns
+ *     NULL.
+ */
+static void* run_solver(void* arg);
+
+/**
+ * \internal
+ *
+ * Writes each path taken from the queue of paths waiting to be written.
+ *
+ * \param [in,out] arg
+ *     A pointer to the pipeline.
+ *
+ * \returns
+ *     NULL.
+ */
+static void* run_writer(void* arg);
+
+// Define run_pipeline (pipeline.h).
+int run_pipeline(struct batch_t* batch, struct pipeline_widths_t widths, enum path_encoding_t encoding, FILE* status)
+{
+    // Assert that the pointer to the batch variable is valid.
+    assert(batch != NULL);
+    // Assert that every stage has at least one thread.
+    assert(widths.parsers > 0 && widths.solvers > 0 && widths.writers > 0);
+
+    struct pipeline_t pipeline;
+    pipeline.batch = batch;
+    pipeline.encoding = encoding;
+    pipeline.status = status;
+    atomic_init(&pipeline.next_job, 0);
+    atomic_init(&pipeline.parsers_running, widths.parsers);
+    atomic_init(&pipeline.solvers_running, widths.solvers);
+    atomic_init(&pipeline.aborted, false);
+
+    size_t threads = widths.parsers + widths.solvers + widths.writers;
+
+    pipeline.items = (struct pipeline_item_t*) calloc((batch->length > 0) ? batch->length : 1, sizeof(struct pipeline_item_t));
+    pthread_t* handles = (pthread_t*) malloc(threads * sizeof(pthread_t));
+
+    if (pipeline.items == NULL || handles == NULL)
+    {
+        free(handles);
+        free(pipeline.items);
+        return -1;
+    }
+
+    if (make_pipeline_queue(&pipeline.parsed, widths.depth) != 0)
+    {
+        free(handles);
+        free(pipeline.items);
+        return -1;
+    }
+
+    if (make_pipeline_queue(&pipeline.solved, widths.depth) != 0)
+    {
+        free_pipeline_queue(&pipeline.parsed);
+        free(handles);
+        free(pipeline.items);
+        return -1;
+    }
+
+    // Start the threads of each stage, beginning with the last. If a thread
+    // could not be started, its stage could stall, so the pipeline is aborted
+    // and the threads already started are left to finish.
+    size_t started = 0;
+    size_t started_solvers = 0;
+    size_t started_parsers = 0;
+
+    for (; started < threads; started++)
+    {
+        void* (*run)(void*) = (started < widths.writers) ? run_writer
+                            : (started < widths.writers + widths.solvers) ? run_solver
+                                                                          : run_parser;
+
+        if (pthread_create(&handles[started], NULL, run, (void*) &pipeline) != 0) break;
+
+        if (run == run_solver) started_solvers++;
+        if (run == run_parser) started_parsers++;
+    }
+
+    if (started < threads)
+    {
+        atomic_store(&pipeline.aborted, true);
+
+        // Count the threads which were never started as finished.
+        atomic_fetch_sub(&pipeline.solvers_running, widths.solvers - started_solvers);
+        atomic_fetch_sub(&pipeline.parsers_running, widths.parsers - started_parsers);
+
+        // Wake the threads waiting on either queue to see the abort.
+        wake_pipeline_queue(&pipeline.parsed);
+        wake_pipeline_queue(&pipeline.solved);
+    }
+
+    for (size_t index = 0; index < started; index++)
+    {
+        pthread_join(handles[index], NULL);
+    }
+
+    // Release anything left in the queues by an aborted pipeline.
+    void* value = NULL;
+    while (try_pop_value(&pipeline.parsed.queue, &value)) free_maze(&((struct pipeline_item_t*) value)->maze);
+    while (try_pop_value(&pipeline.solved.queue, &value)) free_path(&((struct pipeline_item_t*) value)->path);
+
+    // Indicate failure if any job failed.
+    int result = (started < threads) ? -1 : 0;
+    for (size_t index = 0; index < batch->length; index++)
+    {
+        if (batch->jobs[index].result != 0) result = -1;
+    }
+
+    free_pipeline_queue(&pipeline.solved);
+    free_pipeline_queue(&pipeline.parsed);
+    free(handles);
+    free(pipeline.items);
+
+    return result;
+}
+
+// Define make_pipeline_queue (pipeline.c).
+static int make_pipeline_queue(struct pipeline_queue_t* queue, size_t depth)
+{
+    if (make_bounded_queue(&queue->queue, depth) != 0) return -1;
+
+    if (pthread_mutex_init(&queue->mutex, NULL) != 0)
+    {
+        free_bounded_queue(&queue->queue);
+        return -1;
+    }
+
+    if (pthread_cond_init(&queue->changed_cond, NULL) != 0)
+    {
+        pthread_mutex_destroy(&queue->mutex);
+        free_bounded_queue(&queue->queue);
+        return -1;
+    }
+
+    atomic_init(&queue->sleepers, 0);
+
+    return 0;
+}
+
+// Define free_pipeline_queue (pipeline.c).
+static void free_pipeline_queue(struct pipeline_queue_t* queue)
+{
+    pthread_cond_destroy(&queue->changed_cond);
+    pthread_mutex_destroy(&queue->mutex);
+    free_bounded_queue(&queue->queue);
+}
+
+// Define wake_pipeline_queue (pipeline.c).
+static void wake_pipeline_queue(struct pipeline_queue_t* queue)
+{
+    // Order the change to the queue before the check for sleepers, pairing with
+    // the fence in a thread going to sleep, so that either the sleeping thread
+    // sees the change or this thread sees it sleeping.
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load(&queue->sleepers) == 0) return;
+
+    // Broadcast under the lock, so that a thread which has checked the queue
+    // but not yet slept cannot miss the change.
+    pthread_mutex_lock(&queue->mutex);
+    pthread_cond_broadcast(&queue->changed_cond);
+    pthread_mutex_unlock(&queue->mutex);
+}
+
+// Define push_item (pipeline.c).
+static bool push_item(struct pipeline_t* pipeline, struct pipeline_queue_t* queue, struct pipeline_item_t* item)
+{
+    bool pushed = false;
+
+    for (size_t spin = 0; spin < PIPELINE_SPINS; spin++)
+    {
+        pushed = try_push_value(&queue->queue, (void*) item);
+        if (pushed || atomic_load(&pipeline->aborted)) break;
+
+        // Let the threads of the next stage drain the queue.
+        sched_yield();
+    }
+
+    if (!pushed && !atomic_load(&pipeline->aborted))
+    {
+        // Sleep until the threads of the next stage drain the queue.
+        pthread_mutex_lock(&queue->mutex);
+        atomic_fetch_add(&queue->sleepers, 1);
+        atomic_thread_fence(memory_order_seq_cst);
+
+        while (!(pushed = try_push_value(&queue->queue, (void*) item)) && !atomic_load(&pipeline->aborted))
+        {
+            pthread_cond_wait(&queue->changed_cond, &queue->mutex);
+        }
+
+        atomic_fetch_sub(&queue->sleepers, 1);
+        pthread_mutex_unlock(&queue->mutex);
+    }
+
+    // Wake any thread of the next stage waiting for the item.
+    if (pushed) wake_pipeline_queue(queue);
+
+    return pushed;
+}
+
+// Define pop_item (pipeline.c).
+static bool pop_item(struct pipeline_queue_t* queue, atomic_size_t* producers, struct pipeline_item_t** item)
+{
+    void* value = NULL;
+    bool popped = false;
+    bool finished = false;
+
+    for (size_t spin = 0; spin < PIPELINE_SPINS; spin++)
+    {
+        // Once every producer has finished, anything they added is visible, so
+        // if the queue is still empty it will stay empty.
+        finished = atomic_load(producers) == 0;
+
+        popped = try_pop_value(&queue->queue, &value);
+        if (popped || finished) break;
+
+        // Let the threads of the previous stage fill the queue.
+        sched_yield();
+    }
+
+    if (!popped && !finished)
+    {
+        // Sleep until the threads of the previous stage fill the queue, or the
+        // last of them finishes.
+        pthread_mutex_lock(&queue->mutex);
+        atomic_fetch_add(&queue->sleepers, 1);
+        atomic_thread_fence(memory_order_seq_cst);
+
+        for (;;)
+        {
+            finished = atomic_load(producers) == 0;
+
+            popped = try_pop_value(&queue->queue, &value);
+            if (popped || finished) break;
+
+            pthread_cond_wait(&queue->changed_cond, &queue->mutex);
+        }
+
+        atomic_fetch_sub(&queue->sleepers, 1);
+        pthread_mutex_unlock(&queue->mutex);
+    }
+
+    if (!popped) return false;
+
+    // Wake any thread of the previous stage waiting for space in the queue.
+    wake_pipeline_queue(queue);
+
+    *item = (struct pipeline_item_t*) value;
+    return true;
+}
+
+// Define run_parser (pipeline.c).
+static void* run_parser(void* arg)
+{
+    struct pipeline_t* pipeline = (struct pipeline_t*) arg;
+    struct batch_t* batch = pipeline->batch;
+
+    while (!atomic_load(&pipeline->aborted))
+    {
+        // Take the next job.
+        size_t index = atomic_fetch_add(&pipeline->next_job, 1);
+        if (index >= batch->length) break;
+
+        struct pipeline_item_t* item = &pipeline->items[index];
+        item->job = &batch->jobs[index];
+
+        if (read_maze_file(&item->maze, item->job->input) != 0)
+        {
+            if (pipeline->status != NULL) fprintf(pipeline->status, "%s: failed to read maze\n", item->job->input);
+            continue;
+        }
+
+        if (!push_item(pipeline, &pipeline->parsed, item)) free_maze(&item->maze);
+    }
+
+    // Wake the solvers if this was the last parser, so that they can see that
+    // no more mazes will arrive.
+    atomic_fetch_sub(&pipeline->parsers_running, 1);
+    wake_pipeline_queue(&pipeline->parsed);
+
+    return NULL;
+}
+
+// Define run_solver (pipeline.c).
+static void* run_solver(void* arg)
+{
+    struct pipeline_t* pipeline = (struct pipeline_t*) arg;
+
+    // Create the buffers reused for every maze, which grow as bigger mazes are
+    // solved. If they cannot be created, the mazes are still taken from the
+    // queue, so that the parsers are not held back, but fail.
+    struct node_list_t list;
+    struct compact_search_t search;
+
+    bool prepared = make_list(&list, 0) == 0;
+    if (prepared && make_compact_search(&search, (struct maze_size_t) { 1, 1 }) != 0)
+    {
+        resize_list(&list, 0);
+        prepared = false;
+    }
+
+    struct pipeline_item_t* item = NULL;
+    while (pop_item(&pipeline->parsed, &pipeline->parsers_running, &item))
+    {
+        int result = -1;
+
+        if (prepared)
+        {
+            // Reuse the nodes of the list from the previous maze.
+            list.length = 0;
+
+            result = solve_maze_compact_buffered(&list, item->maze, &search);
+            if (result == 0) result = make_path(&item->path, get_node(&list, list.length - 1));
+        }
+
+        free_maze(&item->maze);
+
+        if (result != 0)
+        {
+            if (pipeline->status != NULL) fprintf(pipeline->status, "%s: failed to solve maze\n", item->job->input);
+            continue;
+        }
+
+        if (!push_item(pipeline, &pipeline->solved, item)) free_path(&item->path);
+    }
+
+    if (prepared)
+    {
+        free_compact_search(&search);
+        resize_list(&list, 0);
+    }
+
+    // Wake the writers if this was the last solver, so that they can see that
+    // no more paths will arrive.
+    atomic_fetch_sub(&pipeline->solvers_running, 1);
+    wake_pipeline_queue(&pipeline->solved);
+
+    return NULL;
+}
+
+// Define run_writer (pipeline.c).
+static void* run_writer(void* arg)
+{
+    struct pipeline_t* pipeline = (struct pipeline_t*) arg;
+
+    struct pipeline_item_t* item = NULL;
+    while (pop_item(&pipeline->solved, &pipeline->solvers_running, &item))
+    {
+        struct batch_job_t* job = item->job;
+
+        int result = -1;
+
+        FILE* fp = fopen(job->output, "wb");
+        if (fp != NULL)
+        {
+            result = write_encoded_path(item->path, pipeline->encoding, fp);
+            if (fclose(fp) != 0) result = -1;
+        }
+
+        if (pipeline->status != NULL)
+        {
+            if (result == 0) fprintf(pipeline->status, "%s: solved in %zu actions\n", job->input, item->path.length);
+            else fprintf(pipeline->status, "%s: failed to write %s\n", job->input, job->output);
+        }
+
+        free_path(&item->path);
+
+        job->result = result;
+    }
+
+    return NULL;
+}
@@ -0,0 +1,351 @@
+#include "search_engine.h"
+
+#include "node_list.h"
+#include "stats.h"
+#include "parallel_search.h"
+#include "bitboard.h"
+#include "compact_search.h"
+#include "corridor_graph.h"
+#include "dead_end.h"
+#include "hierarchical_search.h"
+#include "incremental_search.h"
+
+#include <assert.h>
+#include <string.h>
+
+
+/**
+ * \internal
+ *
+ * The number of threads used by the searches which share their work between
+ * threads, set by set_search_threads().
+ */
+static size_t search_threads = 1;
+
+/**
+ * \internal
+ *
+ * Solves a given maze using parallel breadth-first search with the number of
+ * threads set by set_search_threads().
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ */
+static void solve_maze_threaded(struct node_list_t* list, struct maze_t maze);
+
+/**
+ * \internal
+ *
+ * Solves a given maze using parallel breadth-first search with the number of
+ * threads set by set_search_threads(), recording the work done.
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ * \param [out] stats
+ *     A pointer to the statistics variable which will record the work done.
+ */
+static void measure_maze_threaded(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats);
+
+/**
+ * \internal
+ *
+ * Solves a given maze using bit-parallel breadth-first search.
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ */
+static void solve_maze_bitplanes(struct node_list_t* list, struct maze_t maze);
+
+/**
+ * \internal
+ *
+ * Solves a given maze using bit-parallel breadth-first search, recording the
+ * work done.
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ * \param [out] stats
+ *     A pointer to the statistics variable which will record the work done.
+ */
+static void measure_maze_bitplanes(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats);
+
+/**
+ * \internal
+ *
+ * Solves a given maze using breadth-first search with a compact search state.
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ */
+static void solve_maze_compactly(struct node_list_t* list, struct maze_t maze);
+
+/**
+ * \internal
+ *
+ * Solves a given maze using breadth-first search with a compact search state,
+ * recording the work done.
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ * \param [out] stats
+ *     A pointer to the statistics variable which will record the work done.
+ */
+static void measure_maze_compactly(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats);
+
+/**
+ * \internal
+ *
+ * Solves a given maze using A* search over its corridor graph.
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ */
+static void solve_maze_contracted(struct node_list_t* list, struct maze_t maze);
+
+/**
+ * \internal
+ *
+ * Solves a given maze using A* search over its corridor graph, recording the
+ * work done.
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ * \param [out] stats
+ *     A pointer to the statistics variable which will record the work done.
+ */
+static void measure_maze_contracted(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats);
+
+/**
+ * \internal
+ *
+ * Solves a given maze by filling its dead ends.
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ */
+static void solve_maze_pruned(struct node_list_t* list, struct maze_t maze);
+
+/**
+ * \internal
+ *
+ * Solves a given maze by filling its dead ends, recording the work done.
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ * \param [out] stats
+ *     A pointer to the statistics variable which will record the work done.
+ */
+static void measure_maze_pruned(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats);
+
+/**
+ * \internal
+ *
+ * Solves a given maze using hierarchical A* search, making the cluster graph
+ * with the number of threads set by set_search_threads().
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ */
+static void solve_maze_clustered(struct node_list_t* list, struct maze_t maze);
+
+/**
+ * \internal
+ *
+ * Solves a given maze using hierarchical A* search, recording the work done.
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ * \param [out] stats
+ *     A pointer to the statistics variable which will record the work done.
+ */
+static void measure_maze_clustered(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats);
+
+/**
+ * \internal
+ *
+ * Solves a given maze once using Lifelong Planning A* search.
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ */
+static void solve_maze_lifelong(struct node_list_t* list, struct maze_t maze);
+
+/**
+ * \internal
+ *
+ * Solves a given maze once using Lifelong Planning A* search, recording the
+ * work done.
+ *
+ * \param [out] list
+ *     A pointer to the node list variable that will be used to store the linked
+ *     list of nodes that form the path.
+ * \param [in]  maze
+ *     The maze to solve.
+ * \param [out] stats
+ *     A pointer to the statistics variable which will record the work done.
+ */
+static void measure_maze_lifelong(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats);
+
+// Define search_engines (search_engine.h).
+const struct search_engine_t search_engines[] =
+{
+    { "greedy",        solve_maze,               solve_maze_measured,               false },
+    { "astar",         solve_maze_a_star,        solve_maze_a_star_measured,        false },
+    { "bidirectional", solve_maze_bidirectional, solve_maze_bidirectional_measured, false },
+    { "parallel",      solve_maze_threaded,      measure_maze_threaded,             true  },
+    { "bitboard",      solve_maze_bitplanes,     measure_maze_bitplanes,            false },
+    { "compact",       solve_maze_compactly,     measure_maze_compactly,            false },
+    { "corridor",      solve_maze_contracted,    measure_maze_contracted,           false },
+    { "deadend",       solve_maze_pruned,        measure_maze_pruned,               false },
+    { "hierarchical",  solve_maze_clustered,     measure_maze_clustered,            true  },
+    { "incremental",   solve_maze_lifelong,      measure_maze_lifelong,             false }
+};
+
+// Define search_engine_count (search_engine.h).
+const size_t search_engine_count = sizeof(search_engines) / sizeof(search_engines[0]);
+
+// Define set_search_threads (search_engine.h).
+void set_search_threads(size_t threads)
+{
+    // Assert that the number of threads is valid.
+    assert(threads > 0);
+
+    search_threads = threads;
+}
+
+// Define find_search_engine (search_engine.h).
+const struct search_engine_t* find_search_engine(const char* name)
+{
+    // Assert that the name is valid.
+    assert(name != NULL);
+
+    for (size_t index = 0; index < search_engine_count; index++)
+    {
+        if (strcmp(name, search_engines[index].name) == 0) return &search_engines[index];
+    }
+
+    return NULL;
+}
+
+// Define solve_maze_threaded (search_engine.c).
+static void solve_maze_threaded(struct node_list_t* list, struct maze_t maze)
+{
+    solve_maze_parallel(list, maze, search_threads);
+}
+
+// Define measure_maze_threaded (search_engine.c).
+static void measure_maze_threaded(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats)
+{
+    solve_maze_parallel_measured(list, maze, search_threads, stats);
+}
+
+// Define solve_maze_bitplanes (search_engine.c).
+static void solve_maze_bitplanes(struct node_list_t* list, struct maze_t maze)
+{
+    solve_maze_bitboard(list, maze);
+}
+
+// Define measure_maze_bitplanes (search_engine.c).
+static void measure_maze_bitplanes(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats)
+{
+    solve_maze_bitboard_measured(list, maze, stats);
+}
+
+// Define solve_maze_compactly (search_engine.c).
+static void solve_maze_compactly(struct node_list_t* list, struct maze_t maze)
+{
+    solve_maze_compact(list, maze);
+}
+
+// Define measure_maze_compactly (search_engine.c).
+static void measure_maze_compactly(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats)
+{
+    solve_maze_compact_measured(list, maze, stats);
+}
+
+// Define solve_maze_contracted (search_engine.c).
+static void solve_maze_contracted(struct node_list_t* list, struct maze_t maze)
+{
+    solve_maze_corridors(list, maze);
+}
+
+// Define measure_maze_contracted (search_engine.c).
+static void measure_maze_contracted(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats)
+{
+    solve_maze_corridors_measured(list, maze, stats);
+}
+
+// Define solve_maze_pruned (search_engine.c).
+static void solve_maze_pruned(struct node_list_t* list, struct maze_t maze)
+{
+    solve_maze_dead_ends(list, maze);
+}
+
+// Define measure_maze_pruned (search_engine.c).
+static void measure_maze_pruned(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats)
+{
+    solve_maze_dead_ends_measured(list, maze, stats);
+}
+
+// Define solve_maze_clustered (search_engine.c).
+static void solve_maze_clustered(struct node_list_t* list, struct maze_t maze)
+{
+    solve_maze_hierarchical(list, maze, DEFAULT_CLUSTER_SIZE, search_threads, NULL);
+}
+
+// Define measure_maze_clustered (search_engine.c).
+static void measure_maze_clustered(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats)
+{
+    solve_maze_hierarchical(list, maze, DEFAULT_CLUSTER_SIZE, search_threads, stats);
+}
+
+// Define solve_maze_lifelong (search_engine.c).
+static void solve_maze_lifelong(struct node_list_t* list, struct maze_t maze)
+{
+    solve_maze_incremental(list, maze, NULL);
+}
+
+// Define measure_maze_lifelong (search_engine.c).
+static void measure_maze_lifelong(struct node_list_t* list, struct maze_t maze, struct search_stats_t* stats)
+{
+    solve_maze_incremental(list, maze, stats);
+}
@@ -0,0 +1,660 @@
+#include "server.h"
+
+#include "location.h"
+#include "maze_size.h"
+#include "node.h"
+#include "path.h"
+#include "io.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+/**
+ * \internal
+ *
+ * Represents a connection accepted by a solver server.
+ */
+struct connection_t
+{
+    struct maze_cache_t* cache;
+    int fd;
+};
+
+/**
+ * \internal
+ *
+ * Finds the entry for a named maze file in a cache.
+ *
+ * \param [in] cache
+ *     A pointer to the maze cache, whose lock must be held.
+ * \param [in] name
+ *     The name of the maze file.
+ *
+ * \returns
+ *     A pointer to the entry, or NULL if the maze is not cached.
+ */
+static struct maze_entry_t* find_entry(struct maze_cache_t* cache, const char* name);
+
+/**
+ * \internal
+ *
+ * Removes an entry from the list of entries in a cache.
+ *
+ * \param [in,out] cache
+ *     A pointer to the maze cache, whose lock must be held.
+ * \param [in,out] entry
+ *     A pointer to the entry to remove.
+ */
+static void unlink_entry(struct maze_cache_t* cache, struct maze_entry_t* entry);
+
+/**
+ * \internal
+ *
+ * Adds an entry to the front of the list of entries in a cache, as the most
+ * recently used.
+ *
+ * \param [in,out] cache
+ *     A pointer to the maze cache, whose lock must be held.
+ * \param [in,out] entry
+ *     A pointer to the entry to add.
+ */
+static void link_entry(struct maze_cache_t* cache, struct maze_entry_t* entry);
+
+/**
+ * \internal
+ *
+ * Releases the memory held by an entry which is no longer in a cache.
+ *
+ * \param [in,out] entry
+ *     A pointer to the entry to free.
+ */
+static void free_entry(struct maze_entry_t* entry);
+
+/**
+ * \internal
+ *
+ * Evicts the least recently used entries which are not in use from a cache
+ * until it is within its budget, or every entry left is in use.
+ *
+ * \param [in,out] cache
+ *     A pointer to the maze cache, whose lock must be held.
+ */
+static void evict_mazes(struct maze_cache_t* cache);
+
+/**
+ * \internal
+ *
+ * Parses the next value of a request as a number.
+ *
+ * \param [out]    value
+ *     A pointer to the variable which will contain the number.
+ * \param [in,out] saved
+ *     A pointer to the position in the request, as used by strtok_r().
+ *
+ * \returns
+ *     -1 on failure, when there is no value or it is not a number, 0 on
+ *     success.
+ */
+static int parse_value(size_t* value, char** saved);
+
+/**
+ * \internal
+ *
+ * Answers a request to find a path through a cached maze.
+ *
+ * \param [in,out] session
+ *     A pointer to the solver session of the connection.
+ * \param [in]     name
+ *     The name of the maze file.
+ * \param [in,out] saved
+ *     A pointer to the position in the request after the name, as used by
+ *     strtok_r().
+ * \param [in]     fp
+ *     The file handle to write the answer to.
+ *
+ * \returns
+ *     -1 if the request failed, 0 on success.
+ */
+static int answer_solve(struct solver_session_t* session, const char* name, char** saved, FILE* fp);
+
+/**
+ * \internal
+ *
+ * Answers the requests on a connection to a solver server until it is closed.
+ *
+ * \param [in,out] arg
+ *     A pointer to the connection, which is freed once it is closed.
+ *
+ * \returns
+ *     NULL.
+ */
+static void* serve_connection(void* arg);
+
+// Define make_maze_cache (server.h).
+int make_maze_cache(struct maze_cache_t* cache, size_t budget)
+{
+    // Assert that the pointer to the maze cache variable is valid.
+    assert(cache != NULL);
+
+    if (pthread_mutex_init(&cache->mutex, NULL) != 0) return -1;
+
+    // Initialize maze cache properties.
+    cache->newest = NULL;
+    cache->oldest = NULL;
+    cache->bytes = 0;
+    cache->budget = budget;
+
+    return 0;
+}
+
+// Define free_maze_cache (server.h).
+void free_maze_cache(struct maze_cache_t* cache)
+{
+    // Assert that the pointer to the maze cache variable is valid.
+    assert(cache != NULL);
+
+    while (cache->newest != NULL)
+    {
+        struct maze_entry_t* entry = cache->newest;
+
+        unlink_entry(cache, entry);
+        free_entry(entry);
+    }
+
+    cache->bytes = 0;
+    pthread_mutex_destroy(&cache->mutex);
+}
+
+// Define acquire_maze (server.h).
+int acquire_maze(struct maze_cache_t* cache, const char* name, struct maze_entry_t** entry)
+{
+    // Assert that the pointer to the maze cache variable is valid.
+    assert(cache != NULL);
+    // Assert that the name is valid.
+    assert(name != NULL);
+    // Assert that the pointer to the entry variable is valid.
+    assert(entry != NULL);
+
+    // Use the cached maze if there is one.
+    pthread_mutex_lock(&cache->mutex);
+
+    struct maze_entry_t* found = find_entry(cache, name);
+    if (found != NULL)
+    {
+        found->users++;
+        unlink_entry(cache, found);
+        link_entry(cache, found);
+    }
+
+    pthread_mutex_unlock(&cache->mutex);
+
+    if (found != NULL)
+    {
+        *entry = found;
+        return 0;
+    }
+
+    // Otherwise, read the maze without holding the lock.
+    struct maze_entry_t* created = (struct maze_entry_t*) calloc(1, sizeof(struct maze_entry_t));
+    if (created == NULL) return -1;
+
+    created->name = strdup(name);
+    if (created->name == NULL || read_maze_file(&created->maze, name) != 0)
+    {
+        free(created->name);
+        free(created);
+        return -1;
+    }
+
+    created->bytes = (created->maze.mapping != NULL)
+                   ? created->maze.mapping_length
+                   : (created->maze.size.rows * created->maze.size.columns + 1) / 2;
+    created->users = 1;
+
+    pthread_mutex_lock(&cache->mutex);
+
+    // Another query may have read the same maze in the meantime, in which case
+    // its copy is used instead.
+    found = find_entry(cache, name);
+    if (found != NULL)
+    {
+        found->users++;
+        unlink_entry(cache, found);
+        link_entry(cache, found);
+    }
+    else
+    {
+        link_entry(cache, created);
+        evict_mazes(cache);
+    }
+
+    pthread_mutex_unlock(&cache->mutex);
+
+    if (found != NULL)
+    {
+        free_entry(created);
+        created = found;
+    }
+
+    *entry = created;
+
+    return 0;
+}
+
+// Define release_maze (server.h).
+void release_maze(struct maze_cache_t* cache, struct maze_entry_t* entry)
+{
+    // Assert that the pointer to the maze cache variable is valid.
+    assert(cache != NULL);
+    // Assert that the entry is in use.
+    assert(entry != NULL && entry->users > 0);
+
+    pthread_mutex_lock(&cache->mutex);
+
+    entry->users--;
+
+    bool freed = entry->unloaded && entry->users == 0;
+    if (!freed) evict_mazes(cache);
+
+    pthread_mutex_unlock(&cache->mutex);
+
+    if (freed) free_entry(entry);
+}
+
+// Define unload_maze (server.h).
+int unload_maze(struct maze_cache_t* cache, const char* name)
+{
+    // Assert that the pointer to the maze cache variable is valid.
+    assert(cache != NULL);
+    // Assert that the name is valid.
+    assert(name != NULL);
+
+    pthread_mutex_lock(&cache->mutex);
+
+    struct maze_entry_t* entry = find_entry(cache, name);
+    bool freed = false;
+
+    // Remove the entry from the cache, leaving it to the last query using it to
+    // free it if there is one.
+    if (entry != NULL)
+    {
+        unlink_entry(cache, entry);
+        entry->unloaded = true;
+        freed = entry->users == 0;
+    }
+
+    pthread_mutex_unlock(&cache->mutex);
+
+    if (freed) free_entry(entry);
+
+    return (entry != NULL) ? 0 : -1;
+}
+
+// Define make_solver_session (server.h).
+int make_solver_session(struct solver_session_t* session, struct maze_cache_t* cache)
+{
+    // Assert that the pointer to the solver session variable is valid.
+    assert(session != NULL);
+    // Assert that the pointer to the maze cache variable is valid.
+    assert(cache != NULL);
+
+    if (make_list(&session->list, 0) != 0) return -1;
+
+    if (make_compact_search(&session->search, (struct maze_size_t) { 1, 1 }) != 0)
+    {
+        resize_list(&session->list, 0);
+        return -1;
+    }
+
+    session->cache = cache;
+
+    return 0;
+}
+
+// Define free_solver_session (server.h).
+void free_solver_session(struct solver_session_t* session)
+{
+    // Assert that the pointer to the solver session variable is valid.
+    assert(session != NULL);
+
+    free_compact_search(&session->search);
+    resize_list(&session->list, 0);
+}
+
+// Define answer_request (server.h).
+int answer_request(struct solver_session_t* session, char* line, FILE* fp)
+{
+    // Assert that the pointer to the solver session variable is valid.
+    assert(session != NULL);
+    // Assert that the line is valid.
+    assert(line != NULL);
+    // Assert that the file handle is valid.
+    assert(fp != NULL);
+
+    char* saved = NULL;
+    char* command = strtok_r(line, " \t\r\n", &saved);
+    char* name = (command != NULL) ? strtok_r(NULL, " \t\r\n", &saved) : NULL;
+
+    if (command == NULL || name == NULL)
+    {
+        fprintf(fp, "error expected a command and a maze file\n");
+        return -1;
+    }
+
+    if (strcmp(command, "load") == 0)
+    {
+        struct maze_entry_t* entry = NULL;
+        if (acquire_maze(session->cache, name, &entry) != 0)
+        {
+            fprintf(fp, "error failed to read %s\n", name);
+            return -1;
+        }
+
+        fprintf(fp, "ok %zu %zu\n", entry->maze.size.rows, entry->maze.size.columns);
+        release_maze(session->cache, entry);
+
+        return 0;
+    }
+
+    if (strcmp(command, "solve") == 0) return answer_solve(session, name, &saved, fp);
+
+    if (strcmp(command, "unload") == 0)
+    {
+        if (unload_maze(session->cache, name) != 0)
+        {
+            fprintf(fp, "error %s is not loaded\n", name);
+            return -1;
+        }
+
+        fprintf(fp, "ok\n");
+
+        return 0;
+    }
+
+    fprintf(fp, "error unknown command %s\n", command);
+
+    return -1;
+}
+
+// Define run_server (server.h).
+int run_server(const char* path, size_t budget)
+{
+    // Assert that the path is valid.
+    assert(path != NULL);
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    // Indicate failure if the path does not fit in the address.
+    if (strlen(path) >= sizeof(address.sun_path)) return -1;
+    strcpy(address.sun_path, path);
+
+    int server_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server_fd < 0) return -1;
+
+    // Replace any socket left by a previous server, but never remove anything
+    // else found at the path.
+    struct stat status;
+    if (lstat(path, &status) == 0)
+    {
+        if (!S_ISSOCK(status.st_mode) || unlink(path) != 0)
+        {
+            close(server_fd);
+            return -1;
+        }
+    }
+
+    // Ignore the signal raised when writing to a client which has gone away,
+    // so that the write fails with EPIPE and only that connection is closed.
+    signal(SIGPIPE, SIG_IGN);
+
+    struct maze_cache_t cache;
+
+    if (bind(server_fd, (struct sockaddr*) &address, sizeof(address)) != 0
+     || listen(server_fd, SOMAXCONN) != 0
+     || make_maze_cache(&cache, budget) != 0)
+    {
+        close(server_fd);
+        return -1;
+    }
+
+    // Answer each connection on a thread of its own.
+    for (;;)
+    {
+        int client_fd = accept(server_fd, NULL, NULL);
+
+        if (client_fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            break;
+        }
+
+        struct connection_t* connection = (struct connection_t*) malloc(sizeof(struct connection_t));
+        pthread_t thread;
+
+        if (connection == NULL)
+        {
+            close(client_fd);
+            continue;
+        }
+
+        connection->cache = &cache;
+        connection->fd = client_fd;
+
+        if (pthread_create(&thread, NULL, serve_connection, (void*) connection) != 0)
+        {
+            close(client_fd);
+            free(connection);
+            continue;
+        }
+
+        pthread_detach(thread);
+    }
+
+    // The cache cannot be freed, as connections may still be using it.
+    close(server_fd);
+
+    return -1;
+}
+
+// Define find_entry (server.c).
+static struct maze_entry_t* find_entry(struct maze_cache_t* cache, const char* name)
+{
+    for (struct maze_entry_t* entry = cache->newest; entry != NULL; entry = entry->older)
+    {
+        if (strcmp(entry->name, name) == 0) return entry;
+    }
+
+    return NULL;
+}
+
+// Define unlink_entry (server.c).
+static void unlink_entry(struct maze_cache_t* cache, struct maze_entry_t* entry)
+{
+    if (entry->newer != NULL) entry->newer->older = entry->older;
+    else cache->newest = entry->older;
+
+    if (entry->older != NULL) entry->older->newer = entry->newer;
+    else cache->oldest = entry->newer;
+
+    entry->newer = NULL;
+    entry->older = NULL;
+    cache->bytes -= entry->bytes;
+}
+
+// Define link_entry (server.c).
+static void link_entry(struct maze_cache_t* cache, struct maze_entry_t* entry)
+{
+    entry->newer = NULL;
+    entry->older = cache->newest;
+
+    if (cache->newest != NULL) cache->newest->newer = entry;
+    else cache->oldest = entry;
+
+    cache->newest = entry;
+    cache->bytes += entry->bytes;
+}
+
+// Define free_entry (server.c).
+static void free_entry(struct maze_entry_t* entry)
+{
+    free_maze(&entry->maze);
+    free(entry->name);
+    free(entry);
+}
+
+// Define evict_mazes (server.c).
+static void evict_mazes(struct maze_cache_t* cache)
+{
+    struct maze_entry_t* entry = cache->oldest;
+
+    while (entry != NULL && cache->bytes > cache->budget)
+    {
+        struct maze_entry_t* newer = entry->newer;
+
+        if (entry->users == 0)
+        {
+            unlink_entry(cache, entry);
+            free_entry(entry);
+        }
+
+        entry = newer;
+    }
+}
+
+// Define parse_value (server.c).
+static int parse_value(size_t* value, char** saved)
+{
+    char* token = strtok_r(NULL, " \t\r\n", saved);
+    if (token == NULL || *token < '0' || *token > '9') return -1;
+
+    char* end = NULL;
+    errno = 0;
+    unsigned long number = strtoul(token, &end, 10);
+    if (errno != 0 || *end != '\0') return -1;
+
+    *value = (size_t) number;
+
+    return 0;
+}
+
+// Define answer_solve (server.c).
+static int answer_solve(struct solver_session_t* session, const char* name, char** saved, FILE* fp)
+{
+    size_t values[4];
+    for (size_t index = 0; index < 4; index++)
+    {
+        if (parse_value(&values[index], saved) != 0)
+        {
+            fprintf(fp, "error expected a start and end location\n");
+            return -1;
+        }
+    }
+
+    struct maze_entry_t* entry = NULL;
+    if (acquire_maze(session->cache, name, &entry) != 0)
+    {
+        fprintf(fp, "error failed to read %s\n", name);
+        return -1;
+    }
+
+    // Solve a copy of the maze with the requested locations, sharing the sets
+    // of actions, which are only read.
+    struct maze_t maze = entry->maze;
+    maze.start = (struct location_t) { values[0], values[1] };
+    maze.end = (struct location_t) { values[2], values[3] };
+
+    if (!check_location(maze.size, maze.start) || !check_location(maze.size, maze.end))
+    {
+        release_maze(session->cache, entry);
+        fprintf(fp, "error location outside the maze\n");
+        return -1;
+    }
+
+    // Reuse the nodes of the list from the previous query.
+    session->list.length = 0;
+
+    struct path_t path;
+    int result = solve_maze_compact_buffered(&session->list, maze, &session->search);
+    if (result == 0) result = make_path(&path, get_node(&session->list, session->list.length - 1));
+
+    release_maze(session->cache, entry);
+
+    if (result != 0)
+    {
+        fprintf(fp, "error no path found\n");
+        return -1;
+    }
+
+    // Write the answer as a single line, with the same characters for each
+    // action as write_path().
+    char* actions = (char*) malloc((path.length + 1) * sizeof(char));
+    if (actions == NULL)
+    {
+        free_path(&path);
+        fprintf(fp, "error out of memory\n");
+        return -1;
+    }
+
+    for (size_t step = 0; step < path.length; step++) actions[step] = action_char((enum action_t) path.actions[step]);
+    actions[path.length] = '\0';
+
+    fprintf(fp, "ok %zu %s\n", path.length, actions);
+
+    free(actions);
+    free_path(&path);
+
+    return 0;
+}
+
+// Define serve_connection (server.c).
+static void* serve_connection(void* arg)
+{
+    struct connection_t* connection = (struct connection_t*) arg;
+
+    // Use separate streams for reading and writing, each with its own copy of
+    // the socket.
+    int out_fd = dup(connection->fd);
+    FILE* in = fdopen(connection->fd, "r");
+    FILE* out = (out_fd >= 0) ? fdopen(out_fd, "w") : NULL;
+
+    struct solver_session_t session;
+    bool ready = in != NULL && out != NULL && make_solver_session(&session, connection->cache) == 0;
+
+    char* line = NULL;
+    size_t line_capacity = 0;
+
+    while (ready && getline(&line, &line_capacity, in) != -1)
+    {
+        answer_request(&session, line, out);
+
+        // End the connection if the client has gone away, which fails the
+        // write with EPIPE or ECONNRESET rather than raising SIGPIPE.
+        if (fflush(out) != 0) break;
+    }
+
+    free(line);
+
+    if (ready) free_solver_session(&session);
+
+    // Close each copy of the socket, through its stream if it has one.
+    if (out != NULL) fclose(out);
+    else if (out_fd >= 0) close(out_fd);
+
+    if (in != NULL) fclose(in);
+    else close(connection->fd);
+
+    free(connection);
+
+    return NULL;
+}
@@ -0,0 +1,113 @@
+#include "stats.h"
+
+#include "node.h"
+#include "node_list.h"
+
+#include <assert.h>
+#include <time.h>
+
+
+/**
+ * \internal
+ *
+ * Converts a time in nanoseconds to seconds.
+ *
+ * \param [in] time
+ *     The time in nanoseconds.
+ *
+ * \returns
+ *     The time in seconds.
+ */
+static double seconds(uint64_t time);
+
+// Define make_solve_stats (stats.h).
+void make_solve_stats(struct solve_stats_t* stats)
+{
+    // Assert that the pointer to the statistics variable is valid.
+    assert(stats != NULL);
+
+    *stats = (struct solve_stats_t) { .search = { .recorded = false } };
+}
+
+// Define monotonic_time (stats.h).
+uint64_t monotonic_time(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (uint64_t) time.tv_sec * 1000000000 + (uint64_t) time.tv_nsec;
+}
+
+// Define measure_solution (stats.h).
+void measure_solution(struct solve_stats_t* stats, struct node_list_t* list)
+{
+    // Assert that the pointer to the statistics variable is valid.
+    assert(stats != NULL);
+    // Assert that the list holds a path.
+    assert(list != NULL && list->length > 0);
+
+    // Count the actions taken by following the parents from the start.
+    size_t length = 0;
+    for (struct node_t* node = get_node(list, list->length - 1); node->parent != NULL; node = node->parent)
+    {
+        length++;
+    }
+
+    stats->path_length = length;
+    stats->list_peak_length = list->length;
+}
+
+// Define write_solve_stats (stats.h).
+int write_solve_stats(const struct solve_stats_t* stats, enum stats_format_t format, FILE* fp)
+{
+    // Assert that the pointer to the statistics variable is valid.
+    assert(stats != NULL);
+    // Assert that the file handle is valid.
+    assert(fp != NULL);
+
+    const struct search_stats_t* search = &stats->search;
+    int written = 0;
+
+    if (format == STATS_JSON)
+    {
+        written = fprintf(fp, "{\"rows\": %zu, \"columns\": %zu, \"path_length\": %zu, ", stats->rows, stats->columns, stats->path_length);
+        if (written < 0) return -1;
+
+        if (search->recorded)
+        {
+            written = fprintf(fp, "\"expansions\": %zu, \"pushes\": %zu, \"duplicate_pushes\": %zu, \"frontier_peak\": %zu, ",
+                              search->expansions, search->pushes, search->duplicate_pushes, search->frontier_peak);
+        }
+        else
+        {
+            written = fprintf(fp, "\"expansions\": null, \"pushes\": null, \"duplicate_pushes\": null, \"frontier_peak\": null, ");
+        }
+        if (written < 0) return -1;
+
+        written = fprintf(fp, "\"list_peak_length\": %zu, \"read_seconds\": %.9f, \"solve_seconds\": %.9f, \"write_seconds\": %.9f}\n",
+                          stats->list_peak_length, seconds(stats->read_time), seconds(stats->solve_time), seconds(stats->write_time));
+
+        return (written < 0) ? -1 : 0;
+    }
+
+    written = fprintf(fp, "maze size: %zu x %zu\npath length: %zu\n", stats->rows, stats->columns, stats->path_length);
+    if (written < 0) return -1;
+
+    if (search->recorded)
+    {
+        written = fprintf(fp, "expansions: %zu\npushes: %zu\nduplicate pushes: %zu\nfrontier peak: %zu\n",
+                          search->expansions, search->pushes, search->duplicate_pushes, search->frontier_peak);
+        if (written < 0) return -1;
+    }
+
+    written = fprintf(fp, "list peak length: %zu\nread time: %.6f s\nsolve time: %.6f s\nwrite time: %.6f s\n",
+                      stats->list_peak_length, seconds(stats->read_time), seconds(stats->solve_time), seconds(stats->write_time));
+
+    return (written < 0) ? -1 : 0;
+}
+
+// Define seconds (stats.c).
+static double seconds(uint64_t time)
+{
+    return (double) time / 1e9;
+}
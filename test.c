@@ -3,12 +3,34 @@
 #include "action.h"
 #include "node.h"
 #include "node_list.h"
+#include "node_queue.h"
+#include "location_set.h"
 #include "maze.h"
+#include "path.h"
+#include "parallel_search.h"
+#include "bitboard.h"
+#include "direction_map.h"
+#include "compact_search.h"
+#include "corridor_graph.h"
+#include "dead_end.h"
+#include "hierarchical_search.h"
+#include "maze_tree.h"
+#include "incremental_search.h"
+#include "search_engine.h"
+#include "batch.h"
+#include "bounded_queue.h"
+#include "pipeline.h"
+#include "server.h"
+#include "stats.h"
+#include "generator.h"
 #include "io.h"
 
 #include <assert.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #ifdef TEST
 
@@ -60,6 +82,27 @@ static void test_location_distance()
                              (struct location_t) {.row =        0, .column =  4096}) <= 16777217);
 }
 
+static void test_location_manhattan()
+{
+    // Test simple distances.
+    assert(location_manhattan((struct location_t) {.row = 0, .column = 0},
+                              (struct location_t) {.row = 0, .column = 0}) == 0);
+    assert(location_manhattan((struct location_t) {.row = 0, .column = 0},
+                              (struct location_t) {.row = 5, .column = 0}) == 5);
+    assert(location_manhattan((struct location_t) {.row = 5, .column = 0},
+                              (struct location_t) {.row = 1, .column = 0}) == 4);
+
+    // Test distances on both axes.
+    assert(location_manhattan((struct location_t) {.row = 3, .column = 0},
+                              (struct location_t) {.row = 0, .column = 4}) == 7);
+    assert(location_manhattan((struct location_t) {.row = 1, .column = 5},
+                              (struct location_t) {.row = 5, .column = 1}) == 8);
+
+    // Test extreme distances.
+    assert(location_manhattan((struct location_t) {.row =     4096, .column =     0},
+                              (struct location_t) {.row =        0, .column = 65536}) == 69632);
+}
+
 static void test_location_equal()
 {
     // Test equality.
@@ -143,6 +186,81 @@ static void test_action_taken()
                                  (struct location_t) {.row = 2, .column = 2}) != 0);
 }
 
+static void test_reverse_action()
+{
+    // Test the four cardinal directions.
+    assert(reverse_action(EAST) == WEST);
+    assert(reverse_action(SOUTH) == NORTH);
+    assert(reverse_action(WEST) == EAST);
+    assert(reverse_action(NORTH) == SOUTH);
+
+    // Test that reversing an action and its result returns to the original
+    // location.
+    for (enum action_t action = EAST; action <= NORTH; action++)
+    {
+        struct location_t location = action_result((struct location_t) {.row = 1, .column = 1}, action);
+        assert(location_equal(action_result(location, reverse_action(action)),
+                              (struct location_t) {.row = 1, .column = 1}));
+    }
+}
+
+static void test_action_sets()
+{
+    // Test a maze with an odd number of columns, so that rows begin in both
+    // halves of the packed bytes.
+    struct maze_t maze;
+    assert(make_maze(&maze, (struct maze_size_t) {.rows = 3, .columns = 5},
+                     (struct location_t) {.row = 0, .column = 0},
+                     (struct location_t) {.row = 2, .column = 4}) == 0);
+
+    // Test set_action_set with every set of actions, in an order which writes
+    // both halves of each byte in turn.
+    for (size_t i = 0; i < 15; i++)
+    {
+        set_action_set(maze, (enum action_set_t) ((i * 7) % 16),
+                       (struct location_t) {.row = i / 5, .column = i % 5});
+    }
+
+    // Check that setting a location did not affect its neighbours.
+    for (size_t i = 0; i < 15; i++)
+    {
+        assert(get_action_set(maze, (struct location_t) {.row = i / 5, .column = i % 5}) == (i * 7) % 16);
+    }
+
+    // Test get_row_action_sets for each row.
+    unsigned char action_sets[5];
+
+    for (size_t row = 0; row < 3; row++)
+    {
+        get_row_action_sets(maze, row, action_sets);
+
+        for (size_t column = 0; column < 5; column++)
+        {
+            assert(action_sets[column] == ((row * 5 + column) * 7) % 16);
+        }
+    }
+
+    // Test set_row_action_sets for the middle row, which begins in the upper
+    // half of a byte, and check that the neighbouring rows are unaffected.
+    unsigned char new_action_sets[5] = {1, 2, 4, 8, 15};
+    set_row_action_sets(maze, 1, new_action_sets);
+
+    get_row_action_sets(maze, 1, action_sets);
+    assert(memcmp(action_sets, new_action_sets, 5) == 0);
+    assert(get_action_set(maze, (struct location_t) {.row = 0, .column = 4}) == (4 * 7) % 16);
+    assert(get_action_set(maze, (struct location_t) {.row = 2, .column = 0}) == (10 * 7) % 16);
+
+    set_row_action_sets(maze, 2, new_action_sets);
+    assert(get_action_set(maze, (struct location_t) {.row = 1, .column = 4}) == 15);
+    assert(get_action_set(maze, (struct location_t) {.row = 2, .column = 4}) == 15);
+
+    // Test overwriting a set of actions.
+    set_action_set(maze, EAST_FLAG | NORTH_FLAG, (struct location_t) {.row = 1, .column = 2});
+    assert(get_action_set(maze, (struct location_t) {.row = 1, .column = 2}) == (EAST_FLAG | NORTH_FLAG));
+    assert(get_action_set(maze, (struct location_t) {.row = 1, .column = 1}) == 2);
+    assert(get_action_set(maze, (struct location_t) {.row = 1, .column = 3}) == 8);
+}
+
 static void test_node_list()
 {
     struct node_list_t node_list;
@@ -209,6 +327,314 @@ static void test_node_list()
     }
 }
 
+static void test_node_queue()
+{
+    struct node_queue_t node_queue;
+    struct node_t node;
+
+    // Test make_queue for a small maze, starting with no capacity.
+    assert(make_queue(&node_queue, (struct maze_size_t) {.rows = 4, .columns = 4}, 0) == 0);
+    assert(node_queue.length == 0);
+
+    // Test push_node with various costs.
+    size_t costs[8] = {5, 3, 7, 3, 1, 9, 3, 2};
+
+    for (size_t i = 0; i < 8; i++)
+    {
+        node = (struct node_t)
+        {
+            .location = {.row = i / 4, .column = i % 4},
+            .parent = NULL
+        };
+        assert(push_node(&node_queue, &node, costs[i]) == 0);
+        assert(queued_node(&node_queue, node.location));
+    }
+
+    assert(node_queue.length == 8);
+
+    // Test that pushing an existing location with a higher cost is merged
+    // without changing the queued node.
+    node = (struct node_t) {.location = {.row = 0, .column = 0}, .parent = NULL};
+    assert(push_node(&node_queue, &node, 8) == 0);
+    assert(node_queue.length == 8);
+
+    // Test that pushing an existing location with a lower cost decreases its
+    // cost.
+    node = (struct node_t) {.location = {.row = 1, .column = 1}, .parent = NULL};
+    assert(push_node(&node_queue, &node, 0) == 0);
+    assert(node_queue.length == 8);
+
+    // Check that both merged pushes were counted.
+    assert(node_queue.order == 8);
+    assert(node_queue.merges == 2);
+    assert(node_queue.peak_length == 8);
+
+    // Test that removing a queued location leaves the others queued, and that
+    // removing it again does nothing.
+    node = (struct node_t) {.location = {.row = 0, .column = 3}, .parent = NULL};
+    assert(remove_queued_node(&node_queue, node.location));
+    assert(!queued_node(&node_queue, node.location));
+    assert(!remove_queued_node(&node_queue, node.location));
+    assert(node_queue.length == 7);
+
+    // Test that a removed location can be pushed again with a higher cost.
+    assert(push_node(&node_queue, &node, 6) == 0);
+    assert(node_queue.length == 8);
+
+    // Check that the nodes are popped in order of cost, then order of pushing.
+    size_t order[8] = {5, 4, 7, 1, 6, 0, 3, 2};
+    size_t popped_costs[8] = {0, 1, 2, 3, 3, 5, 6, 7};
+
+    for (size_t i = 0; i < 8; i++)
+    {
+        assert(pop_node(&node_queue, &node) == popped_costs[i]);
+        assert(node.location.row * 4 + node.location.column == order[i]);
+        assert(!queued_node(&node_queue, node.location));
+    }
+
+    assert(node_queue.length == 0);
+    assert(node_queue.peak_length == 8);
+
+    free_queue(&node_queue);
+    assert(node_queue.capacity == 0);
+}
+
+static void test_location_set()
+{
+    struct location_set_t location_set;
+
+    // Test make_location_set with a size that does not fill the final byte.
+    assert(make_location_set(&location_set, (struct maze_size_t) {.rows = 3, .columns = 5}) == 0);
+
+    // Check that the set is initially empty.
+    for (size_t i = 0; i < 15; i++)
+    {
+        assert(!contains_location(&location_set, (struct location_t) {.row = i / 5, .column = i % 5}));
+    }
+
+    // Test add_location at the boundaries and within the maze.
+    add_location(&location_set, (struct location_t) {.row = 0, .column = 0});
+    add_location(&location_set, (struct location_t) {.row = 1, .column = 2});
+    add_location(&location_set, (struct location_t) {.row = 2, .column = 4});
+
+    // Check that only the added locations are contained in the set.
+    for (size_t i = 0; i < 15; i++)
+    {
+        bool added = i == 0 || i == 7 || i == 14;
+        assert(contains_location(&location_set, (struct location_t) {.row = i / 5, .column = i % 5}) == added);
+    }
+
+    // Test clear_location_set.
+    clear_location_set(&location_set);
+    assert(!contains_location(&location_set, (struct location_t) {.row = 1, .column = 2}));
+
+    free_location_set(&location_set);
+}
+
+static void test_direction_map()
+{
+    struct direction_map_t direction_map;
+
+    // Test make_direction_map with a size that does not fill the final byte.
+    assert(make_direction_map(&direction_map, (struct maze_size_t) {.rows = 3, .columns = 3}) == 0);
+
+    // Check that every location initially holds EAST.
+    for (size_t i = 0; i < 9; i++) assert(get_direction(&direction_map, i) == EAST);
+
+    // Test set_direction with every action, in an order which writes each part
+    // of each byte in turn.
+    for (size_t i = 0; i < 9; i++) set_direction(&direction_map, i, (enum action_t) ((i * 3) % 4));
+
+    for (size_t i = 0; i < 9; i++) assert(get_direction(&direction_map, i) == (i * 3) % 4);
+
+    // Test overwriting an action without affecting its neighbours.
+    set_direction(&direction_map, 5, NORTH);
+    assert(get_direction(&direction_map, 4) == (4 * 3) % 4);
+    assert(get_direction(&direction_map, 5) == NORTH);
+    assert(get_direction(&direction_map, 6) == (6 * 3) % 4);
+
+    free_direction_map(&direction_map);
+}
+
+static void test_path()
+{
+    // Construct a linked list of nodes along a path from (0, 0) to (2, 2).
+    struct node_t nodes[5] =
+    {
+        {.location = {.row = 0, .column = 0}, .parent = &nodes[1]},
+        {.location = {.row = 0, .column = 1}, .parent = &nodes[2]},
+        {.location = {.row = 0, .column = 2}, .parent = &nodes[3]},
+        {.location = {.row = 1, .column = 2}, .parent = &nodes[4]},
+        {.location = {.row = 2, .column = 2}, .parent = NULL}
+    };
+
+    struct path_t path;
+    assert(make_path(&path, &nodes[0]) == 0);
+    assert(path.length == 4);
+    assert(path.actions[0] == EAST);
+    assert(path.actions[1] == EAST);
+    assert(path.actions[2] == SOUTH);
+    assert(path.actions[3] == SOUTH);
+
+    char result[64] = "";
+
+    // Test each encoding of the path.
+    FILE* fp = tmpfile();
+    assert(fp != NULL);
+    assert(write_encoded_path(path, PATH_TEXT, fp) == 0);
+    rewind(fp);
+    assert(fread(result, sizeof(char), sizeof(result) - 1, fp) == 7);
+    fclose(fp);
+    assert(strncmp(result, "4\nRRDD\n", 7) == 0);
+
+    fp = tmpfile();
+    assert(fp != NULL);
+    assert(write_encoded_path(path, PATH_RUN_LENGTH, fp) == 0);
+    rewind(fp);
+    assert(fread(result, sizeof(char), sizeof(result) - 1, fp) == 7);
+    fclose(fp);
+    assert(strncmp(result, "4\nR2D2\n", 7) == 0);
+
+    fp = tmpfile();
+    assert(fp != NULL);
+    assert(write_encoded_path(path, PATH_BINARY, fp) == 0);
+    rewind(fp);
+    assert(fread(result, sizeof(char), sizeof(result) - 1, fp) == 9);
+    fclose(fp);
+
+    uint64_t length = 0;
+    memcpy(&length, result, sizeof(length));
+    assert(length == 4);
+    assert((unsigned char) result[8] == ((SOUTH << 4) | (SOUTH << 6)));
+
+    free_path(&path);
+    assert(path.actions == NULL);
+
+    // Test a path with no actions.
+    assert(make_path(&path, &nodes[4]) == 0);
+    assert(path.length == 0);
+
+    fp = tmpfile();
+    assert(fp != NULL);
+    assert(write_encoded_path(path, PATH_RUN_LENGTH, fp) == 0);
+    rewind(fp);
+    assert(fread(result, sizeof(char), sizeof(result) - 1, fp) == 3);
+    fclose(fp);
+    assert(strncmp(result, "0\n\n", 3) == 0);
+
+    free_path(&path);
+
+    // Test that a path between locations which are not next to each other is
+    // rejected.
+    nodes[2].location.column = 3;
+    assert(make_path(&path, &nodes[0]) != 0);
+}
+
+static void test_read_maze_file()
+{
+    static char* maze_files[3] =
+    {
+        "tests/maze1.txt",
+        "tests/maze2.txt",
+        "tests/maze3.txt"
+    };
+
+    // Check that mapping each maze file gives the same maze as reading it.
+    for (size_t i = 0; i < 3; i++)
+    {
+        FILE* fp = fopen(maze_files[i], "r");
+        assert(fp != NULL);
+
+        struct maze_t expected;
+        assert(read_maze(&expected, fp) == 0);
+
+        fclose(fp);
+
+        struct maze_t maze;
+        assert(read_maze_file(&maze, maze_files[i]) == 0);
+
+        assert(maze.size.rows == expected.size.rows);
+        assert(maze.size.columns == expected.size.columns);
+        assert(location_equal(maze.start, expected.start));
+        assert(location_equal(maze.end, expected.end));
+
+        for (size_t row = 0; row < maze.size.rows; row++)
+        {
+            for (size_t column = 0; column < maze.size.columns; column++)
+            {
+                struct location_t location = {.row = row, .column = column};
+                assert(get_action_set(maze, location) == get_action_set(expected, location));
+            }
+        }
+    }
+
+    // Test a maze with a row too long to be read a line at a time, and no
+    // final newline.
+    FILE* fp = fopen("tests/wide.txt", "w");
+    assert(fp != NULL);
+
+    fprintf(fp, "1 2000\n0 0\n0 1999\n");
+    for (size_t column = 0; column < 2000; column++)
+    {
+        fprintf(fp, column == 0 ? "14" : (column == 1999 ? " 11" : " 10"));
+    }
+
+    fclose(fp);
+
+    struct maze_t maze;
+    assert(read_maze_file(&maze, "tests/wide.txt") == 0);
+    assert(maze.size.columns == 2000);
+    assert(get_action_set(maze, (struct location_t) {.row = 0, .column = 0}) == EAST_FLAG);
+    assert(get_action_set(maze, (struct location_t) {.row = 0, .column = 1000}) == (EAST_FLAG | WEST_FLAG));
+    assert(get_action_set(maze, (struct location_t) {.row = 0, .column = 1999}) == WEST_FLAG);
+
+    // Test malformed mazes.
+    fp = fopen("tests/wide.txt", "w");
+    assert(fp != NULL);
+    fprintf(fp, "2 2\n0 0\n1 1\n1 2 3\n");
+    fclose(fp);
+    assert(read_maze_file(&maze, "tests/wide.txt") != 0);
+
+    fp = fopen("tests/wide.txt", "w");
+    assert(fp != NULL);
+    fprintf(fp, "2 2\n0 0\n2 1\n1 2\n3 4\n");
+    fclose(fp);
+    assert(read_maze_file(&maze, "tests/wide.txt") != 0);
+
+    fp = fopen("tests/wide.txt", "w");
+    assert(fp != NULL);
+    fprintf(fp, "1 2\n0 0\n0 1\n14 x\n");
+    fclose(fp);
+    assert(read_maze_file(&maze, "tests/wide.txt") != 0);
+
+    // Test sizes too big to hold or to index.
+    fp = fopen("tests/wide.txt", "w");
+    assert(fp != NULL);
+    fprintf(fp, "1 99999999999999999999999\n0 0\n0 0\n15\n");
+    fclose(fp);
+    assert(read_maze_file(&maze, "tests/wide.txt") != 0);
+
+    fp = fopen("tests/wide.txt", "w");
+    assert(fp != NULL);
+    fprintf(fp, "%zu %zu\n0 0\n0 0\n15\n", SIZE_MAX / 2, (size_t) 3);
+    fclose(fp);
+    assert(read_maze_file(&maze, "tests/wide.txt") != 0);
+
+    // Test a size of SIZE_MAX locations, whose action sets would round up to
+    // zero bytes.
+    fp = fopen("tests/wide.txt", "w");
+    assert(fp != NULL);
+    fprintf(fp, "%zu %zu\n0 0\n0 0\n15\n", SIZE_MAX, (size_t) 1);
+    fclose(fp);
+    assert(read_maze_file(&maze, "tests/wide.txt") != 0);
+    assert(verify_maze_file("tests/wide.txt") != 0);
+
+    remove("tests/wide.txt");
+
+    // Test a file that does not exist.
+    assert(read_maze_file(&maze, "tests/missing.txt") != 0);
+}
+
 static void test_solve_maze()
 {
     static char* maze_files[4] =
@@ -287,14 +713,1844 @@ static void test_solve_maze()
     }
 }
 
+static void test_write_maze_binary()
+{
+    struct maze_t expected;
+    assert(read_maze_file(&expected, "tests/maze3.txt") == 0);
+
+    FILE* fp = fopen("tests/maze3.bin", "wb");
+    assert(fp != NULL);
+    assert(write_maze_binary(expected, fp) == 0);
+    fclose(fp);
+
+    // Check that mapping the binary file gives the same maze as the text file,
+    // using the sets of actions in place.
+    struct maze_t maze;
+    assert(verify_maze_file("tests/maze3.bin") == 0);
+    assert(read_maze_file(&maze, "tests/maze3.bin") == 0);
+    assert(maze.mapping != NULL);
+    assert(maze.action_sets == (unsigned char*) maze.mapping + 64);
+
+    assert(maze.size.rows == expected.size.rows);
+    assert(maze.size.columns == expected.size.columns);
+    assert(location_equal(maze.start, expected.start));
+    assert(location_equal(maze.end, expected.end));
+
+    for (size_t row = 0; row < maze.size.rows; row++)
+    {
+        for (size_t column = 0; column < maze.size.columns; column++)
+        {
+            struct location_t location = {.row = row, .column = column};
+            assert(get_action_set(maze, location) == get_action_set(expected, location));
+        }
+    }
+
+    // Check that changing the mapped maze does not change the file.
+    struct location_t location = {.row = 0, .column = 0};
+    enum action_set_t action_set = get_action_set(maze, location);
+    set_action_set(maze, (enum action_set_t) (~action_set & 0xF), location);
+
+    struct maze_t copy;
+    assert(read_maze_file(&copy, "tests/maze3.bin") == 0);
+    assert(get_action_set(copy, location) == action_set);
+
+    free_maze(&copy);
+    free_maze(&maze);
+    assert(maze.action_sets == NULL);
+
+    // Test that a corrupted file is still mapped, but rejected by its checksum
+    // when it is verified.
+    fp = fopen("tests/maze3.bin", "r+b");
+    assert(fp != NULL);
+    assert(fseek(fp, 100, SEEK_SET) == 0);
+    int byte = fgetc(fp);
+    assert(fseek(fp, 100, SEEK_SET) == 0);
+    fputc(byte ^ 0x10, fp);
+    fclose(fp);
+
+    assert(verify_maze_file("tests/maze3.bin") != 0);
+    assert(read_maze_file(&maze, "tests/maze3.bin") == 0);
+    free_maze(&maze);
+
+    // Test that the checksum is the FNV-1a hash of the sets of actions, using
+    // a maze packed into the single byte 'a'.
+    struct maze_size_t size = {.rows = 1, .columns = 2};
+    struct location_t corner = {.row = 0, .column = 0};
+    struct location_t other = {.row = 0, .column = 1};
+    struct maze_t small;
+    assert(make_maze(&small, size, corner, other) == 0);
+    set_action_set(small, (enum action_set_t) 0x1, corner);
+    set_action_set(small, (enum action_set_t) 0x6, other);
+
+    fp = fopen("tests/maze3.bin", "wb");
+    assert(fp != NULL);
+    assert(write_maze_binary(small, fp) == 0);
+    fclose(fp);
+    free_maze(&small);
+
+    fp = fopen("tests/maze3.bin", "rb");
+    assert(fp != NULL);
+    unsigned char header[64];
+    assert(fread(header, 1, sizeof(header), fp) == sizeof(header));
+    fclose(fp);
+
+    uint64_t checksum;
+    memcpy(&checksum, header + 56, sizeof(checksum));
+    assert(checksum == 0xAF63DC4C8601EC8Cu);
+    assert(verify_maze_file("tests/maze3.bin") == 0);
+
+    // Test that a truncated file is rejected.
+    fp = fopen("tests/maze3.bin", "wb");
+    assert(fp != NULL);
+    assert(write_maze_binary(expected, fp) == 0);
+    fclose(fp);
+    assert(truncate("tests/maze3.bin", 80) == 0);
+
+    assert(read_maze_file(&maze, "tests/maze3.bin") != 0);
+    assert(verify_maze_file("tests/maze3.bin") != 0);
+
+    // Test that a header alone, claiming a maze of SIZE_MAX x 1 locations whose
+    // action sets would round up to zero bytes, is rejected.
+    memcpy(header, "MAZE", 4);
+    uint32_t version = 2;
+    uint64_t fields[7] = { SIZE_MAX, 1, 0, 0, 1, 0, 0xCBF29CE484222325u };
+    memcpy(header + 4, &version, sizeof(version));
+    memcpy(header + 8, fields, sizeof(fields));
+
+    fp = fopen("tests/maze3.bin", "wb");
+    assert(fp != NULL);
+    assert(fwrite(header, 1, sizeof(header), fp) == sizeof(header));
+    fclose(fp);
+
+    assert(read_maze_file(&maze, "tests/maze3.bin") != 0);
+    assert(verify_maze_file("tests/maze3.bin") != 0);
+
+    remove("tests/maze3.bin");
+    free_maze(&expected);
+}
+
+static void test_write_maze()
+{
+    static char* expected =
+        "#####################\n"
+        "#                   #\n"
+        "#   #############   #\n"
+        "#           #   #   #\n"
+        "#########       #   #\n"
+        "#       #       #   #\n"
+        "####    #####   #   #\n"
+        "#           #   #   #\n"
+        "#   ####        #   #\n"
+        "#   #           #   #\n"
+        "#####################\n";
+
+    static char* expected_solved =
+        "#####################\n"
+        "# *   *   *   *   * #\n"
+        "#   #############   #\n"
+        "# .         #   # * #\n"
+        "#########       #   #\n"
+        "#       #       # * #\n"
+        "####    #####   #   #\n"
+        "#           #   # * #\n"
+        "#   ####        #   #\n"
+        "#   #           # * #\n"
+        "#####################\n";
+
+    char result[512] = "";
+
+    struct maze_t maze;
+    assert(read_maze_file(&maze, "tests/maze1.txt") == 0);
+
+    // Check that the maze is written as expected.
+    FILE* fp = tmpfile();
+    assert(fp != NULL);
+    assert(write_maze(maze, fp) == 0);
+    rewind(fp);
+    assert(fread(result, sizeof(char), sizeof(result) - 1, fp) == strlen(expected));
+    fclose(fp);
+    assert(strcmp(result, expected) == 0);
+
+    // Explore an extra location off the path, then solve the maze.
+    struct node_list_t explored;
+    assert(make_list(&explored, 0) == 0);
+
+    struct node_t node = {.location = {.row = 1, .column = 0}, .parent = NULL};
+    assert(insert_node(&explored, &node, 0) == 0);
+    assert(solve_maze_compact(&explored, maze) == 0);
+
+    // Check that the path and the explored location are marked.
+    memset(result, 0, sizeof(result));
+    fp = tmpfile();
+    assert(fp != NULL);
+    assert(write_solved_maze(maze, &explored, true, fp) == 0);
+    rewind(fp);
+    assert(fread(result, sizeof(char), sizeof(result) - 1, fp) == strlen(expected_solved));
+    fclose(fp);
+    assert(strcmp(result, expected_solved) == 0);
+
+    resize_list(&explored, 0);
+    free_maze(&maze);
+}
+
+static void test_maze_image()
+{
+    struct maze_t maze;
+    assert(read_maze_file(&maze, "tests/maze1.txt") == 0);
+
+    // Test a bitmap of the walls of the maze.
+    struct maze_image_t image;
+    assert(make_maze_image(&image, maze, NULL, IMAGE_PBM) == 0);
+    assert(image.width == 11);
+    assert(image.height == 11);
+    assert(image.line_length == 2);
+
+    FILE* fp = tmpfile();
+    assert(fp != NULL);
+    assert(write_maze_image(&image, fp) == 0);
+    rewind(fp);
+
+    unsigned char result[256];
+    size_t header_length = strlen("P4\n11 11\n");
+    assert(fread(result, sizeof(unsigned char), sizeof(result), fp) == header_length + 22);
+    fclose(fp);
+    assert(memcmp(result, "P4\n11 11\n", header_length) == 0);
+
+    // The top line is all wall, and the second line is open from (0, 0) to
+    // (0, 4), apart from the outside walls.
+    assert(result[header_length] == 0xFF && result[header_length + 1] == 0xE0);
+    assert(result[header_length + 2] == 0x80 && result[header_length + 3] == 0x20);
+
+    free_maze_image(&image);
+
+    // Test a graymap of the maze, solved with A* search.
+    struct node_list_t explored;
+    assert(make_list(&explored, 0) == 0);
+    solve_maze_a_star(&explored, maze);
+
+    assert(make_maze_image(&image, maze, &explored, IMAGE_PGM) == 0);
+    assert(image.line_length == 11);
+
+    unsigned char whole[11 * 11];
+    assert(image_band_size(&image, 0, 5) == sizeof(whole));
+    assert(render_image_band(&image, 0, 5, whole) == 0);
+
+    // Check that the path is drawn from the start to the end, including the
+    // steps between locations.
+    for (size_t x = 1; x < 10; x++) assert(whole[1 * 11 + x] == 48);
+    for (size_t y = 1; y < 10; y++) assert(whole[y * 11 + 9] == 48);
+
+    // Check that rendering the image in bands gives the same pixels.
+    unsigned char bands[11 * 11];
+    assert(image_band_size(&image, 0, 2) == 5 * 11);
+    assert(image_band_size(&image, 2, 5) == 6 * 11);
+    assert(render_image_band(&image, 0, 2, bands) == 0);
+    assert(render_image_band(&image, 2, 5, bands + 5 * 11) == 0);
+    assert(memcmp(whole, bands, sizeof(whole)) == 0);
+
+    free_maze_image(&image);
+    resize_list(&explored, 0);
+    free_maze(&maze);
+}
+
+static void test_solve_maze_a_star()
+{
+    static char* maze_files[2] =
+    {
+        "tests/maze1.txt",
+        "tests/maze2.txt"
+    };
+
+    // The lengths of the solutions in the corresponding solution files.
+    static size_t path_lengths[2] = {8, 172};
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        FILE* fp = fopen(maze_files[i], "r");
+        assert(fp != NULL);
+
+        // Read in a maze from the maze file.
+        struct maze_t maze;
+        assert(read_maze(&maze, fp) == 0);
+
+        fclose(fp);
+
+        // Solve the maze.
+        struct node_list_t explored;
+        assert(make_list(&explored, 0) == 0);
+        solve_maze_a_star(&explored, maze);
+
+        // Check that the path leads from the start to the end of the maze by
+        // the shortest route.
+        struct node_t* node = get_node(&explored, explored.length - 1);
+        assert(location_equal(node->location, maze.start));
+
+        size_t length = 0;
+        for (; node->parent != NULL; node = node->parent) length++;
+
+        assert(location_equal(node->location, maze.end));
+        assert(length == path_lengths[i]);
+
+        resize_list(&explored, 0);
+    }
+
+    // Test a maze with no internal walls, which contains many loops.
+    struct maze_t maze;
+    assert(make_maze(&maze, (struct maze_size_t) {.rows = 8, .columns = 8},
+                     (struct location_t) {.row = 0, .column = 0},
+                     (struct location_t) {.row = 7, .column = 5}) == 0);
+
+    for (size_t row = 0; row < 8; row++)
+    {
+        for (size_t column = 0; column < 8; column++)
+        {
+            unsigned int action_set = EAST_FLAG | SOUTH_FLAG | WEST_FLAG | NORTH_FLAG;
+            if (row == 0) action_set &= ~(unsigned int) NORTH_FLAG;
+            if (row == 7) action_set &= ~(unsigned int) SOUTH_FLAG;
+            if (column == 0) action_set &= ~(unsigned int) WEST_FLAG;
+            if (column == 7) action_set &= ~(unsigned int) EAST_FLAG;
+
+            set_action_set(maze, (enum action_set_t) action_set,
+                           (struct location_t) {.row = row, .column = column});
+        }
+    }
+
+    struct node_list_t explored;
+    assert(make_list(&explored, 0) == 0);
+    solve_maze_a_star(&explored, maze);
+
+    // Check that the path is as short as the Manhattan distance, and that the
+    // heuristic prevented the whole maze from being explored.
+    struct node_t* node = get_node(&explored, explored.length - 1);
+    assert(location_equal(node->location, maze.start));
+
+    size_t length = 0;
+    for (; node->parent != NULL; node = node->parent) length++;
+
+    assert(length == 12);
+    assert(explored.length < 64);
+
+    resize_list(&explored, 0);
+}
+
+static void check_solution(struct node_list_t* path, struct maze_t maze, char* solution_file)
+{
+    char solution[1024] = "";
+    char result[1024] = "";
+
+    // Read the solution from the solution file.
+    FILE* fp = fopen(solution_file, "r");
+    assert(fp != NULL);
+
+    assert(fread(solution, sizeof(char), sizeof(solution) - 1, fp) > 0);
+
+    fclose(fp);
+
+    // Check that the path leads from the start to the end of the maze.
+    struct node_t* start = get_node(path, path->length - 1);
+    assert(location_equal(start->location, maze.start));
+
+    // Write the path to a temporary file and check that it is equal to the
+    // solution.
+    fp = tmpfile();
+    assert(fp != NULL);
+
+    assert(write_path(start, fp) == 0);
+
+    rewind(fp);
+    assert(fread(result, sizeof(char), sizeof(result) - 1, fp) > 0);
+
+    fclose(fp);
+
+    assert(strcmp(solution, result) == 0);
+}
+
+static void test_solve_maze_bidirectional()
+{
+    static char* maze_files[2] =
+    {
+        "tests/maze1.txt",
+        "tests/maze2.txt"
+    };
+
+    static char* solution_files[2] =
+    {
+        "tests/solution1.txt",
+        "tests/solution2.txt"
+    };
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        FILE* fp = fopen(maze_files[i], "r");
+        assert(fp != NULL);
+
+        // Read in a maze from the maze file.
+        struct maze_t maze;
+        assert(read_maze(&maze, fp) == 0);
+
+        fclose(fp);
+
+        // Solve the maze, and check that only the path was inserted.
+        struct node_list_t path;
+        assert(make_list(&path, 0) == 0);
+        solve_maze_bidirectional(&path, maze);
+
+        assert(location_equal(get_node(&path, 0)->location, maze.end));
+        check_solution(&path, maze, solution_files[i]);
+
+        resize_list(&path, 0);
+    }
+}
+
+static void test_solve_maze_parallel()
+{
+    static char* maze_files[2] =
+    {
+        "tests/maze1.txt",
+        "tests/maze2.txt"
+    };
+
+    static char* solution_files[2] =
+    {
+        "tests/solution1.txt",
+        "tests/solution2.txt"
+    };
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        FILE* fp = fopen(maze_files[i], "r");
+        assert(fp != NULL);
+
+        // Read in a maze from the maze file.
+        struct maze_t maze;
+        assert(read_maze(&maze, fp) == 0);
+
+        fclose(fp);
+
+        // Solve the maze with various numbers of threads.
+        for (size_t threads = 1; threads <= 8; threads *= 2)
+        {
+            struct node_list_t path;
+            assert(make_list(&path, 0) == 0);
+            assert(solve_maze_parallel(&path, maze, threads) == 0);
+
+            check_solution(&path, maze, solution_files[i]);
+
+            resize_list(&path, 0);
+        }
+    }
+}
+
+static void test_bitboard()
+{
+    static char* maze_files[2] =
+    {
+        "tests/maze1.txt",
+        "tests/maze2.txt"
+    };
+
+    static char* solution_files[2] =
+    {
+        "tests/solution1.txt",
+        "tests/solution2.txt"
+    };
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        FILE* fp = fopen(maze_files[i], "r");
+        assert(fp != NULL);
+
+        // Read in a maze from the maze file.
+        struct maze_t maze;
+        assert(read_maze(&maze, fp) == 0);
+
+        fclose(fp);
+
+        // Check that every bit of the bitplanes matches the sets of actions.
+        struct bitplanes_t planes;
+        assert(make_bitplanes(&planes, maze) == 0);
+
+        for (size_t row = 0; row < maze.size.rows; row++)
+        {
+            for (size_t column = 0; column < maze.size.columns; column++)
+            {
+                unsigned int action_set = get_action_set(maze, (struct location_t) {.row = row, .column = column});
+
+                for (enum action_t action = EAST; action <= NORTH; action++)
+                {
+                    uint64_t word = planes.planes[action][row * planes.stride + column / 64];
+                    assert(((word >> (column % 64)) & 1) == ((action_set >> action) & 1));
+                }
+            }
+        }
+
+        free_bitplanes(&planes);
+
+        // Solve the maze.
+        struct node_list_t path;
+        assert(make_list(&path, 0) == 0);
+        assert(solve_maze_bitboard(&path, maze) == 0);
+
+        check_solution(&path, maze, solution_files[i]);
+
+        resize_list(&path, 0);
+    }
+
+    // Test a maze with no internal walls which spans several words per row, so
+    // that locations are carried between words in both directions.
+    struct maze_t maze;
+    assert(make_maze(&maze, (struct maze_size_t) {.rows = 3, .columns = 130},
+                     (struct location_t) {.row = 2, .column = 129},
+                     (struct location_t) {.row = 0, .column = 0}) == 0);
+
+    for (size_t row = 0; row < 3; row++)
+    {
+        for (size_t column = 0; column < 130; column++)
+        {
+            unsigned int action_set = EAST_FLAG | SOUTH_FLAG | WEST_FLAG | NORTH_FLAG;
+            if (row == 0) action_set &= ~(unsigned int) NORTH_FLAG;
+            if (row == 2) action_set &= ~(unsigned int) SOUTH_FLAG;
+            if (column == 0) action_set &= ~(unsigned int) WEST_FLAG;
+            if (column == 129) action_set &= ~(unsigned int) EAST_FLAG;
+
+            set_action_set(maze, (enum action_set_t) action_set,
+                           (struct location_t) {.row = row, .column = column});
+        }
+    }
+
+    struct node_list_t path;
+    assert(make_list(&path, 0) == 0);
+    assert(solve_maze_bitboard(&path, maze) == 0);
+
+    // Check that the path is as short as the Manhattan distance.
+    assert(path.length == 132);
+    assert(location_equal(get_node(&path, path.length - 1)->location, maze.start));
+    assert(location_equal(get_node(&path, 0)->location, maze.end));
+
+    // Test the reverse direction.
+    struct location_t start = maze.start;
+    maze.start = maze.end;
+    maze.end = start;
+
+    path.length = 0;
+    assert(solve_maze_bitboard(&path, maze) == 0);
+    assert(path.length == 132);
+
+    free_maze(&maze);
+
+    // Test a large perfect maze, whose long winding path keeps the frontier
+    // small but spread over many rows, and check that the search takes time in
+    // proportion to the frontier rather than to the rows it spans, by comparing
+    // it with the compact search.
+    struct generator_options_t options = {.algorithm = GENERATOR_BACKTRACKER, .size = {.rows = 1000, .columns = 1000}, .seed = 1, .braid = 0};
+    assert(generate_maze(&maze, options) == 0);
+
+    struct node_list_t compact;
+    assert(make_list(&compact, 0) == 0);
+
+    uint64_t compact_time = monotonic_time();
+    assert(solve_maze_compact(&compact, maze) == 0);
+    compact_time = monotonic_time() - compact_time;
+
+    path.length = 0;
+    uint64_t bitboard_time = monotonic_time();
+    assert(solve_maze_bitboard(&path, maze) == 0);
+    bitboard_time = monotonic_time() - bitboard_time;
+
+    assert(path.length == compact.length);
+    assert(bitboard_time < 10 * compact_time + 100000000);
+
+    resize_list(&compact, 0);
+    resize_list(&path, 0);
+    free_maze(&maze);
+}
+
+static void test_solve_maze_compact()
+{
+    static char* maze_files[2] =
+    {
+        "tests/maze1.txt",
+        "tests/maze2.txt"
+    };
+
+    static char* solution_files[2] =
+    {
+        "tests/solution1.txt",
+        "tests/solution2.txt"
+    };
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        FILE* fp = fopen(maze_files[i], "r");
+        assert(fp != NULL);
+
+        // Read in a maze from the maze file.
+        struct maze_t maze;
+        assert(read_maze(&maze, fp) == 0);
+
+        fclose(fp);
+
+        // Solve the maze.
+        struct node_list_t path;
+        assert(make_list(&path, 0) == 0);
+        assert(solve_maze_compact(&path, maze) == 0);
+
+        check_solution(&path, maze, solution_files[i]);
+
+        resize_list(&path, 0);
+    }
+
+    // Test reusing the same buffers for a bigger maze, then smaller ones.
+    struct compact_search_t search;
+    assert(make_compact_search(&search, (struct maze_size_t) {.rows = 1, .columns = 1}) == 0);
+
+    struct maze_t big_maze;
+    assert(read_maze_file(&big_maze, "tests/maze3.txt") == 0);
+
+    struct node_list_t path;
+    assert(make_list(&path, 0) == 0);
+    assert(solve_maze_compact_buffered(&path, big_maze, &search) == 0);
+    assert(location_equal(get_node(&path, path.length - 1)->location, big_maze.start));
+    assert(search.capacity == big_maze.size.rows * big_maze.size.columns);
+
+    free_maze(&big_maze);
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        struct maze_t maze;
+        assert(read_maze_file(&maze, maze_files[i]) == 0);
+
+        path.length = 0;
+        assert(solve_maze_compact_buffered(&path, maze, &search) == 0);
+
+        check_solution(&path, maze, solution_files[i]);
+
+        free_maze(&maze);
+    }
+
+    resize_list(&path, 0);
+    free_compact_search(&search);
+}
+
+static void test_batch()
+{
+    // Write a list of jobs, including one whose maze file does not exist.
+    FILE* fp = fopen("tests/batch.txt", "w");
+    assert(fp != NULL);
+    fprintf(fp, "tests/maze1.txt tests/batch1.txt\n\n");
+    fprintf(fp, "tests/maze2.txt\ttests/batch2.txt\n");
+    fprintf(fp, "tests/missing.txt tests/batch3.txt\n");
+    fprintf(fp, "tests/maze3.txt tests/batch4.txt\n");
+    fclose(fp);
+
+    struct batch_t batch;
+    make_batch(&batch);
+    assert(read_batch_list(&batch, "tests/batch.txt") == 0);
+    assert(batch.length == 4);
+    assert(strcmp(batch.jobs[1].input, "tests/maze2.txt") == 0);
+    assert(strcmp(batch.jobs[1].output, "tests/batch2.txt") == 0);
+
+    // Solve the batch with more threads than jobs, so that some threads start
+    // with nothing to do and must steal.
+    assert(solve_batch(&batch, 6, PATH_TEXT, NULL) != 0);
+    assert(batch.jobs[0].result == 0);
+    assert(batch.jobs[1].result == 0);
+    assert(batch.jobs[2].result != 0);
+    assert(batch.jobs[3].result == 0);
+
+    free_batch(&batch);
+
+    // Check that the solutions were written.
+    static char* results_files[2] = { "tests/batch1.txt", "tests/batch2.txt" };
+    static char* solution_files[2] = { "tests/solution1.txt", "tests/solution2.txt" };
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        char solution[1024] = "";
+        char result[1024] = "";
+
+        fp = fopen(solution_files[i], "r");
+        assert(fp != NULL);
+        assert(fread(solution, sizeof(char), sizeof(solution) - 1, fp) > 0);
+        fclose(fp);
+
+        fp = fopen(results_files[i], "r");
+        assert(fp != NULL);
+        assert(fread(result, sizeof(char), sizeof(result) - 1, fp) > 0);
+        fclose(fp);
+
+        assert(strcmp(solution, result) == 0);
+    }
+
+    // Test a list with a line that does not hold two names.
+    fp = fopen("tests/batch.txt", "w");
+    assert(fp != NULL);
+    fprintf(fp, "tests/maze1.txt\n");
+    fclose(fp);
+
+    make_batch(&batch);
+    assert(read_batch_list(&batch, "tests/batch.txt") != 0);
+    free_batch(&batch);
+
+    remove("tests/batch.txt");
+    remove("tests/batch1.txt");
+    remove("tests/batch2.txt");
+    remove("tests/batch4.txt");
+}
+
+static void test_bounded_queue()
+{
+    struct bounded_queue_t queue;
+    assert(make_bounded_queue(&queue, 4) == 0);
+
+    int values[6] = { 0, 1, 2, 3, 4, 5 };
+    void* value = NULL;
+
+    // Test that an empty queue gives nothing.
+    assert(!try_pop_value(&queue, &value));
+
+    // Test filling the queue, then emptying it in the same order.
+    for (size_t i = 0; i < 4; i++) assert(try_push_value(&queue, &values[i]));
+    assert(!try_push_value(&queue, &values[4]));
+
+    for (size_t i = 0; i < 4; i++)
+    {
+        assert(try_pop_value(&queue, &value));
+        assert(value == &values[i]);
+    }
+
+    assert(!try_pop_value(&queue, &value));
+
+    // Test values wrapping around the end of the buffer.
+    for (size_t pass = 0; pass < 3; pass++)
+    {
+        for (size_t i = 0; i < 3; i++) assert(try_push_value(&queue, &values[i + pass]));
+
+        for (size_t i = 0; i < 3; i++)
+        {
+            assert(try_pop_value(&queue, &value));
+            assert(value == &values[i + pass]);
+        }
+    }
+
+    free_bounded_queue(&queue);
+}
+
+static void test_pipeline()
+{
+    // Write a list of jobs, including one whose maze file does not exist.
+    FILE* fp = fopen("tests/pipeline.txt", "w");
+    assert(fp != NULL);
+    for (size_t i = 0; i < 8; i++)
+    {
+        fprintf(fp, "tests/maze%zu.txt tests/pipeline%zu.txt\n", i % 2 + 1, i);
+    }
+    fprintf(fp, "tests/missing.txt tests/pipeline8.txt\n");
+    fclose(fp);
+
+    struct batch_t batch;
+    make_batch(&batch);
+    assert(read_batch_list(&batch, "tests/pipeline.txt") == 0);
+
+    // Solve the batch with queues small enough to fill, so that each stage is
+    // held back by the next.
+    struct pipeline_widths_t widths = {.parsers = 2, .solvers = 3, .writers = 2, .depth = 2};
+    assert(run_pipeline(&batch, widths, PATH_TEXT, NULL) != 0);
+
+    for (size_t i = 0; i < 8; i++) assert(batch.jobs[i].result == 0);
+    assert(batch.jobs[8].result != 0);
+
+    free_batch(&batch);
+
+    // Check that the solutions were written.
+    static char* solution_files[2] = { "tests/solution1.txt", "tests/solution2.txt" };
+
+    for (size_t i = 0; i < 8; i++)
+    {
+        char solution[1024] = "";
+        char result[1024] = "";
+        char results_file[64] = "";
+
+        fp = fopen(solution_files[i % 2], "r");
+        assert(fp != NULL);
+        assert(fread(solution, sizeof(char), sizeof(solution) - 1, fp) > 0);
+        fclose(fp);
+
+        snprintf(results_file, sizeof(results_file), "tests/pipeline%zu.txt", i);
+        fp = fopen(results_file, "r");
+        assert(fp != NULL);
+        assert(fread(result, sizeof(char), sizeof(result) - 1, fp) > 0);
+        fclose(fp);
+
+        assert(strcmp(solution, result) == 0);
+
+        remove(results_file);
+    }
+
+    remove("tests/pipeline.txt");
+}
+
+static void test_maze_cache()
+{
+    // Use a budget which only fits the two smallest mazes.
+    struct maze_cache_t cache;
+    assert(make_maze_cache(&cache, 26) == 0);
+
+    struct maze_entry_t* first = NULL;
+    struct maze_entry_t* second = NULL;
+    struct maze_entry_t* entry = NULL;
+
+    // Test that a maze is read once and then shared.
+    assert(acquire_maze(&cache, "tests/maze1.txt", &first) == 0);
+    assert(acquire_maze(&cache, "tests/maze1.txt", &entry) == 0);
+    assert(entry == first);
+    assert(first->users == 2);
+    assert(first->maze.size.rows == 5 && first->maze.size.columns == 5);
+    assert(cache.bytes == 13);
+    release_maze(&cache, entry);
+    release_maze(&cache, first);
+
+    // Test that a file which cannot be read is not cached.
+    assert(acquire_maze(&cache, "tests/missing.txt", &entry) != 0);
+    assert(cache.newest == first && cache.oldest == first);
+
+    assert(acquire_maze(&cache, "tests/maze4.txt", &second) == 0);
+    release_maze(&cache, second);
+    assert(cache.bytes == 26);
+    assert(cache.newest == second && cache.oldest == first);
+
+    // Test that using a maze makes it the most recently used.
+    assert(acquire_maze(&cache, "tests/maze1.txt", &entry) == 0);
+    assert(cache.newest == first && cache.oldest == second);
+
+    // Test that going over budget evicts the least recently used maze, but not
+    // a maze which is in use.
+    assert(acquire_maze(&cache, "tests/maze2.txt", &entry) == 0);
+    assert(cache.newest == entry && cache.oldest == first);
+    assert(cache.bytes == 13 + 1250);
+    release_maze(&cache, entry);
+    assert(cache.newest == first && cache.oldest == first);
+    assert(cache.bytes == 13);
+
+    // Test that a maze unloaded while in use stays valid until it is released.
+    assert(unload_maze(&cache, "tests/maze1.txt") == 0);
+    assert(unload_maze(&cache, "tests/maze1.txt") != 0);
+    assert(cache.newest == NULL && cache.oldest == NULL);
+    assert(cache.bytes == 0);
+    assert(first->unloaded);
+    assert(first->maze.size.rows == 5);
+    release_maze(&cache, first);
+
+    free_maze_cache(&cache);
+}
+
+static void test_server()
+{
+    struct maze_cache_t cache;
+    assert(make_maze_cache(&cache, 1024 * 1024) == 0);
+
+    struct solver_session_t session;
+    assert(make_solver_session(&session, &cache) == 0);
+
+    static char* requests[] =
+    {
+        "load tests/maze1.txt\n",
+        "solve tests/maze1.txt 0 0 4 4\n",
+        "solve tests/maze1.txt 4 4 0 4\n",
+        "solve tests/maze1.txt 0 0 5 4\n",
+        "solve tests/maze1.txt 0 0 4\n",
+        "solve tests/maze2.txt 0 0 49 49\n",
+        "unload tests/maze1.txt\n",
+        "unload tests/maze1.txt\n",
+        "load tests/missing.txt\n",
+        "jump tests/maze1.txt\n",
+        "\n"
+    };
+    static int results[] = { 0, 0, 0, -1, -1, 0, 0, -1, -1, -1, -1 };
+
+    FILE* fp = tmpfile();
+    assert(fp != NULL);
+
+    for (size_t i = 0; i < sizeof(requests) / sizeof(requests[0]); i++)
+    {
+        char line[64] = "";
+        strcpy(line, requests[i]);
+        assert(answer_request(&session, line, fp) == results[i]);
+    }
+
+    // Check that each request was answered with a single line.
+    char solution[1024] = "";
+    FILE* solution_fp = fopen("tests/solution2.txt", "r");
+    assert(solution_fp != NULL);
+    assert(fscanf(solution_fp, "%*u %1023s", solution) == 1);
+    fclose(solution_fp);
+
+    char expected[2048] = "";
+    snprintf(expected, sizeof(expected),
+             "ok 5 5\n"
+             "ok 8 RRRRDDDD\n"
+             "ok 4 UUUU\n"
+             "error location outside the maze\n"
+             "error expected a start and end location\n"
+             "ok %zu %s\n"
+             "ok\n"
+             "error tests/maze1.txt is not loaded\n"
+             "error failed to read tests/missing.txt\n"
+             "error unknown command jump\n"
+             "error expected a command and a maze file\n",
+             strlen(solution), solution);
+
+    char answers[2048] = "";
+    rewind(fp);
+    assert(fread(answers, sizeof(char), sizeof(answers) - 1, fp) > 0);
+    fclose(fp);
+
+    assert(strcmp(answers, expected) == 0);
+
+    free_solver_session(&session);
+    free_maze_cache(&cache);
+}
+
+static void test_solve_stats()
+{
+    struct maze_t maze;
+    assert(read_maze_file(&maze, "tests/maze1.txt") == 0);
+
+    struct node_list_t list;
+    struct node_list_t unmeasured;
+    assert(make_list(&list, 0) == 0);
+    assert(make_list(&unmeasured, 0) == 0);
+
+    struct solve_stats_t stats;
+    make_solve_stats(&stats);
+    assert(!stats.search.recorded);
+
+    // Test that measuring a search does not change it.
+    solve_maze_measured(&list, maze, &stats.search);
+    solve_maze(&unmeasured, maze);
+    assert(list.length == unmeasured.length);
+
+    for (size_t i = 0; i < list.length; i++)
+    {
+        assert(location_equal(get_node(&list, i)->location, get_node(&unmeasured, i)->location));
+    }
+
+    // Check the work recorded, where every location is expanded at most once
+    // and only pushes which were not merged add to the frontier.
+    assert(stats.search.recorded);
+    assert(stats.search.expansions == list.length);
+    assert(stats.search.expansions <= 25);
+    assert(stats.search.pushes >= stats.search.expansions - 1);
+    assert(stats.search.duplicate_pushes < stats.search.pushes);
+    assert(stats.search.frontier_peak > 0);
+    assert(stats.search.frontier_peak <= stats.search.pushes - stats.search.duplicate_pushes);
+
+    measure_solution(&stats, &list);
+    assert(stats.path_length == 8);
+    assert(stats.list_peak_length == list.length);
+
+    // Test that A* records the same statistics.
+    struct search_stats_t a_star_stats = { .recorded = false };
+    unmeasured.length = 0;
+    solve_maze_a_star_measured(&unmeasured, maze, &a_star_stats);
+    assert(a_star_stats.recorded);
+    assert(a_star_stats.expansions == unmeasured.length);
+
+    resize_list(&unmeasured, 0);
+    resize_list(&list, 0);
+    free_maze(&maze);
+
+    // Test writing the statistics as text and as JSON.
+    stats = (struct solve_stats_t)
+    {
+        .search = {.recorded = true, .expansions = 12, .pushes = 14, .duplicate_pushes = 2, .frontier_peak = 3},
+        .rows = 5, .columns = 5, .path_length = 8, .list_peak_length = 25,
+        .read_time = 1500000000, .solve_time = 250000, .write_time = 1
+    };
+
+    char text[1024] = "";
+    FILE* fp = tmpfile();
+    assert(fp != NULL);
+    assert(write_solve_stats(&stats, STATS_TEXT, fp) == 0);
+    stats.search.recorded = false;
+    assert(write_solve_stats(&stats, STATS_JSON, fp) == 0);
+    rewind(fp);
+    assert(fread(text, sizeof(char), sizeof(text) - 1, fp) > 0);
+    fclose(fp);
+
+    assert(strcmp(text,
+                  "maze size: 5 x 5\n"
+                  "path length: 8\n"
+                  "expansions: 12\n"
+                  "pushes: 14\n"
+                  "duplicate pushes: 2\n"
+                  "frontier peak: 3\n"
+                  "list peak length: 25\n"
+                  "read time: 1.500000 s\n"
+                  "solve time: 0.000250 s\n"
+                  "write time: 0.000000 s\n"
+                  "{\"rows\": 5, \"columns\": 5, \"path_length\": 8, "
+                  "\"expansions\": null, \"pushes\": null, \"duplicate_pushes\": null, \"frontier_peak\": null, "
+                  "\"list_peak_length\": 25, \"read_seconds\": 1.500000000, \"solve_seconds\": 0.000250000, \"write_seconds\": 0.000000001}\n") == 0);
+
+    // Check that the monotonic clock does not go backwards.
+    uint64_t before = monotonic_time();
+    assert(monotonic_time() >= before);
+}
+
+static void check_generated_maze(struct maze_t maze, size_t* passages, size_t* dead_ends)
+{
+    size_t length = maze.size.rows * maze.size.columns;
+
+    *passages = 0;
+    *dead_ends = 0;
+
+    // Check that every passage stays within the maze and leads both ways.
+    for (size_t index = 0; index < length; index++)
+    {
+        struct location_t location = { index / maze.size.columns, index % maze.size.columns };
+        enum action_set_t action_set = get_action_set(maze, location);
+        size_t count = 0;
+
+        for (enum action_t action = EAST; action <= NORTH; action++)
+        {
+            if (!(action_set & (1 << action))) continue;
+
+            struct location_t next = action_result(location, action);
+            assert(check_location(maze.size, next));
+            assert(get_action_set(maze, next) & (1 << reverse_action(action)));
+            count++;
+        }
+
+        *passages += count;
+        if (count == 1) (*dead_ends)++;
+    }
+
+    *passages /= 2;
+
+    // Check that every location can be reached from the start.
+    struct location_set_t reached;
+    assert(make_location_set(&reached, maze.size) == 0);
+
+    struct location_t* stack = (struct location_t*) malloc(length * sizeof(struct location_t));
+    assert(stack != NULL);
+
+    size_t top = 0;
+    size_t count = 1;
+    stack[top++] = maze.start;
+    add_location(&reached, maze.start);
+
+    while (top > 0)
+    {
+        struct location_t location = stack[--top];
+        enum action_set_t action_set = get_action_set(maze, location);
+
+        for (enum action_t action = EAST; action <= NORTH; action++)
+        {
+            if (!(action_set & (1 << action))) continue;
+
+            struct location_t next = action_result(location, action);
+            if (contains_location(&reached, next)) continue;
+
+            add_location(&reached, next);
+            stack[top++] = next;
+            count++;
+        }
+    }
+
+    assert(count == length);
+
+    free(stack);
+    free_location_set(&reached);
+}
+
+static void test_generate_maze()
+{
+    static enum generator_t algorithms[4] =
+    {
+        GENERATOR_BACKTRACKER,
+        GENERATOR_KRUSKAL,
+        GENERATOR_WILSON,
+        GENERATOR_ELLER
+    };
+
+    static struct maze_size_t sizes[5] =
+    {
+        {.rows = 1, .columns = 1},
+        {.rows = 1, .columns = 9},
+        {.rows = 9, .columns = 1},
+        {.rows = 2, .columns = 2},
+        {.rows = 23, .columns = 31}
+    };
+
+    for (size_t i = 0; i < 4; i++)
+    {
+        for (size_t j = 0; j < 5; j++)
+        {
+            struct generator_options_t options = {.algorithm = algorithms[i], .size = sizes[j], .seed = j, .braid = 0};
+            size_t length = sizes[j].rows * sizes[j].columns;
+            size_t passages = 0;
+            size_t dead_ends = 0;
+
+            // Test that the maze is perfect, with one fewer passage than
+            // locations, all connected.
+            struct maze_t maze;
+            assert(generate_maze(&maze, options) == 0);
+            assert(location_equal(maze.start, (struct location_t) {0, 0}));
+            assert(location_equal(maze.end, (struct location_t) {sizes[j].rows - 1, sizes[j].columns - 1}));
+
+            check_generated_maze(maze, &passages, &dead_ends);
+            assert(passages == length - 1);
+
+            // Test that the same options give the same maze.
+            struct maze_t same;
+            assert(generate_maze(&same, options) == 0);
+            assert(memcmp(maze.action_sets, same.action_sets, (length + 1) / 2) == 0);
+            free_maze(&same);
+
+            if (j < 4)
+            {
+                free_maze(&maze);
+                continue;
+            }
+
+            // Test that a different seed gives a different maze.
+            options.seed++;
+            assert(generate_maze(&same, options) == 0);
+            assert(memcmp(maze.action_sets, same.action_sets, (length + 1) / 2) != 0);
+            free_maze(&same);
+
+            // Test that braiding adds loops, removing every dead end when any
+            // wall of a dead end can be opened.
+            size_t perfect_dead_ends = dead_ends;
+            options.braid = 100;
+
+            struct maze_t braided;
+            assert(generate_maze(&braided, options) == 0);
+            check_generated_maze(braided, &passages, &dead_ends);
+            assert(passages > length - 1);
+            assert(dead_ends < perfect_dead_ends);
+            if (algorithms[i] != GENERATOR_ELLER) assert(dead_ends == 0);
+            free_maze(&braided);
+
+            // Test that the maze can be written and read back in the text
+            // format.
+            FILE* fp = fopen("tests/generated.txt", "w");
+            assert(fp != NULL);
+            assert(write_maze_text(maze, fp) == 0);
+            fclose(fp);
+
+            struct maze_t read;
+            assert(read_maze_file(&read, "tests/generated.txt") == 0);
+            assert(read.size.rows == maze.size.rows && read.size.columns == maze.size.columns);
+            assert(location_equal(read.start, maze.start) && location_equal(read.end, maze.end));
+            assert(memcmp(maze.action_sets, read.action_sets, (length + 1) / 2) == 0);
+            free_maze(&read);
+
+            free_maze(&maze);
+        }
+    }
+
+    // Test that streaming a maze gives the same maze as generating it in
+    // memory, with and without braiding.
+    for (unsigned int braid = 0; braid <= 50; braid += 50)
+    {
+        struct generator_options_t options = {.algorithm = GENERATOR_ELLER, .size = {.rows = 17, .columns = 40}, .seed = 7, .braid = braid};
+
+        FILE* fp = fopen("tests/generated.txt", "w");
+        assert(fp != NULL);
+        assert(stream_maze(options, fp) == 0);
+        fclose(fp);
+
+        struct maze_t maze;
+        struct maze_t streamed;
+        assert(generate_maze(&maze, options) == 0);
+        assert(read_maze_file(&streamed, "tests/generated.txt") == 0);
+        assert(memcmp(maze.action_sets, streamed.action_sets, (17 * 40 + 1) / 2) == 0);
+        free_maze(&streamed);
+        free_maze(&maze);
+    }
+
+    remove("tests/generated.txt");
+}
+
+static void test_corridor_graph()
+{
+    // Test a single corridor, which contracts to one edge each way between the
+    // start and the end.
+    struct maze_t line;
+    assert(make_maze(&line, (struct maze_size_t) {.rows = 1, .columns = 5},
+                     (struct location_t) {0, 0}, (struct location_t) {0, 4}) == 0);
+
+    for (size_t column = 0; column < 5; column++)
+    {
+        unsigned int action_set = (column > 0 ? WEST_FLAG : 0) | (column < 4 ? EAST_FLAG : 0);
+        set_action_set(line, (enum action_set_t) action_set, (struct location_t) {0, column});
+    }
+
+    struct corridor_graph_t graph;
+    assert(make_corridor_graph(&graph, line) == 0);
+    assert(graph.junction_count == 2);
+    assert(graph.corridor_count == 2);
+    assert(graph.corridors[0].target == 1 && graph.corridors[0].length == 4 && graph.corridors[0].action == EAST);
+    assert(graph.corridors[1].target == 0 && graph.corridors[1].length == 4 && graph.corridors[1].action == WEST);
+
+    size_t junction = 0;
+    assert(find_junction(&graph, (struct location_t) {0, 4}, &junction) && junction == 1);
+    assert(!find_junction(&graph, (struct location_t) {0, 2}, &junction));
+
+    struct node_list_t path;
+    assert(make_list(&path, 0) == 0);
+    assert(solve_corridor_graph(&path, line, &graph, NULL) == 0);
+    assert(path.length == 5);
+    assert(location_equal(get_node(&path, 2)->location, (struct location_t) {0, 2}));
+
+    free_corridor_graph(&graph);
+    free_maze(&line);
+
+    // Test that the paths found are the same as breadth-first search finds.
+    static char* maze_files[2] =
+    {
+        "tests/maze1.txt",
+        "tests/maze2.txt"
+    };
+
+    static char* solution_files[2] =
+    {
+        "tests/solution1.txt",
+        "tests/solution2.txt"
+    };
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        struct maze_t maze;
+        assert(read_maze_file(&maze, maze_files[i]) == 0);
+
+        path.length = 0;
+        assert(solve_maze_corridors(&path, maze) == 0);
+
+        check_solution(&path, maze, solution_files[i]);
+
+        free_maze(&maze);
+    }
+
+    // Test generated mazes, with and without loops, checking that the graph
+    // is much smaller than the maze and that the paths are as short as any.
+    for (unsigned int braid = 0; braid <= 50; braid += 50)
+    {
+        struct generator_options_t options = {.algorithm = GENERATOR_BACKTRACKER, .size = {.rows = 60, .columns = 80}, .seed = 3, .braid = braid};
+
+        struct maze_t maze;
+        assert(generate_maze(&maze, options) == 0);
+
+        assert(make_corridor_graph(&graph, maze) == 0);
+        assert(graph.junction_count * 4 < 60 * 80);
+
+        struct search_stats_t stats = {.recorded = false};
+        path.length = 0;
+        assert(solve_corridor_graph(&path, maze, &graph, &stats) == 0);
+        assert(stats.recorded && stats.expansions <= graph.junction_count);
+
+        struct node_list_t expected;
+        assert(make_list(&expected, 0) == 0);
+        assert(solve_maze_compact(&expected, maze) == 0);
+        assert(path.length == expected.length);
+
+        // Check that every step of the path is a single available action.
+        struct path_t actions;
+        assert(make_path(&actions, get_node(&path, path.length - 1)) == 0);
+        assert(actions.length == path.length - 1);
+
+        struct location_t location = maze.start;
+        for (size_t step = 0; step < actions.length; step++)
+        {
+            assert(get_action_set(maze, location) & (1 << actions.actions[step]));
+            location = action_result(location, (enum action_t) actions.actions[step]);
+        }
+        assert(location_equal(location, maze.end));
+
+        free_path(&actions);
+        resize_list(&expected, 0);
+        free_corridor_graph(&graph);
+        free_maze(&maze);
+    }
+
+    resize_list(&path, 0);
+}
+
+static void test_fill_dead_ends()
+{
+    // Test mazes whose locations do not fill a whole number of words, with
+    // and without loops.
+    for (unsigned int braid = 0; braid <= 50; braid += 50)
+    {
+        struct generator_options_t options = {.algorithm = GENERATOR_KRUSKAL, .size = {.rows = 31, .columns = 41}, .seed = 11, .braid = braid};
+        size_t length = 31 * 41;
+
+        struct maze_t maze;
+        assert(generate_maze(&maze, options) == 0);
+
+        struct node_list_t expected;
+        assert(make_list(&expected, 0) == 0);
+        assert(solve_maze_compact(&expected, maze) == 0);
+
+        size_t filled = 0;
+        struct maze_t pruned;
+        assert(fill_dead_ends(&pruned, maze, &filled) == 0);
+
+        // Check that no dead ends are left, apart from the start and end, and
+        // that only locations on the path are left open in a perfect maze.
+        size_t open = 0;
+        for (size_t index = 0; index < length; index++)
+        {
+            struct location_t location = { index / 41, index % 41 };
+            unsigned int action_set = (unsigned int) get_action_set(pruned, location);
+            unsigned int original = (unsigned int) get_action_set(maze, location);
+
+            assert((action_set & ~original) == 0);
+            if (action_set != 0) open++;
+
+            if (location_equal(location, maze.start) || location_equal(location, maze.end)) continue;
+            assert(__builtin_popcount(action_set) != 1);
+        }
+
+        assert(open + filled == length);
+        if (braid == 0) assert(open == expected.length);
+        else assert(open > expected.length);
+
+        // Test that the path read off the pruned maze is a shortest path.
+        struct node_list_t path;
+        assert(make_list(&path, 0) == 0);
+        assert(solve_maze_dead_ends(&path, maze) == 0);
+        assert(path.length == expected.length);
+        assert(location_equal(get_node(&path, 0)->location, maze.end));
+        assert(location_equal(get_node(&path, path.length - 1)->location, maze.start));
+
+        struct path_t actions;
+        assert(make_path(&actions, get_node(&path, path.length - 1)) == 0);
+        free_path(&actions);
+
+        resize_list(&path, 0);
+        resize_list(&expected, 0);
+        free_maze(&pruned);
+        free_maze(&maze);
+    }
+
+    // Test the mazes with known solutions.
+    static char* maze_files[2] =
+    {
+        "tests/maze1.txt",
+        "tests/maze2.txt"
+    };
+
+    static char* solution_files[2] =
+    {
+        "tests/solution1.txt",
+        "tests/solution2.txt"
+    };
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        struct maze_t maze;
+        assert(read_maze_file(&maze, maze_files[i]) == 0);
+
+        struct node_list_t path;
+        assert(make_list(&path, 0) == 0);
+        assert(solve_maze_dead_ends(&path, maze) == 0);
+
+        check_solution(&path, maze, solution_files[i]);
+
+        resize_list(&path, 0);
+        free_maze(&maze);
+    }
+}
+
+static void test_cluster_graph()
+{
+    // Test a maze which is not a whole number of clusters, so that the clusters
+    // at the bottom and right edges are smaller.
+    struct generator_options_t options = {.algorithm = GENERATOR_BACKTRACKER, .size = {.rows = 45, .columns = 70}, .seed = 5, .braid = 0};
+
+    struct maze_t maze;
+    assert(generate_maze(&maze, options) == 0);
+
+    struct cluster_graph_t graph;
+    assert(make_cluster_graph(&graph, maze, 16, 3) == 0);
+    assert(graph.cluster_rows == 3 && graph.cluster_columns == 5);
+    assert(graph.entrance_count > 0);
+
+    // Check that every entrance is at the border of its cluster, leading into
+    // another cluster, with an edge back from the entrance it leads to.
+    for (size_t entrance = 0; entrance < graph.entrance_count; entrance++)
+    {
+        struct location_t location = { graph.entrances[entrance] / 70, graph.entrances[entrance] % 70 };
+
+        size_t found = 0;
+        assert(find_entrance(&graph, location, &found) && found == entrance);
+
+        size_t crossings = 0;
+        for (size_t position = graph.offsets[entrance]; position < graph.offsets[entrance + 1]; position++)
+        {
+            struct cluster_edge_t edge = graph.edges[position];
+            struct location_t target = { graph.entrances[edge.target] / 70, graph.entrances[edge.target] % 70 };
+            assert(edge.target != entrance);
+
+            if (target.row / 16 == location.row / 16 && target.column / 16 == location.column / 16) continue;
+
+            assert(edge.cost == 1 && location_manhattan(location, target) == 1);
+            crossings++;
+
+            bool back = false;
+            for (size_t other = graph.offsets[edge.target]; other < graph.offsets[edge.target + 1]; other++)
+            {
+                if (graph.edges[other].target == entrance) back = true;
+            }
+            assert(back);
+        }
+
+        assert(crossings > 0);
+    }
+
+    // Check that a location inside a cluster is not an entrance.
+    size_t found = 0;
+    assert(!find_entrance(&graph, (struct location_t) {8, 8}, &found));
+
+    // Test that the paths found are as short as breadth-first search finds,
+    // with and without loops, and with the start and end in the same cluster.
+    struct node_list_t path;
+    assert(make_list(&path, 0) == 0);
+
+    struct node_list_t expected;
+    assert(make_list(&expected, 0) == 0);
+
+    for (unsigned int braid = 0; braid <= 50; braid += 50)
+    {
+        if (braid > 0)
+        {
+            free_cluster_graph(&graph);
+            free_maze(&maze);
+
+            options.braid = braid;
+            assert(generate_maze(&maze, options) == 0);
+            assert(make_cluster_graph(&graph, maze, 16, 3) == 0);
+        }
+
+        for (size_t i = 0; i < 2; i++)
+        {
+            if (i == 1) maze.end = (struct location_t) {3, 12};
+
+            path.length = 0;
+            expected.length = 0;
+
+            struct search_stats_t stats = {.recorded = false};
+            assert(solve_cluster_graph(&path, maze, &graph, &stats) == 0);
+            assert(stats.recorded && stats.expansions <= graph.entrance_count + 2);
+
+            assert(solve_maze_compact(&expected, maze) == 0);
+            assert(path.length == expected.length);
+            assert(location_equal(get_node(&path, 0)->location, maze.end));
+
+            struct path_t actions;
+            assert(make_path(&actions, get_node(&path, path.length - 1)) == 0);
+
+            struct location_t location = maze.start;
+            for (size_t step = 0; step < actions.length; step++)
+            {
+                assert(get_action_set(maze, location) & (1 << actions.actions[step]));
+                location = action_result(location, (enum action_t) actions.actions[step]);
+            }
+            assert(location_equal(location, maze.end));
+
+            free_path(&actions);
+        }
+
+        maze.end = (struct location_t) {44, 69};
+    }
+
+    // Test a maze with passages that lead one way, where the path must follow
+    // the actions from the end back to the start, as the other searches do.
+    // Each passage on the shortest path is made to lead only that way.
+    expected.length = 0;
+    assert(solve_maze_compact(&expected, maze) == 0);
+
+    for (struct node_t* node = get_node(&expected, expected.length - 1); node->parent != NULL; node = node->parent)
+    {
+        enum action_t action = EAST;
+        assert(action_taken(&action, node->location, node->parent->location) == 0);
+
+        enum action_set_t action_set = get_action_set(maze, node->location);
+        set_action_set(maze, (enum action_set_t) (action_set & ~(1 << action)), node->location);
+    }
+
+    free_cluster_graph(&graph);
+    assert(make_cluster_graph(&graph, maze, 16, 3) == 0);
+
+    path.length = 0;
+    expected.length = 0;
+    assert(solve_maze_compact(&expected, maze) == 0);
+    assert(solve_cluster_graph(&path, maze, &graph, NULL) == 0);
+    assert(path.length == expected.length);
+
+    for (struct node_t* node = get_node(&path, path.length - 1); node->parent != NULL; node = node->parent)
+    {
+        enum action_t action = EAST;
+        assert(action_taken(&action, node->parent->location, node->location) == 0);
+        assert(get_action_set(maze, node->parent->location) & (1 << action));
+    }
+
+    free_cluster_graph(&graph);
+    free_maze(&maze);
+
+    // Test the mazes with known solutions, using a single thread and clusters
+    // smaller than the mazes.
+    static char* maze_files[2] =
+    {
+        "tests/maze1.txt",
+        "tests/maze2.txt"
+    };
+
+    static char* solution_files[2] =
+    {
+        "tests/solution1.txt",
+        "tests/solution2.txt"
+    };
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        assert(read_maze_file(&maze, maze_files[i]) == 0);
+
+        path.length = 0;
+        assert(solve_maze_hierarchical(&path, maze, 4, 1, NULL) == 0);
+
+        check_solution(&path, maze, solution_files[i]);
+
+        free_maze(&maze);
+    }
+
+    resize_list(&expected, 0);
+    resize_list(&path, 0);
+}
+
+static void test_maze_tree()
+{
+    // Test a perfect maze, in which the path through the tree between any two
+    // locations is the only path between them, and then a maze with loops.
+    struct generator_options_t options = {.algorithm = GENERATOR_BACKTRACKER, .size = {.rows = 37, .columns = 53}, .seed = 7, .braid = 0};
+
+    static const struct location_t pairs[5][2] =
+    {
+        { {0, 0}, {36, 52} },
+        { {36, 52}, {0, 0} },
+        { {12, 40}, {30, 3} },
+        { {5, 5}, {5, 5} },
+        { {20, 0}, {21, 0} }
+    };
+
+    struct node_list_t expected;
+    assert(make_list(&expected, 0) == 0);
+
+    for (unsigned int braid = 0; braid <= 50; braid += 50)
+    {
+        options.braid = braid;
+
+        struct maze_t maze;
+        assert(generate_maze(&maze, options) == 0);
+
+        struct maze_tree_t tree;
+        assert(make_maze_tree(&tree, maze, (struct location_t) {18, 26}) == 0);
+        assert(tree.acyclic == (braid == 0));
+
+        for (size_t i = 0; i < 6; i++)
+        {
+            // Test a query from the root as well, which the tree answers even
+            // when the maze has loops.
+            struct location_t start = (i < 5) ? pairs[i][0] : tree.root;
+            struct location_t end = (i < 5) ? pairs[i][1] : pairs[2][1];
+
+            struct maze_t query = maze;
+            query.start = start;
+            query.end = end;
+
+            expected.length = 0;
+            assert(solve_maze_compact(&expected, query) == 0);
+
+            struct path_t path;
+            assert(solve_tree_path(&path, &tree, start, end) == 0);
+            assert(path.length == expected.length - 1);
+
+            size_t length = 0;
+            assert(tree_path_length(&tree, start, end, &length) == 0);
+            assert(length == path.length);
+
+            struct location_t location = start;
+            for (size_t step = 0; step < path.length; step++)
+            {
+                assert(get_action_set(maze, location) & (1 << path.actions[step]));
+                location = action_result(location, (enum action_t) path.actions[step]);
+            }
+            assert(location_equal(location, end));
+
+            free_path(&path);
+        }
+
+        // Check that locations outside the maze are rejected.
+        size_t length = 0;
+        assert(tree_path_length(&tree, (struct location_t) {37, 0}, tree.root, &length) == -1);
+
+        free_maze_tree(&tree);
+        free_maze(&maze);
+    }
+
+    // Check that a location which cannot be reached from the root is rejected.
+    struct maze_t maze;
+    assert(make_maze(&maze, (struct maze_size_t) {1, 3}, (struct location_t) {0, 0}, (struct location_t) {0, 2}) == 0);
+    set_action_set(maze, (enum action_set_t) (1u << EAST), (struct location_t) {0, 0});
+    set_action_set(maze, (enum action_set_t) (1u << WEST), (struct location_t) {0, 1});
+
+    struct maze_tree_t tree;
+    assert(make_maze_tree(&tree, maze, maze.start) == 0);
+
+    struct path_t path;
+    assert(solve_tree_path(&path, &tree, maze.start, maze.end) == -1);
+
+    free_maze_tree(&tree);
+    free_maze(&maze);
+
+    resize_list(&expected, 0);
+}
+
+static void test_incremental_search()
+{
+    struct generator_options_t options = {.algorithm = GENERATOR_BACKTRACKER, .size = {.rows = 41, .columns = 63}, .seed = 9, .braid = 0};
+
+    struct maze_t maze;
+    assert(generate_maze(&maze, options) == 0);
+
+    struct incremental_search_t search;
+    assert(make_incremental_search(&search, maze) == 0);
+
+    struct node_list_t path;
+    assert(make_list(&path, 0) == 0);
+
+    struct node_list_t expected;
+    assert(make_list(&expected, 0) == 0);
+
+    // Test that the first search finds a path as short as breadth-first search
+    // finds.
+    struct search_stats_t stats = {.recorded = false};
+    assert(solve_incremental_search(&path, &search, &stats) == 0);
+    assert(stats.recorded && stats.expansions > 0);
+
+    assert(solve_maze_compact(&expected, maze) == 0);
+    assert(path.length == expected.length);
+    assert(location_equal(get_node(&path, 0)->location, maze.end));
+    size_t first_expansions = stats.expansions;
+
+    // Test opening walls one at a time and in a batch, each time checking that
+    // the path is as short as breadth-first search finds, follows the actions
+    // of the changed maze, and is repaired by expanding fewer locations than
+    // the first search.
+    static const struct location_t walls[4] = { {20, 31}, {3, 50}, {35, 8}, {10, 10} };
+
+    for (size_t i = 0; i < 4; i++)
+    {
+        struct location_t changed[4];
+        size_t count = 0;
+
+        for (size_t j = i; j < ((i < 3) ? i + 1 : 4); j++)
+        {
+            // Open the wall to the east of the location, or below it if the
+            // wall to the east is already open.
+            struct location_t location = walls[j];
+            enum action_t action = (get_action_set(maze, location) & (1 << EAST)) ? SOUTH : EAST;
+            struct location_t next = action_result(location, action);
+
+            set_action_set(maze, (enum action_set_t) ((unsigned int) get_action_set(maze, location) | (1u << action)), location);
+            set_action_set(maze, (enum action_set_t) ((unsigned int) get_action_set(maze, next) | (1u << reverse_action(action))), next);
+
+            changed[count++] = location;
+            changed[count++] = next;
+        }
+
+        assert(update_incremental_search(&search, changed, count) == 0);
+
+        path.length = 0;
+        expected.length = 0;
+
+        stats = (struct search_stats_t) {.recorded = false};
+        assert(solve_incremental_search(&path, &search, &stats) == 0);
+        assert(stats.recorded && stats.expansions < first_expansions);
+
+        assert(solve_maze_compact(&expected, maze) == 0);
+        assert(path.length == expected.length);
+
+        struct path_t actions;
+        assert(make_path(&actions, get_node(&path, path.length - 1)) == 0);
+
+        struct location_t location = maze.start;
+        for (size_t step = 0; step < actions.length; step++)
+        {
+            assert(get_action_set(maze, location) & (1 << actions.actions[step]));
+            location = action_result(location, (enum action_t) actions.actions[step]);
+        }
+        assert(location_equal(location, maze.end));
+
+        free_path(&actions);
+    }
+
+    // Test closing every way out of the end, so that it cannot be reached, then
+    // opening them again.
+    enum action_set_t end_set = get_action_set(maze, maze.end);
+    struct location_t changed[5] = { maze.end };
+    size_t count = 1;
+
+    for (enum action_t action = EAST; action <= NORTH; action++)
+    {
+        if (!(end_set & (1 << action))) continue;
+
+        struct location_t next = action_result(maze.end, action);
+        set_action_set(maze, (enum action_set_t) ((unsigned int) get_action_set(maze, next) & ~(1u << reverse_action(action))), next);
+        changed[count++] = next;
+    }
+    set_action_set(maze, (enum action_set_t) 0, maze.end);
+
+    assert(update_incremental_search(&search, changed, count) == 0);
+
+    path.length = 0;
+    assert(solve_incremental_search(&path, &search, NULL) == -1);
+
+    set_action_set(maze, end_set, maze.end);
+    for (enum action_t action = EAST; action <= NORTH; action++)
+    {
+        if (!(end_set & (1 << action))) continue;
+
+        struct location_t next = action_result(maze.end, action);
+        set_action_set(maze, (enum action_set_t) ((unsigned int) get_action_set(maze, next) | (1u << reverse_action(action))), next);
+    }
+
+    assert(update_incremental_search(&search, changed, count) == 0);
+
+    path.length = 0;
+    assert(solve_incremental_search(&path, &search, NULL) == 0);
+    assert(path.length == expected.length);
+
+    free_incremental_search(&search);
+    free_maze(&maze);
+
+    // Test the mazes with known solutions.
+    static char* maze_files[2] =
+    {
+        "tests/maze1.txt",
+        "tests/maze2.txt"
+    };
+
+    static char* solution_files[2] =
+    {
+        "tests/solution1.txt",
+        "tests/solution2.txt"
+    };
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        assert(read_maze_file(&maze, maze_files[i]) == 0);
+
+        path.length = 0;
+        assert(solve_maze_incremental(&path, maze, NULL) == 0);
+
+        check_solution(&path, maze, solution_files[i]);
+
+        free_maze(&maze);
+    }
+
+    resize_list(&expected, 0);
+    resize_list(&path, 0);
+}
+
+static void test_search_engines()
+{
+    // Test find_search_engine with known and unknown names.
+    const struct search_engine_t* engine = find_search_engine("compact");
+    assert(engine != NULL && strcmp(engine->name, "compact") == 0);
+    assert(find_search_engine("unknown") == NULL);
+    assert(find_search_engine("greedy") == &search_engines[0]);
+
+    // Test that every search solves a maze with a known solution, and that the
+    // searches which can record their work do so.
+    struct maze_t maze;
+    assert(read_maze_file(&maze, "tests/maze1.txt") == 0);
+
+    struct node_list_t path;
+    assert(make_list(&path, 0) == 0);
+
+    set_search_threads(2);
+
+    for (size_t index = 0; index < search_engine_count; index++)
+    {
+        path.length = 0;
+        search_engines[index].solve(&path, maze);
+
+        assert(path.length > 0);
+        assert(location_equal(get_node(&path, 0)->location, maze.end));
+        assert(location_equal(get_node(&path, path.length - 1)->location, maze.start));
+
+        if (search_engines[index].measure == NULL) continue;
+
+        size_t length = path.length;
+
+        path.length = 0;
+        struct search_stats_t stats = {.recorded = false};
+        search_engines[index].measure(&path, maze, &stats);
+
+        assert(stats.recorded && stats.expansions > 0);
+        assert(stats.frontier_peak > 0 && stats.frontier_peak <= stats.pushes);
+        assert(stats.duplicate_pushes <= stats.pushes);
+        assert(path.length == length);
+        assert(location_equal(get_node(&path, path.length - 1)->location, maze.start));
+    }
+
+    set_search_threads(1);
+
+    resize_list(&path, 0);
+    free_maze(&maze);
+}
+
 int main()
 {
     test_location_distance();
+    test_location_manhattan();
     test_location_equal();
     test_check_location();
     test_action_result();
     test_action_taken();
+    test_reverse_action();
+    test_action_sets();
     test_node_list();
+    test_node_queue();
+    test_location_set();
+    test_direction_map();
+    test_path();
+    test_read_maze_file();
+    test_write_maze_binary();
+    test_write_maze();
+    test_maze_image();
+    test_solve_maze_a_star();
+    test_solve_maze_bidirectional();
+    test_solve_maze_parallel();
+    test_bitboard();
+    test_solve_maze_compact();
+    test_batch();
+    test_bounded_queue();
+    test_pipeline();
+    test_maze_cache();
+    test_server();
+    test_solve_stats();
+    test_generate_maze();
+    test_corridor_graph();
+    test_fill_dead_ends();
+    test_cluster_graph();
+    test_maze_tree();
+    test_incremental_search();
+    test_search_engines();
     test_solve_maze();
     return 0;
 }